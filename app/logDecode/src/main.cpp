@@ -0,0 +1,129 @@
+#include <logger/BinaryLogDecoder.hpp>
+#include <logger/Lz4Decoder.hpp>
+
+#include <fmt/format.h>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// Bytes read from the input per `fread()`.
+constexpr std::size_t ChunkSize = 64 * 1024;
+
+constexpr std::string_view Usage =
+    "usage: logDecode [--json | --decompress] [FILE]\n"
+    "Decode a binary log written with OutputFormat::Binary to text (or one\n"
+    "JSON object per line with --json), decompressing it first if it was\n"
+    "written with Compression::Lz4. With --decompress, only decompress a\n"
+    "Compression::Lz4 log of any format. Reads standard input if FILE is\n"
+    "omitted or '-'.\n";
+
+/// Decode all of `input` to `output` with `decoder`, a
+/// `sample::logger::BinaryLogDecoder` or `sample::logger::Lz4Decoder`.
+///
+/// ## Returns
+/// `EXIT_SUCCESS`, or `EXIT_FAILURE` if the input cannot be read or ends
+/// inside a record.
+///
+/// ## Throws
+/// `std::runtime_error` if the input is not what `decoder` reads or is
+/// corrupt.
+template <typename Decoder>
+auto decodeStream(std::FILE *input, std::FILE *output, Decoder &decoder)
+    -> int {
+  std::vector<std::byte> pending;
+  fmt::memory_buffer text;
+  for (;;) {
+    const std::size_t kept = pending.size();
+    pending.resize(kept + ChunkSize);
+    const std::size_t read =
+        std::fread(pending.data() + kept, 1, ChunkSize, input);
+    pending.resize(kept + read);
+    const std::size_t used = decoder.decode(pending, text);
+    pending.erase(pending.begin(),
+                  pending.begin() + static_cast<std::ptrdiff_t>(used));
+    std::fwrite(text.data(), 1, text.size(), output);
+    text.clear();
+    if (read == 0) {
+      break;
+    }
+  }
+  if (std::ferror(input) != 0) {
+    fmt::print(stderr, "logDecode: read error\n");
+    return EXIT_FAILURE;
+  }
+  std::size_t unfinished = pending.size();
+  if constexpr (std::same_as<Decoder, sample::logger::BinaryLogDecoder>) {
+    unfinished += decoder.buffered();
+  }
+  if (unfinished != 0) {
+    fmt::print(stderr, "logDecode: input ends inside a record ({} bytes)\n",
+               unfinished);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+/// Application entry point (composition root).
+///
+/// Parses the command line and decodes the selected input to stdout.
+///
+/// ## Returns
+/// `EXIT_SUCCESS` on success, `EXIT_FAILURE` on a usage error, an unreadable
+/// or corrupt input, or one that ends inside a record.
+auto main(int argc, char **argv) -> int {
+  auto format = sample::logger::DecodeFormat::Text;
+  bool decompressOnly = false;
+  std::string_view path = "-";
+  const std::span args{argv + 1, static_cast<std::size_t>(argc - 1)};
+  for (const std::string_view arg : args) {
+    if (arg == "--json") {
+      format = sample::logger::DecodeFormat::Json;
+    } else if (arg == "--decompress") {
+      decompressOnly = true;
+    } else if (arg == "--help" || arg == "-h") {
+      fmt::print("{}", Usage);
+      return EXIT_SUCCESS;
+    } else if (arg.starts_with("--") || path != "-") {
+      fmt::print(stderr, "{}", Usage);
+      return EXIT_FAILURE;
+    } else {
+      path = arg;
+    }
+  }
+
+  std::FILE *input = stdin;
+  if (path != "-") {
+    input = std::fopen(std::string{path}.c_str(), "rb");
+    if (input == nullptr) {
+      fmt::print(stderr, "logDecode: cannot open '{}'\n", path);
+      return EXIT_FAILURE;
+    }
+  }
+  int status = EXIT_FAILURE;
+  try {
+    if (decompressOnly) {
+      sample::logger::Lz4Decoder decoder;
+      status = decodeStream(input, stdout, decoder);
+    } else {
+      sample::logger::BinaryLogDecoder decoder{format};
+      status = decodeStream(input, stdout, decoder);
+    }
+  } catch (const std::exception &error) {
+    fmt::print(stderr, "logDecode: {}\n", error.what());
+  }
+  if (input != stdin) {
+    std::fclose(input);
+  }
+  return status;
+}
@@ -1,22 +1,36 @@
 #include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
 #include <logger/LoggerFactory.hpp>
+#include <logger/LoggerRegistry.hpp>
 
 #include <cstdlib>
+#include <stdexcept>
 
 /// Application entry point (composition root).
 ///
-/// Wires dependencies and delegates to application logic.
+/// Wires dependencies and delegates to application logic. Each component
+/// logs through a named logger; `LOGGER_LEVELS` (e.g. `"warning,app=debug"`)
+/// sets their levels.
 ///
 /// ## Returns
 /// `EXIT_SUCCESS` on success.
 auto main() -> int {
   // Composition root: Create dependencies
-  auto logger = sample::logger::createDefaultLogger();
+  sample::logger::LoggerRegistry loggers{
+      sample::logger::createDefaultLogger()};
+  sample::logger::ILogger &logger = loggers.get("app");
+  if (const char *levels = std::getenv("LOGGER_LEVELS")) {
+    try {
+      loggers.setLevels(levels);
+    } catch (const std::invalid_argument &error) {
+      logger.log(sample::logger::Level::Warning, error.what());
+    }
+  }
 
   // Application logic
-  logger->log("Application started");
-  logger->log("Hello from cpp-app-template!");
-  logger->log("Application finished");
+  logger.log("Application started");
+  logger.log("Hello from cpp-app-template!");
+  logger.log("Application finished");
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,37 @@
+#include "AllocationCounter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+/// Allocations made on this thread.
+thread_local std::uint64_t allocationCount = 0;
+
+} // namespace
+
+// Replacement global allocation functions, so benchmarks can count
+// allocations.
+// NOLINTBEGIN(cppcoreguidelines-no-malloc,misc-new-delete-overloads)
+auto operator new(std::size_t size) -> void * {
+  ++allocationCount;
+  if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t /*size*/) noexcept {
+  std::free(memory);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc,misc-new-delete-overloads)
+
+namespace sample::logger::bench {
+
+auto threadAllocations() -> std::uint64_t { return allocationCount; }
+
+} // namespace sample::logger::bench
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sample::logger::bench {
+
+/// Heap allocations made so far by the calling thread.
+///
+/// Counts every call to the replaced global `operator new` on this thread,
+/// so the difference across a region is the allocations it performed.
+[[nodiscard]] auto threadAllocations() -> std::uint64_t;
+
+} // namespace sample::logger::bench
@@ -0,0 +1,492 @@
+/// Benchmarks for every `ILogger` implementation.
+///
+/// For each logger and each entry point (`log()`, `logf()` and structured
+/// `log()`) this measures
+/// caller-side throughput with 1..N producer threads, heap allocations per
+/// call on the calling thread, and per-call latency percentiles. The console
+/// logger is also measured through `BasicLogger`, without virtual dispatch.
+/// Startup cost is measured as the time to create and destroy each logger,
+/// and the time to run `sampleApp` as a fresh process. The JSON string
+/// escaping behind the JSON and logfmt layouts is measured on its own.
+
+#include "AllocationCounter.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/BasicLogger.hpp>
+#include <logger/ConsoleSink.hpp>
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/Fields.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+#include <logger/MappedFileLoggerConfig.hpp>
+#include <logger/UringLoggerConfig.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <fmt/format.h>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sample::logger::bench {
+
+namespace {
+
+/// `ILogger` implementations under measurement.
+enum class LoggerKind {
+  Console,
+  Async,
+  SpinningAsync,
+  AdaptiveAsync,
+  CompressedAsync,
+  TimestampedAsync,
+  BinaryAsync,
+  PerThreadAsync,
+  FanOutAsync,
+  MappedFile,
+  UringFile
+};
+
+/// Logger entry points under measurement.
+enum class CallKind { Log, LogF, Structured };
+
+constexpr std::array AllLoggers{
+    LoggerKind::Console,          LoggerKind::Async,
+    LoggerKind::SpinningAsync,    LoggerKind::AdaptiveAsync,
+    LoggerKind::CompressedAsync,  LoggerKind::TimestampedAsync,
+    LoggerKind::BinaryAsync,      LoggerKind::PerThreadAsync,
+    LoggerKind::FanOutAsync,      LoggerKind::MappedFile,
+    LoggerKind::UringFile};
+constexpr std::array AllCalls{CallKind::Log, CallKind::LogF,
+                              CallKind::Structured};
+
+/// Per-thread iterations for the loggers that write real files.
+///
+/// An unbounded run could fill the disk.
+constexpr benchmark::IterationCount MappedFileIterations = 500'000;
+
+/// Creations measured for the loggers that write real files, each of which
+/// creates and removes them.
+constexpr benchmark::IterationCount MappedFileCreations = 200;
+
+/// The `sampleApp` executable, started by the process-start benchmark.
+constexpr const char *SampleAppPath = SAMPLE_APP_PATH;
+
+/// Backend threads of the per-thread async logger.
+constexpr std::size_t PerThreadBackends = 2;
+
+/// Latency samples kept per run; later calls are timed but not recorded.
+constexpr std::size_t MaxLatencySamples = 1 << 20;
+
+constexpr std::string_view Message =
+    "Processing request #12345 from 192.168.0.1 in 840us";
+
+/// Length of the lines the escaping benchmarks escape.
+constexpr std::size_t EscapedLineBytes = 4096;
+
+[[nodiscard]] auto toString(LoggerKind kind) -> std::string_view {
+  switch (kind) {
+  case LoggerKind::Console:
+    return "Console";
+  case LoggerKind::Async:
+    return "Async";
+  case LoggerKind::SpinningAsync:
+    return "SpinningAsync";
+  case LoggerKind::AdaptiveAsync:
+    return "AdaptiveAsync";
+  case LoggerKind::CompressedAsync:
+    return "CompressedAsync";
+  case LoggerKind::TimestampedAsync:
+    return "TimestampedAsync";
+  case LoggerKind::BinaryAsync:
+    return "BinaryAsync";
+  case LoggerKind::PerThreadAsync:
+    return "PerThreadAsync";
+  case LoggerKind::FanOutAsync:
+    return "FanOutAsync";
+  case LoggerKind::MappedFile:
+    return "MappedFile";
+  case LoggerKind::UringFile:
+    return "UringFile";
+  }
+  return "Unknown";
+}
+
+/// Whether `kind` writes real files, so its runs must be bounded.
+[[nodiscard]] auto writesFiles(LoggerKind kind) -> bool {
+  return kind == LoggerKind::MappedFile || kind == LoggerKind::UringFile;
+}
+
+[[nodiscard]] auto toString(CallKind kind) -> std::string_view {
+  switch (kind) {
+  case CallKind::Log:
+    return "log";
+  case CallKind::LogF:
+    return "logf";
+  case CallKind::Structured:
+    return "structured";
+  }
+  return "unknown";
+}
+
+/// Points file descriptor 1 at `/dev/null` while it lives.
+///
+/// The console logger writes straight to the descriptor, so redirecting
+/// `std::cout` would not silence it; the benchmark report is flushed first
+/// and written once the descriptor is restored.
+class DiscardedStdout {
+public:
+  DiscardedStdout() {
+    std::cout.flush();
+    const int null = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    saved_ = ::dup(STDOUT_FILENO);
+    ::dup2(null, STDOUT_FILENO);
+    ::close(null);
+  }
+
+  ~DiscardedStdout() {
+    ::dup2(saved_, STDOUT_FILENO);
+    ::close(saved_);
+  }
+
+  DiscardedStdout(const DiscardedStdout &) = delete;
+  auto operator=(const DiscardedStdout &) -> DiscardedStdout & = delete;
+  DiscardedStdout(DiscardedStdout &&) = delete;
+  auto operator=(DiscardedStdout &&) -> DiscardedStdout & = delete;
+
+private:
+  int saved_;
+};
+
+/// A logger under measurement and the plumbing its output needs.
+///
+/// The console logger's stdout is pointed at `/dev/null`, the
+/// async and fan-out loggers write to `/dev/null`, and the mapped-file and
+/// io_uring loggers write into a scratch directory that is removed
+/// afterwards. None of them
+/// touches the benchmark report on stdout.
+class BenchLogger {
+public:
+  explicit BenchLogger(LoggerKind kind) {
+    switch (kind) {
+    case LoggerKind::Console:
+      discardedStdout_.emplace();
+      logger_ = createDefaultLogger();
+      break;
+    case LoggerKind::Async:
+      logger_ = createAsyncLogger(
+          {.target = LogTarget::File, .filePath = "/dev/null"});
+      break;
+    case LoggerKind::SpinningAsync:
+      logger_ = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = "/dev/null",
+                                   .waitStrategy = WaitStrategy::Spin});
+      break;
+    case LoggerKind::AdaptiveAsync:
+      logger_ = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = "/dev/null",
+                                   .waitStrategy = WaitStrategy::Adaptive});
+      break;
+    case LoggerKind::CompressedAsync:
+      logger_ = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = "/dev/null",
+                                   .compression = Compression::Lz4});
+      break;
+    case LoggerKind::TimestampedAsync:
+      logger_ = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = "/dev/null",
+                                   .timestamps = true});
+      break;
+    case LoggerKind::BinaryAsync:
+      logger_ = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = "/dev/null",
+                                   .timestamps = true,
+                                   .outputFormat = OutputFormat::Binary});
+      break;
+    case LoggerKind::PerThreadAsync:
+      logger_ = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = "/dev/null",
+                                   .queueMode = QueueMode::PerThread,
+                                   .backendThreads = PerThreadBackends});
+      break;
+    case LoggerKind::FanOutAsync:
+      logger_ = createFanOutLogger(
+          {.targets = {{.target = LogTarget::File, .filePath = "/dev/null"},
+                       {.target = LogTarget::File,
+                        .filePath = "/dev/null",
+                        .minLevel = Level::Error,
+                        .ownThread = true}}});
+      break;
+    case LoggerKind::MappedFile:
+      directory_ = std::filesystem::temp_directory_path() /
+                   ("loggerBench-" + std::to_string(::getpid()));
+      logger_ = createMappedFileLogger({.directory = directory_});
+      break;
+    case LoggerKind::UringFile:
+      directory_ = std::filesystem::temp_directory_path() /
+                   ("loggerBench-" + std::to_string(::getpid()));
+      std::filesystem::create_directories(directory_);
+      logger_ = createUringFileLogger({.filePath = directory_ / "uring.log"});
+      break;
+    }
+  }
+
+  ~BenchLogger() {
+    logger_.reset();
+    discardedStdout_.reset();
+    if (!directory_.empty()) {
+      std::filesystem::remove_all(directory_);
+    }
+  }
+
+  BenchLogger(const BenchLogger &) = delete;
+  auto operator=(const BenchLogger &) -> BenchLogger & = delete;
+  BenchLogger(BenchLogger &&) = delete;
+  auto operator=(BenchLogger &&) -> BenchLogger & = delete;
+
+  [[nodiscard]] auto logger() -> ILogger & { return *logger_; }
+
+private:
+  std::unique_ptr<ILogger> logger_;
+  std::optional<DiscardedStdout> discardedStdout_;
+  std::filesystem::path directory_;
+};
+
+/// Logger shared by the threads of a multi-threaded run.
+///
+/// Created and destroyed by thread 0 outside the timed loop; Google
+/// Benchmark's start and stop barriers order that against the other threads.
+std::unique_ptr<BenchLogger> sharedLogger;
+
+/// Make one call of kind `call` to `logger`.
+template <Logger L>
+void logOnce(L &logger, CallKind call, std::uint64_t sequence) {
+  switch (call) {
+  case CallKind::Log:
+    logger.log(Message);
+    break;
+  case CallKind::LogF:
+    logger.template logf<"Processing request #{} from {} in {}us">(
+        sequence, std::string_view{"192.168.0.1"}, 840);
+    break;
+  case CallKind::Structured:
+    logger.log("Processing request", field("request", sequence),
+               field("from", std::string_view{"192.168.0.1"}),
+               field("micros", 840));
+    break;
+  }
+}
+
+/// Caller-side throughput and allocations per call.
+void benchThroughput(benchmark::State &state, LoggerKind kind, CallKind call) {
+  if (state.thread_index() == 0) {
+    sharedLogger = std::make_unique<BenchLogger>(kind);
+  }
+  std::uint64_t sequence = 0;
+  std::uint64_t allocations = 0;
+  for (auto _ : state) {
+    const std::uint64_t before = threadAllocations();
+    logOnce(sharedLogger->logger(), call, sequence++);
+    allocations += threadAllocations() - before;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["allocs/call"] = benchmark::Counter(
+      static_cast<double>(allocations) / static_cast<double>(sequence),
+      benchmark::Counter::kAvgThreads);
+  if (state.thread_index() == 0) {
+    const LoggerStats stats = sharedLogger->logger().stats();
+    state.counters["dropped"] = static_cast<double>(stats.dropped);
+    state.counters["backend_cpu_ms"] =
+        std::chrono::duration<double, std::milli>{stats.backendCpuTime}
+            .count();
+    sharedLogger.reset();
+  }
+}
+
+/// Single-threaded throughput of `BasicLogger<ConsoleSink>`.
+///
+/// The statically typed counterpart of the `Console` throughput benchmark:
+/// the difference is the cost of virtual dispatch and lost inlining.
+void benchStaticConsole(benchmark::State &state, CallKind call) {
+  const DiscardedStdout discarded;
+  BasicLogger<ConsoleSink> logger;
+  std::uint64_t sequence = 0;
+  for (auto _ : state) {
+    logOnce(logger, call, sequence++);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Time to create and destroy a logger that logs nothing.
+///
+/// The asynchronous loggers start their threads with the first record, so
+/// this is mostly opening the output.
+void benchCreate(benchmark::State &state, LoggerKind kind) {
+  for (auto _ : state) {
+    const BenchLogger bench{kind};
+    benchmark::DoNotOptimize(&bench);
+  }
+}
+
+/// Time to run `sampleApp`, which logs three lines to the console logger, as
+/// a fresh process: loading, static initialisation, logging and exit.
+void benchProcessStart(benchmark::State &state) {
+  // posix_spawn() does not write through its arguments.
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  const std::array<char *, 2> arguments{const_cast<char *>(SampleAppPath),
+                                        nullptr};
+  ::posix_spawn_file_actions_t actions;
+  ::posix_spawn_file_actions_init(&actions);
+  ::posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null",
+                                     O_WRONLY, 0);
+  for (auto _ : state) {
+    ::pid_t child = 0;
+    if (::posix_spawn(&child, SampleAppPath, &actions, nullptr,
+                      arguments.data(), environ) != 0) {
+      state.SkipWithError("cannot spawn sampleApp");
+      break;
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+  }
+  ::posix_spawn_file_actions_destroy(&actions);
+}
+
+/// A 4 KiB line: plain ASCII, or with a quote, a newline and a two-byte
+/// UTF-8 character in every 64 bytes.
+[[nodiscard]] auto escapeInput(bool mixed) -> std::string {
+  std::string text;
+  while (text.size() < EscapedLineBytes) {
+    text += mixed ? "user \"admin\" said:\n caf\xC3\xA9 " : "user admin said ";
+    text += Message;
+  }
+  text.resize(EscapedLineBytes);
+  return text;
+}
+
+/// Throughput of `detail::appendJsonString()` on a 4 KiB line.
+void benchEscape(benchmark::State &state, bool mixed) {
+  const std::string text = escapeInput(mixed);
+  fmt::memory_buffer out;
+  for (auto _ : state) {
+    out.clear();
+    detail::appendJsonString(text, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+
+/// Per-call latency percentiles on a single producer thread.
+void benchLatency(benchmark::State &state, LoggerKind kind, CallKind call) {
+  using Clock = std::chrono::steady_clock;
+  BenchLogger bench{kind};
+  std::vector<std::int64_t> samples;
+  samples.reserve(MaxLatencySamples);
+  std::uint64_t sequence = 0;
+  for (auto _ : state) {
+    const auto start = Clock::now();
+    logOnce(bench.logger(), call, sequence++);
+    const auto elapsed = Clock::now() - start;
+    if (samples.size() < MaxLatencySamples) {
+      samples.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+              .count());
+    }
+  }
+  std::ranges::sort(samples);
+  const auto percentile = [&samples](double fraction) {
+    if (samples.empty()) {
+      return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(
+        fraction * static_cast<double>(samples.size() - 1));
+    return static_cast<double>(samples[index]);
+  };
+  state.counters["p50_ns"] = percentile(0.50);
+  state.counters["p90_ns"] = percentile(0.90);
+  state.counters["p99_ns"] = percentile(0.99);
+  state.counters["p999_ns"] = percentile(0.999);
+  state.counters["max_ns"] = percentile(1.0);
+}
+
+/// Register every benchmark for every logger and entry point.
+void registerBenchmarks() {
+  const int maxThreads =
+      static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+  for (const LoggerKind kind : AllLoggers) {
+    for (const CallKind call : AllCalls) {
+      const std::string suffix =
+          std::string{toString(call)} + "/" + std::string{toString(kind)};
+      auto *throughput = benchmark::RegisterBenchmark(
+          ("Throughput/" + suffix).c_str(), benchThroughput, kind, call);
+      throughput->ThreadRange(1, maxThreads)->UseRealTime();
+      auto *latency = benchmark::RegisterBenchmark(
+          ("Latency/" + suffix).c_str(), benchLatency, kind, call);
+      if (writesFiles(kind)) {
+        throughput->Iterations(MappedFileIterations);
+        latency->Iterations(MappedFileIterations);
+      }
+    }
+  }
+  for (const CallKind call : AllCalls) {
+    benchmark::RegisterBenchmark(
+        ("Throughput/" + std::string{toString(call)} + "/StaticConsole")
+            .c_str(),
+        benchStaticConsole, call);
+  }
+  for (const LoggerKind kind : AllLoggers) {
+    auto *create = benchmark::RegisterBenchmark(
+        ("Startup/Create/" + std::string{toString(kind)}).c_str(),
+        benchCreate, kind);
+    if (writesFiles(kind)) {
+      create->Iterations(MappedFileCreations);
+    }
+  }
+  benchmark::RegisterBenchmark("Startup/Process/sampleApp",
+                               benchProcessStart)
+      ->UseRealTime();
+  benchmark::RegisterBenchmark("Escape/Json/Plain", benchEscape, false);
+  benchmark::RegisterBenchmark("Escape/Json/Mixed", benchEscape, true);
+}
+
+} // namespace
+
+} // namespace sample::logger::bench
+
+/// Benchmark entry point.
+///
+/// Registers a benchmark per logger, entry point and measurement, then runs
+/// those selected by the usual Google Benchmark command-line flags.
+///
+/// ## Returns
+/// `EXIT_SUCCESS`, or `EXIT_FAILURE` on an unrecognised argument.
+auto main(int argc, char **argv) -> int {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return EXIT_FAILURE;
+  }
+  sample::logger::bench::registerBenchmarks();
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <logger/LogTap.hpp>
+#include <logger/RateLimit.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace sample::logger {
+
+/// What a producer does when the asynchronous logger's ring is full.
+enum class OverflowPolicy {
+  /// Wait for the consumer to free a slot. Nothing is lost.
+  Block,
+  /// Discard the message being logged.
+  DropNewest,
+  /// Discard the oldest queued message to make room for the new one.
+  DropOldest,
+  /// Keep one in `AsyncLoggerConfig::sampleRate` overflowing messages (each
+  /// kept message displaces the oldest queued one) and discard the rest.
+  Sample,
+};
+
+/// Where the asynchronous logger writes its output.
+enum class LogTarget {
+  /// Standard output (file descriptor 1).
+  Stdout,
+  /// Standard error (file descriptor 2).
+  Stderr,
+  /// The file named by `AsyncLoggerConfig::filePath`, opened for appending
+  /// and created if it does not exist.
+  File,
+};
+
+/// How the asynchronous logger encodes its output.
+enum class OutputFormat {
+  /// One formatted line per message.
+  Text,
+  /// The compact binary format read by `BinaryLogDecoder` and the
+  /// `logDecode` tool. Format strings are written once; records carry the
+  /// encoded arguments, so the backend does no text formatting.
+  Binary,
+};
+
+/// How the asynchronous logger lays out each line of `OutputFormat::Text`.
+enum class LineFormat {
+  /// The message alone, followed by the fields of a structured message as
+  /// ` key=value` pairs.
+  Plain,
+  /// A logfmt line: `level=INFO msg="..." key=value ...`, with `time=...`
+  /// first when timestamps are on.
+  Logfmt,
+  /// A JSON object per line: `{"level":"INFO","message":"...",...}`, with
+  /// each field of a structured message as a member and `"time"` first when
+  /// timestamps are on.
+  Json,
+};
+
+/// How producer threads hand records to the asynchronous logger's backend.
+enum class QueueMode {
+  /// One ring shared by every producer and drained by a single backend
+  /// thread. Cheapest for a handful of producers.
+  Shared,
+  /// One single-producer ring per producer thread, created on the thread's
+  /// first message and drained by `AsyncLoggerConfig::backendThreads`
+  /// backend threads. Producers never touch a shared cache line, so
+  /// throughput scales with the number of producer threads.
+  PerThread,
+};
+
+/// How the asynchronous logger's backend threads wait for records.
+///
+/// The choice trades the CPU an idle backend burns against how soon it
+/// notices a record; `LoggerStats::backendCpuTime` shows what it costs.
+enum class WaitStrategy {
+  /// Poll briefly, then sleep on a futex until a producer wakes it. An idle
+  /// backend costs no CPU, but the first record after a quiet spell costs its
+  /// producer a wake-up system call and waits for the backend to be
+  /// scheduled.
+  Park,
+  /// Poll continuously, never sleeping, so a record is picked up within
+  /// nanoseconds and producers never make a system call. Uses a whole core
+  /// per backend whatever the traffic; for latency-critical deployments with
+  /// cores to spare.
+  Spin,
+  /// Poll briefly, then yield the CPU between polls, never sleeping. Costs
+  /// less than `Spin` when other threads want the core, and still spares
+  /// producers the wake-up.
+  SpinYield,
+  /// `Park`, with the polling and the batches sized by the measured load:
+  /// a backend polls longer before sleeping while polling keeps finding
+  /// records and shorter each time it has to sleep, and writes batches
+  /// smaller than `AsyncLoggerConfig::maxBatchBytes` while its queues are
+  /// shallow, so a record is not held back while many behind it are
+  /// formatted. For dense-packed deployments with bursty traffic.
+  Adaptive,
+};
+
+/// Compression applied by the backend to the output before writing it.
+enum class Compression {
+  /// Write the records as they are formatted.
+  None,
+  /// Write the standard LZ4 frame format (`.lz4`), one frame per logger and
+  /// one independent block per batch, so `lz4 -d` restores the output and a
+  /// file cut short by a crash still decodes up to its last batch. Repetitive
+  /// log text typically shrinks several-fold for about the cost of formatting
+  /// it again; `Lz4Decoder` decompresses a stream, which `BinaryLogDecoder`
+  /// and `logDecode` do themselves.
+  Lz4,
+};
+
+/// Construction parameters for the asynchronous logger.
+///
+/// Passed by value to `createAsyncLogger()`; every field has a usable default.
+struct AsyncLoggerConfig {
+  /// Number of record slots in the ring buffer, or in each producer thread's
+  /// ring with `QueueMode::PerThread`.
+  ///
+  /// Rounded up to the next power of two. Must be at least 2.
+  std::size_t capacity = 8192;
+
+  /// Behaviour when a message arrives and the ring is full.
+  ///
+  /// Every policy other than `Block` never waits on the consumer; discarded
+  /// messages are counted by `ILogger::droppedMessages()`.
+  OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+
+  /// Sampling interval for `OverflowPolicy::Sample`. Must be at least 1.
+  std::size_t sampleRate = 16;
+
+  /// Output destination.
+  LogTarget target = LogTarget::Stdout;
+
+  /// Log file for `LogTarget::File`; ignored for the other targets.
+  std::filesystem::path filePath{};
+
+  /// Bytes of formatted output gathered into one `write(2)`.
+  ///
+  /// The consumer writes a batch as soon as it reaches this size, even if
+  /// more records are ready. Must be at least 1.
+  std::size_t maxBatchBytes = 64 * 1024;
+
+  /// Longest a written record may wait in a partial batch for more to arrive.
+  ///
+  /// Zero writes a batch as soon as the queue is empty. A longer interval
+  /// trades output latency for fewer, larger writes when messages trickle in.
+  std::chrono::microseconds maxLatency{0};
+
+  /// Record the UTC time each message was logged, as
+  /// `2024-01-31T12:34:56.123456789Z` (a line prefix with `LineFormat::Plain`).
+  ///
+  /// The caller only reads the CPU's cycle counter; the backend converts the
+  /// reading to wall-clock time while formatting.
+  bool timestamps = false;
+
+  /// Measure each record's enqueue-to-write latency for
+  /// `ILogger::stats()`.
+  ///
+  /// Costs the caller the cycle-counter read `timestamps` needs (one read
+  /// serves both), and the backend one conversion per record.
+  bool latencyHistogram = false;
+
+  /// Output encoding.
+  OutputFormat outputFormat = OutputFormat::Text;
+
+  /// Line layout of `OutputFormat::Text`; ignored for `OutputFormat::Binary`.
+  LineFormat lineFormat = LineFormat::Plain;
+
+  /// Queue layout between producers and the backend.
+  QueueMode queueMode = QueueMode::Shared;
+
+  /// Backend threads draining the per-thread rings.
+  ///
+  /// Each backend drains its own share of the rings round-robin and steals
+  /// from the others when its share is empty. Messages from one thread stay
+  /// in order. Must be at least 1, and exactly 1 with `QueueMode::Shared`.
+  std::size_t backendThreads = 1;
+
+  /// CPUs to pin the background threads to.
+  ///
+  /// Backend `i` (the single backend with `QueueMode::Shared`) runs only on
+  /// CPU `backendCpus[i % backendCpus.size()]`; put it on the socket of the
+  /// producers so records do not cross the interconnect. Empty (the default)
+  /// leaves placement to the scheduler. Every CPU must be one the process
+  /// may run on.
+  std::vector<unsigned> backendCpus{};
+
+  /// One backend per NUMA node, instead of `backendThreads`, each running on
+  /// its node's CPUs and draining first the rings of the producers that
+  /// registered on its node. `QueueMode::PerThread` only; exclusive with
+  /// `backendCpus`.
+  bool backendPerNode = false;
+
+  /// Place each producer thread's ring in memory on the NUMA node the thread
+  /// runs on when it registers, rather than wherever the allocator finds
+  /// room. `QueueMode::PerThread` only.
+  bool nodeLocalQueues = false;
+
+  /// Longest record, in bytes of message or encoded arguments, copied into
+  /// its ring slot; longer ones go to the producer thread's record arena.
+  ///
+  /// A slot keeps the capacity of the longest record it has held, so short
+  /// records cost no allocation once the ring has been round once.
+  std::size_t inlineRecordBytes = 256;
+
+  /// Size of each producer thread's record arena, allocated with the
+  /// thread's first record longer than `inlineRecordBytes`.
+  ///
+  /// The backend frees each record's space as soon as it has formatted it,
+  /// so multi-kilobyte messages cost no allocation in steady state. A record
+  /// that does not fit (the arena is full of records still queued, or it is
+  /// longer than the arena) is copied to the heap instead and counted in
+  /// `LoggerStats::arenaFallbacks`. Zero disables the arenas.
+  std::size_t arenaBytes = 1024 * 1024;
+
+  /// Per-call-site throttling applied on the calling thread; off by default.
+  RateLimitConfig rateLimit{};
+
+  /// Called on the backend thread with the encoded records of every batch,
+  /// as spans into the batch, before it is written; none by default. See
+  /// `LogTap`, and `TapRing` to read the records from another process.
+  LogTap tap{};
+
+  /// How the backend threads wait for records when their queues are empty,
+  /// and while they hold a partial batch for `maxLatency`.
+  WaitStrategy waitStrategy = WaitStrategy::Park;
+
+  /// Compression the backend threads apply to each batch they write; none
+  /// by default. `LoggerStats::bytes` counts the output before it. Only
+  /// `createAsyncLogger()` compresses: `createUringFileLogger()` and
+  /// `createFanOutLogger()` reject it, and mapped-file segments are never
+  /// compressed.
+  Compression compression = Compression::None;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <logger/DeferredFormat.hpp>
+#include <logger/Fields.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogContext.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/RateLimit.hpp>
+#include <logger/StagingBuffer.hpp>
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace sample::logger {
+
+/// A destination for log messages that have passed the level check.
+///
+/// `write()` receives one message, without a line terminator. A sink used
+/// from several threads must be thread-safe itself.
+template <typename S>
+concept LogSink = requires(S &sink, Level level, std::string_view message) {
+  sink.write(level, message);
+};
+
+/// A `LogSink` that also accepts `logf()` records unformatted.
+///
+/// Lets a sink defer formatting (e.g. to a writer thread); see
+/// `ILogger::writeDeferred()` for the meaning of the arguments.
+template <typename S>
+concept DeferredLogSink =
+    LogSink<S> && requires(S &sink, Level level, const DeferredFormat &format,
+                           std::span<const std::byte> args) {
+      sink.writeDeferred(level, format, args);
+    };
+
+/// A `LogSink` that buffers output and can be told to write it out.
+template <typename S>
+concept FlushableLogSink = LogSink<S> && requires(S &sink) { sink.flush(); };
+
+/// The logging front-end shared by `ILogger` and `BasicLogger`.
+///
+/// Code that only logs can be written against this concept and accept
+/// either the virtual interface or a statically typed logger.
+template <typename L>
+concept Logger = requires(L &logger, const L &constLogger, CallSite &site,
+                          Level level, std::string_view message) {
+  logger.log(message);
+  logger.log(level, message);
+  logger.log(level, message, field("key", 0));
+  logger.log(site, level, message);
+  logger.template logf<"{}">(level, 0);
+  logger.template logf<"{}">(site, level, 0);
+  logger.setLevel(level);
+  logger.setFlushLevel(level);
+  logger.flush();
+  { constLogger.isEnabled(level) } -> std::same_as<bool>;
+  { constLogger.level() } -> std::same_as<Level>;
+};
+
+/// A logger whose sink type is fixed at compile time.
+///
+/// Offers the same front-end as `ILogger` without any virtual call, so the
+/// level check and the sink can be inlined into the caller. Use it where the
+/// concrete destination is known (e.g. at the composition root) and
+/// `LoggerAdapter` where an `ILogger` is required.
+///
+/// ```cpp
+/// logger::BasicLogger<logger::ConsoleSink> log;
+/// log.logf<"request {} took {}us">(id, micros);
+/// ```
+///
+/// `logf()` and structured `log()` format on the calling thread unless `Sink`
+/// is a `DeferredLogSink`, in which case the arguments are encoded and handed
+/// over as with `ILogger::logf()`. Records carry the active `LogContext` as
+/// they do for `ILogger`; without a `DeferredLogSink` its pairs are
+/// formatted after the message.
+template <LogSink Sink> class BasicLogger {
+public:
+  /// Construct the sink from `args`.
+  template <typename... Args>
+    requires std::constructible_from<Sink, Args...>
+  explicit BasicLogger(Args &&...args) : sink_(std::forward<Args>(args)...) {}
+
+  /// Construct the sink from `args` and throttle call sites as `rateLimit`.
+  ///
+  /// ## Throws
+  /// `std::invalid_argument` if `rateLimit` is invalid; see `RateLimiter`.
+  template <typename... Args>
+    requires std::constructible_from<Sink, Args...>
+  explicit BasicLogger(const RateLimitConfig &rateLimit, Args &&...args)
+      : sink_(std::forward<Args>(args)...), limiter_{rateLimit} {}
+
+  ~BasicLogger() = default;
+
+  BasicLogger(const BasicLogger &) = delete;
+  auto operator=(const BasicLogger &) -> BasicLogger & = delete;
+  BasicLogger(BasicLogger &&) = delete;
+  auto operator=(BasicLogger &&) -> BasicLogger & = delete;
+
+  /// Log a message at `Level::Info`; see `ILogger::log()`.
+  void log(std::string_view message) { log(Level::Info, message); }
+
+  /// Log a message at `level`; see `ILogger::log()`.
+  void log(Level level, std::string_view message) {
+    if (!isEnabled(level)) {
+      return;
+    }
+    if (const LogContext *context = LogContext::active()) {
+      if constexpr (DeferredLogSink<Sink>) {
+        detail::encodeStructuredInContext(
+            [this, level](const DeferredFormat &format,
+                          std::span<const std::byte> bytes) {
+              sink_.writeDeferred(level, format, bytes);
+            },
+            context->fields(), message);
+      } else {
+        StagingBuffer text;
+        text.buffer().append(message);
+        text.buffer().append(context->text());
+        sink_.write(level, text.view());
+      }
+    } else {
+      sink_.write(level, message);
+    }
+    flushIfSevere(level);
+  }
+
+  /// Log a structured message at `Level::Info`; see `ILogger::log()`.
+  template <DeferredArgument... Values>
+    requires(sizeof...(Values) > 0)
+  void log(std::string_view message, const Field<Values> &...fields) {
+    log(Level::Info, message, fields...);
+  }
+
+  /// Log a structured message at `level`; see `ILogger::log()`.
+  template <DeferredArgument... Values>
+    requires(sizeof...(Values) > 0)
+  void log(Level level, std::string_view message,
+           const Field<Values> &...fields) {
+    if (!isEnabled(level)) {
+      return;
+    }
+    if constexpr (DeferredLogSink<Sink>) {
+      encodeMessage(deferredWriter(level), message, fields...);
+    } else {
+      StagingBuffer text;
+      detail::formatStructuredNow(text.buffer(), message, fields...);
+      appendContext(text);
+      sink_.write(level, text.view());
+    }
+    flushIfSevere(level);
+  }
+
+  /// Log a message from the call site `site`; see `ILogger::log()`.
+  template <DeferredArgument... Values>
+  void log(CallSite &site, Level level, std::string_view message,
+           const Field<Values> &...fields) {
+    if (!isEnabled(level) || !limiter_.admit(site, noteWriter(level))) {
+      return;
+    }
+    if (sizeof...(Values) == 0 && LogContext::active() == nullptr) {
+      if (isFresh(site, level, nullptr, std::as_bytes(std::span{message}))) {
+        sink_.write(level, message);
+      }
+    } else if constexpr (DeferredLogSink<Sink>) {
+      encodeMessage(deferredWriter(site, level), message, fields...);
+    } else {
+      StagingBuffer text;
+      detail::formatStructuredNow(text.buffer(), message, fields...);
+      appendContext(text);
+      const std::string_view view = text.view();
+      if (isFresh(site, level, nullptr, std::as_bytes(std::span{view}))) {
+        sink_.write(level, view);
+      }
+    }
+    flushIfSevere(level);
+  }
+
+  /// Log a formatted message at `Level::Info`; see `ILogger::logf()`.
+  template <FixedString Format, DeferredArgument... Args>
+  void logf(const Args &...args) {
+    logf<Format>(Level::Info, args...);
+  }
+
+  /// Log a formatted message at `level`; see `ILogger::logf()`.
+  template <FixedString Format, DeferredArgument... Args>
+  void logf(Level level, const Args &...args) {
+    logf<Format>(detail::callSiteFor<Format, detail::DecodedType<Args>...>,
+                 level, args...);
+  }
+
+  /// Log a formatted message from the call site `site`; see
+  /// `ILogger::logf()`.
+  template <FixedString Format, DeferredArgument... Args>
+  void logf(CallSite &site, Level level, const Args &...args) {
+    if (!isEnabled(level) || !limiter_.admit(site, noteWriter(level))) {
+      return;
+    }
+    if constexpr (DeferredLogSink<Sink>) {
+      if (const LogContext *context = LogContext::active()) {
+        detail::encodeDeferredInContext<Format>(deferredWriter(site, level),
+                                                context->text(), args...);
+      } else {
+        detail::encodeDeferred<Format>(deferredWriter(site, level), args...);
+      }
+    } else {
+      StagingBuffer text;
+      fmt::format_to(std::back_inserter(text.buffer()), Format.view(),
+                     args...);
+      appendContext(text);
+      const std::string_view view = text.view();
+      if (isFresh(site, level, nullptr, std::as_bytes(std::span{view}))) {
+        sink_.write(level, view);
+      }
+    }
+    flushIfSevere(level);
+  }
+
+  /// Whether a message at `level` would be written; see
+  /// `ILogger::isEnabled()`.
+  [[nodiscard]] auto isEnabled(Level level) const -> bool {
+    return isCompiledIn(level) &&
+           level >= level_.load(std::memory_order_relaxed);
+  }
+
+  /// Current runtime threshold.
+  [[nodiscard]] auto level() const -> Level {
+    return level_.load(std::memory_order_relaxed);
+  }
+
+  /// Change the runtime threshold; see `ILogger::setLevel()`.
+  void setLevel(Level level) {
+    level_.store(level, std::memory_order_relaxed);
+  }
+
+  /// Change the flush threshold; see `ILogger::setFlushLevel()`.
+  void setFlushLevel(Level level) {
+    flushLevel_.store(level, std::memory_order_relaxed);
+  }
+
+  /// Current flush threshold.
+  [[nodiscard]] auto flushLevel() const -> Level {
+    return flushLevel_.load(std::memory_order_relaxed);
+  }
+
+  /// Write out anything the sink buffers; does nothing unless `Sink` is a
+  /// `FlushableLogSink`. See `ILogger::flush()`.
+  void flush() {
+    if constexpr (FlushableLogSink<Sink>) {
+      sink_.flush();
+    }
+  }
+
+  /// The sink messages are written to.
+  [[nodiscard]] auto sink() -> Sink & { return sink_; }
+  [[nodiscard]] auto sink() const -> const Sink & { return sink_; }
+
+private:
+  /// Flush after a message at `level` if `setFlushLevel()` asks for it.
+  void flushIfSevere(Level level) {
+    if (level >= flushLevel_.load(std::memory_order_relaxed)) {
+      flush();
+    }
+  }
+
+  /// Writes the rate limiter's notes at `level`.
+  auto noteWriter(Level level) {
+    return [this, level](std::string_view note) { sink_.write(level, note); };
+  }
+
+  /// Encode `message` and `fields`, and the pairs of the active
+  /// `LogContext` if any, and hand the record to `write`.
+  template <typename Write, DeferredArgument... Values>
+  static void encodeMessage(const Write &write, std::string_view message,
+                            const Field<Values> &...fields) {
+    if (const LogContext *context = LogContext::active()) {
+      detail::encodeStructuredInContext(write, context->fields(), message,
+                                        fields...);
+    } else {
+      detail::encodeStructured(write, message, fields...);
+    }
+  }
+
+  /// Append the pairs of the active `LogContext`, if any, to `text`.
+  static void appendContext(StagingBuffer &text) {
+    if (const LogContext *context = LogContext::active()) {
+      text.buffer().append(context->text());
+    }
+  }
+
+  /// The `write` callback of `detail::encodeStructured()`.
+  auto deferredWriter(Level level) {
+    return [this, level](const DeferredFormat &format,
+                         std::span<const std::byte> bytes) {
+      sink_.writeDeferred(level, format, bytes);
+    };
+  }
+
+  /// Whether a message from `site` is not a repeat to collapse; see
+  /// `RateLimiter::isFresh()`.
+  auto isFresh(CallSite &site, Level level, const void *key,
+               std::span<const std::byte> bytes) -> bool {
+    return !limiter_.collapsesRepeats() ||
+           limiter_.isFresh(site, RateLimiter::digestOf(level, key, bytes),
+                            noteWriter(level));
+  }
+
+  /// The `write` callback of `detail::encodeDeferred()` for `site`.
+  auto deferredWriter(CallSite &site, Level level) {
+    return [this, &site, level](const DeferredFormat &format,
+                                std::span<const std::byte> bytes) {
+      if (isFresh(site, level, &format, bytes)) {
+        sink_.writeDeferred(level, format, bytes);
+      }
+    };
+  }
+
+  [[no_unique_address]] Sink sink_;
+  std::atomic<Level> level_{CompiledMinLevel};
+  std::atomic<Level> flushLevel_{Level::Off};
+  RateLimiter limiter_;
+};
+
+/// An `ILogger` that writes to a statically typed sink.
+///
+/// Bridges a `LogSink` to code that needs the virtual interface, such as the
+/// factories in `LoggerFactory.hpp`. Only the call into the logger is
+/// virtual; the sink itself is called directly.
+template <LogSink Sink> class LoggerAdapter final : public ILogger {
+public:
+  /// Construct the sink from `args`.
+  template <typename... Args>
+    requires std::constructible_from<Sink, Args...>
+  explicit LoggerAdapter(Args &&...args)
+      : sink_(std::forward<Args>(args)...) {}
+
+  /// Construct the sink from `args` and throttle call sites as `rateLimit`.
+  ///
+  /// ## Throws
+  /// `std::invalid_argument` if `rateLimit` is invalid; see `RateLimiter`.
+  template <typename... Args>
+    requires std::constructible_from<Sink, Args...>
+  explicit LoggerAdapter(const RateLimitConfig &rateLimit, Args &&...args)
+      : ILogger{rateLimit}, sink_(std::forward<Args>(args)...) {}
+
+  /// Write out anything the sink buffers; see `BasicLogger::flush()`.
+  void flush() override {
+    if constexpr (FlushableLogSink<Sink>) {
+      sink_.flush();
+    }
+  }
+
+  /// The sink messages are written to.
+  [[nodiscard]] auto sink() -> Sink & { return sink_; }
+  [[nodiscard]] auto sink() const -> const Sink & { return sink_; }
+
+private:
+  void write(Level level, std::string_view message) override {
+    sink_.write(level, message);
+  }
+
+  void writeDeferred(Level level, const DeferredFormat &format,
+                     std::span<const std::byte> args) override {
+    if constexpr (DeferredLogSink<Sink>) {
+      sink_.writeDeferred(level, format, args);
+    } else {
+      ILogger::writeDeferred(level, format, args);
+    }
+  }
+
+  [[no_unique_address]] Sink sink_;
+};
+
+static_assert(Logger<ILogger>);
+
+} // namespace sample::logger
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <logger/DeferredFormat.hpp>
+#include <logger/Lz4Decoder.hpp>
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sample::logger {
+
+/// Output produced by `BinaryLogDecoder`.
+enum class DecodeFormat {
+  /// The lines the asynchronous logger writes with `OutputFormat::Text`.
+  Text,
+  /// One JSON object per line with `time` (when timestamped), `level` and
+  /// `message`; records from `logf()` also carry `pattern` and `args`, and
+  /// structured messages a member per field.
+  Json,
+};
+
+/// Converts the output of an `OutputFormat::Binary` asynchronous logger back
+/// into text or JSON.
+///
+/// The binary stream is self-describing: each `logf()` call site's format
+/// string and argument layout is written once per logger, and records then
+/// carry only an id, the level, a timestamp and the encoded arguments.
+/// Arguments of types with no portable layout (see `ArgKind::Other`) are shown
+/// as `<N bytes>`. A stream compressed with `Compression::Lz4` is recognised
+/// by its first bytes and decompressed on the way. Feed the stream in chunks
+/// of any size:
+///
+/// ```cpp
+/// logger::BinaryLogDecoder decoder{logger::DecodeFormat::Json};
+/// const std::size_t used = decoder.decode(bytes, text);
+/// // Keep bytes[used..] and pass them again with the next chunk.
+/// ```
+class BinaryLogDecoder {
+public:
+  /// Create a decoder producing `format`.
+  explicit BinaryLogDecoder(DecodeFormat format = DecodeFormat::Text);
+
+  /// Decode the complete frames at the start of `input`.
+  ///
+  /// Appends one line per record, newline included, to `out`.
+  ///
+  /// ## Returns
+  /// Bytes consumed. The remainder is the start of an incomplete frame and
+  /// should be passed again, followed by more data. Of a compressed stream
+  /// every whole block is consumed, and the decompressed start of an
+  /// incomplete frame kept; see `buffered()`.
+  ///
+  /// ## Throws
+  /// `std::runtime_error` if the input does not start with a binary log
+  /// session, compressed or not, or is corrupt.
+  auto decode(std::span<const std::byte> input, fmt::memory_buffer &out)
+      -> std::size_t;
+
+  /// Decompressed bytes held back as the start of an incomplete frame; 0
+  /// for an uncompressed stream.
+  [[nodiscard]] auto buffered() const -> std::size_t { return plain_.size(); }
+
+private:
+  struct Definition {
+    std::string pattern;
+    std::vector<DeferredArg> args;
+    bool structured;
+  };
+
+  auto decodeFrames(std::span<const std::byte> input, fmt::memory_buffer &out)
+      -> std::size_t;
+  auto decodeFrame(std::span<const std::byte> input, fmt::memory_buffer &out)
+      -> std::size_t;
+
+  DecodeFormat format_;
+  bool started_ = false;
+  std::uint64_t offset_ = 0;
+  std::unordered_map<std::uint32_t, Definition> definitions_;
+  std::optional<Lz4Decoder> lz4_;
+  fmt::memory_buffer plain_;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <logger/LogLevel.hpp>
+
+#include <string_view>
+
+namespace sample::logger {
+
+/// `LogSink` that writes each message to stdout on its own line.
+///
+/// The sink behind `createDefaultLogger()`; use it with `BasicLogger` for a
+/// console logger without virtual dispatch. Each message and its newline go
+/// to file descriptor 1 in one unbuffered `writev(2)`, so lines written by
+/// several threads stay whole, nothing needs flushing, and no iostream (nor
+/// its static initialisation) is involved.
+struct ConsoleSink {
+  void write(Level level, std::string_view message) const;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+
+namespace sample::logger {
+
+/// Install handlers that write out the records still queued in every live
+/// asynchronous logger when the process dies of `SIGSEGV`, `SIGBUS`,
+/// `SIGFPE`, `SIGILL`, `SIGABRT` or `SIGTERM`.
+///
+/// The handler only uses async-signal-safe operations: it wakes each
+/// logger's writer threads, which write their queued records and partial
+/// batches to the output, and waits for them on a futex. It then restores
+/// the disposition each signal had before the first call and raises the
+/// signal again, so a previous handler or the default action (core dump,
+/// termination) still runs. Records are lost if the crashing thread is a
+/// logger's own writer thread, or if the writers have not finished within
+/// `drainTimeout`.
+///
+/// Calling it again only changes `drainTimeout`.
+///
+/// ## Parameters
+/// - `drainTimeout`: Longest the handler waits for the loggers in total.
+///
+/// ## Throws
+/// `std::system_error` if a handler cannot be installed.
+void installCrashHandler(
+    std::chrono::milliseconds drainTimeout = std::chrono::seconds{1});
+
+} // namespace sample::logger
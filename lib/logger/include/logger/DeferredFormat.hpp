@@ -0,0 +1,454 @@
+#pragma once
+
+#include <logger/StagingBuffer.hpp>
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace sample::logger {
+
+/// A string literal usable as a template argument.
+///
+/// Lets a format string travel in the type system so that each call site of
+/// `ILogger::logf()` gets its own statically allocated `DeferredFormat`.
+template <std::size_t N> struct FixedString {
+  // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+  consteval FixedString(const char (&text)[N]) {
+    std::copy_n(text, N, value.begin());
+  }
+
+  /// The literal without its terminating NUL.
+  [[nodiscard]] constexpr auto view() const -> std::string_view {
+    return {value.data(), N - 1};
+  }
+
+  /// Storage; public because template arguments must be structural types.
+  std::array<char, N> value{};
+};
+
+/// Formats a record's encoded arguments, appending the text to `out`.
+using DeferredFormatFn = void (*)(std::span<const std::byte> args,
+                                  fmt::memory_buffer &out);
+
+/// How the fields of a structured record are rendered.
+enum class FieldStyle : std::uint8_t {
+  /// ` key=value` per field, quoting values that need it.
+  Logfmt,
+  /// `,"key":value` per field, for splicing into a JSON object.
+  Json,
+};
+
+/// Renders the fields of a structured record's encoded arguments in `style`,
+/// appending them to `out`.
+using RenderFieldsFn = void (*)(std::span<const std::byte> args,
+                                FieldStyle style, fmt::memory_buffer &out);
+
+/// How an encoded `logf()` argument is laid out, for readers that cannot
+/// call `DeferredFormat::format` (e.g. an offline decoder).
+enum class ArgKind : std::uint8_t {
+  /// `bool`, one byte.
+  Bool,
+  /// `char`, one byte.
+  Char,
+  /// Two's-complement signed integer of `DeferredArg::size` bytes.
+  Signed,
+  /// Unsigned integer of `DeferredArg::size` bytes.
+  Unsigned,
+  /// IEEE-754 `float` or `double` (by `DeferredArg::size`).
+  Float,
+  /// A pointer, formatted as its address.
+  Pointer,
+  /// A string: its length as a `std::size_t`, then its characters.
+  String,
+  /// Any other trivially copyable type: `DeferredArg::size` opaque bytes.
+  Other,
+};
+
+/// Describes one encoded `logf()` argument.
+struct DeferredArg {
+  ArgKind kind;
+  /// Encoded size in bytes; for `ArgKind::String` the size of the length.
+  std::uint32_t size;
+};
+
+/// Describes one deferred-format call site.
+///
+/// One instance exists per (format string, argument types) combination; its
+/// address is stable for the life of the program, so it can be queued in
+/// place of the formatted text.
+struct DeferredFormat {
+  /// The `fmt` format string, as written at the call site.
+  std::string_view pattern;
+  /// Decodes the arguments and formats them with `pattern`.
+  DeferredFormatFn format;
+  /// Layout of the encoded arguments, in order.
+  std::span<const DeferredArg> args;
+  /// Set for a structured record (see `Fields.hpp`), whose first argument is
+  /// the message, followed by a key and a value per field; null otherwise.
+  RenderFieldsFn fields;
+};
+
+namespace detail {
+
+/// Types that refer to data they do not own: pointers other than `void`
+/// ones (formatted with `{:p}`), arrays (passed as pointers), iterators and
+/// borrowed ranges such as `std::span`. A copy of one is only the reference,
+/// which may dangle by the time another thread formats the record.
+template <typename T>
+concept BorrowingArgument =
+    (std::is_pointer_v<T> && !std::is_void_v<std::remove_pointer_t<T>>) ||
+    std::is_array_v<T> || std::input_or_output_iterator<T> ||
+    std::ranges::borrowed_range<T>;
+
+} // namespace detail
+
+/// Argument types accepted by `ILogger::logf()`.
+///
+/// Strings are copied by value; anything else must be trivially copyable so
+/// that it can be captured with `memcpy` and formatted later on another
+/// thread, and must not be a `detail::BorrowingArgument`. A struct holding a
+/// pointer or a view is still accepted, and must only point at data that
+/// outlives the record.
+template <typename T>
+concept DeferredArgument = std::convertible_to<const T &, std::string_view> ||
+                           (std::is_trivially_copyable_v<T> &&
+                            !detail::BorrowingArgument<T>);
+
+namespace detail {
+
+template <typename T>
+concept StringArgument = std::convertible_to<const T &, std::string_view>;
+
+/// Type an argument is decoded to on the formatting thread.
+template <typename T>
+using DecodedType =
+    std::conditional_t<StringArgument<T>, std::string_view, std::decay_t<T>>;
+
+/// What `parseFormat()` finds in a format string.
+struct ParsedFormat {
+  /// Number of arguments the replacement fields refer to.
+  std::size_t arguments = 0;
+  /// Whether every brace is matched or escaped, and the fields neither
+  /// name their arguments nor mix automatic and manual indexing.
+  bool valid = true;
+  /// Whether the fields give their argument ids.
+  bool manual = false;
+};
+
+/// Parses the replacement fields of a `fmt` format string at compile time.
+class FormatParser {
+public:
+  explicit consteval FormatParser(std::string_view format)
+      : format_{format} {}
+
+  /// The fields of the whole format string.
+  consteval auto parse() -> ParsedFormat {
+    for (std::size_t position = 0; valid_ && position < format_.size();
+         ++position) {
+      const char character = format_[position];
+      if (character == '}') {
+        valid_ = at(position + 1) == '}';
+        ++position;
+      } else if (character == '{' && at(position + 1) == '{') {
+        ++position;
+      } else if (character == '{') {
+        position = field(position + 1);
+      }
+    }
+    return {.arguments = manual_ ? highest_ : next_,
+            .valid = valid_ && !(manual_ && automatic_),
+            .manual = manual_};
+  }
+
+private:
+  /// The character at `position`, or NUL past the end.
+  [[nodiscard]] consteval auto at(std::size_t position) const -> char {
+    return position < format_.size() ? format_[position] : '\0';
+  }
+
+  /// Parse the argument id at `position`; return the position after it.
+  consteval auto argumentId(std::size_t position) -> std::size_t {
+    if (at(position) < '0' || at(position) > '9') {
+      valid_ = valid_ && (at(position) == ':' || at(position) == '}');
+      automatic_ = true;
+      ++next_;
+      return position;
+    }
+    std::size_t index = 0;
+    for (; at(position) >= '0' && at(position) <= '9'; ++position) {
+      index = index * 10 + static_cast<std::size_t>(at(position) - '0');
+    }
+    manual_ = true;
+    highest_ = std::max(highest_, index + 1);
+    return position;
+  }
+
+  /// Parse the field whose argument id starts at `position`, nested width
+  /// and precision fields included; return the position of its `}`.
+  consteval auto field(std::size_t position) -> std::size_t {
+    position = argumentId(position);
+    if (at(position) == ':') {
+      for (++position; valid_ && at(position) != '}'; ++position) {
+        if (at(position) == '\0') {
+          valid_ = false;
+        } else if (at(position) == '{') {
+          position = argumentId(position + 1);
+          valid_ = valid_ && at(position) == '}';
+        }
+      }
+    }
+    valid_ = valid_ && at(position) == '}';
+    return position;
+  }
+
+  std::string_view format_;
+  std::size_t next_ = 0;
+  std::size_t highest_ = 0;
+  bool automatic_ = false;
+  bool manual_ = false;
+  bool valid_ = true;
+};
+
+/// The replacement fields of `format`.
+consteval auto parseFormat(std::string_view format) -> ParsedFormat {
+  return FormatParser{format}.parse();
+}
+
+/// `parseFormat()` of a call site's format string.
+template <FixedString Format>
+inline constexpr ParsedFormat parsedFormatOf = parseFormat(Format.view());
+
+/// Number of decimal digits of `value`.
+consteval auto decimalDigits(std::size_t value) -> std::size_t {
+  std::size_t digits = 1;
+  for (; value >= 10; value /= 10) {
+    ++digits;
+  }
+  return digits;
+}
+
+/// `Format` followed by one more replacement field, for the text of the
+/// active `LogContext`: `{}`, or `{N}` if `Format` numbers its fields.
+template <FixedString Format> consteval auto withContextField() {
+  constexpr ParsedFormat Parsed = parsedFormatOf<Format>;
+  constexpr std::size_t Size = Format.view().size();
+  constexpr std::size_t Digits =
+      Parsed.manual ? decimalDigits(Parsed.arguments) : 0;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays)
+  char text[Size + Digits + 3] = {};
+  std::copy_n(Format.value.begin(), Size, text);
+  text[Size] = '{';
+  for (std::size_t digit = Digits, id = Parsed.arguments; digit > 0;
+       --digit, id /= 10) {
+    text[Size + digit] = static_cast<char>('0' + id % 10);
+  }
+  text[Size + Digits + 1] = '}';
+  return FixedString{text};
+}
+
+/// Number of bytes `arg` occupies once encoded.
+template <typename T>
+[[nodiscard]] auto encodedSize(const T &arg) -> std::size_t {
+  if constexpr (StringArgument<T>) {
+    return sizeof(std::size_t) + std::string_view{arg}.size();
+  } else {
+    return sizeof(T);
+  }
+}
+
+/// Encode `arg` at `out` and return the first byte past it.
+template <typename T>
+auto encodeArg(std::byte *out, const T &arg) -> std::byte * {
+  if constexpr (StringArgument<T>) {
+    const std::string_view text{arg};
+    const std::size_t size = text.size();
+    std::memcpy(out, &size, sizeof(size));
+    std::memcpy(out + sizeof(size), text.data(), size);
+    return out + sizeof(size) + size;
+  } else {
+    std::memcpy(out, &arg, sizeof(T));
+    return out + sizeof(T);
+  }
+}
+
+/// Decode a `T` at `in` and advance `in` past it.
+template <typename T> auto decodeArg(const std::byte *&in) -> T {
+  if constexpr (std::same_as<T, std::string_view>) {
+    std::size_t size = 0;
+    std::memcpy(&size, in, sizeof(size));
+    const auto *text = reinterpret_cast<const char *>(in + sizeof(size));
+    in += sizeof(size) + size;
+    return {text, size};
+  } else {
+    std::array<std::byte, sizeof(T)> raw;
+    std::memcpy(raw.data(), in, sizeof(T));
+    in += sizeof(T);
+    return std::bit_cast<T>(raw);
+  }
+}
+
+/// `DeferredFormatFn` for a call site with format `Format` and arguments
+/// decoded as `Decoded...`.
+template <FixedString Format, typename... Decoded>
+void formatDeferred(std::span<const std::byte> args, fmt::memory_buffer &out) {
+  [[maybe_unused]] const std::byte *cursor = args.data();
+  // Braced initialisation evaluates the decoders left to right.
+  const std::tuple<Decoded...> values{decodeArg<Decoded>(cursor)...};
+  std::apply(
+      [&out](const Decoded &...value) {
+        // The pattern is parsed into formatting code at compile time, so a
+        // record is formatted without reading it.
+        fmt::format_to(std::back_inserter(out), FMT_COMPILE(Format.view()),
+                       value...);
+      },
+      values);
+}
+
+/// Layout descriptor of an argument decoded as `T`.
+template <typename T> consteval auto deferredArgOf() -> DeferredArg {
+  constexpr auto size = static_cast<std::uint32_t>(sizeof(T));
+  if constexpr (std::same_as<T, std::string_view>) {
+    return {ArgKind::String, static_cast<std::uint32_t>(sizeof(std::size_t))};
+  } else if constexpr (std::same_as<T, bool>) {
+    return {ArgKind::Bool, size};
+  } else if constexpr (std::same_as<T, char>) {
+    return {ArgKind::Char, size};
+  } else if constexpr (std::signed_integral<T>) {
+    return {ArgKind::Signed, size};
+  } else if constexpr (std::unsigned_integral<T>) {
+    return {ArgKind::Unsigned, size};
+  } else if constexpr (std::same_as<T, float> || std::same_as<T, double>) {
+    return {ArgKind::Float, size};
+  } else if constexpr (std::is_pointer_v<T> ||
+                       std::same_as<T, std::nullptr_t>) {
+    return {ArgKind::Pointer, size};
+  } else {
+    return {ArgKind::Other, size};
+  }
+}
+
+/// Layout descriptors of a call site's arguments.
+template <typename... Decoded>
+inline constexpr std::array<DeferredArg, sizeof...(Decoded)> deferredArgsFor{
+    deferredArgOf<Decoded>()...};
+
+/// The unique descriptor for a call site.
+template <FixedString Format, typename... Decoded>
+inline constexpr DeferredFormat deferredFormatFor{
+    Format.view(), &formatDeferred<Format, Decoded...>,
+    deferredArgsFor<Decoded...>, nullptr};
+
+/// Stack buffer for encoded arguments.
+///
+/// Arguments too large for the inline storage spill into a `StagingBuffer`,
+/// so encoding does not allocate once the thread's buffers are warm.
+class EncodeBuffer {
+public:
+  explicit EncodeBuffer(std::size_t size) : size_{size} {
+    if (size > inline_.size()) {
+      spill_.emplace();
+      spill_->buffer().resize(size);
+    }
+  }
+
+  [[nodiscard]] auto data() -> std::byte * {
+    return spill_ ? reinterpret_cast<std::byte *>(spill_->buffer().data())
+                  : inline_.data();
+  }
+
+  [[nodiscard]] auto bytes() -> std::span<const std::byte> {
+    return {data(), size_};
+  }
+
+private:
+  // Deliberately uninitialised: only the first `size_` bytes are ever read.
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  std::array<std::byte, 256> inline_;
+  std::optional<StagingBuffer> spill_;
+  std::size_t size_;
+};
+
+/// Offsets of arguments of types `Args...`, none a string, once encoded.
+template <typename... Args>
+inline constexpr auto fixedOffsetsOf = [] {
+  std::array<std::size_t, sizeof...(Args)> offsets{};
+  std::size_t offset = 0;
+  std::size_t index = 0;
+  ((offsets[index++] = offset, offset += sizeof(Args)), ...);
+  return offsets;
+}();
+
+/// Copy `args`, none a string, to their `fixedOffsetsOf` in `out`.
+template <typename... Args, std::size_t... Index>
+void encodeFixed([[maybe_unused]] std::byte *out,
+                 std::index_sequence<Index...> /*indices*/,
+                 const Args &...args) {
+  (std::memcpy(out + fixedOffsetsOf<Args...>[Index], &args, sizeof(Args)),
+   ...);
+}
+
+/// Encode `args` for the call site `Format` and hand the record to `write`.
+///
+/// `write` is invoked once as `write(descriptor, bytes)`; `bytes` is only
+/// valid for the duration of that call. Without string arguments the layout
+/// is fixed: the record is a stack array of its exact size, filled by one
+/// `memcpy` per argument at an offset known at compile time.
+///
+/// A format string that `parseFormat()` rejects, or whose fields refer to a
+/// different number of arguments than are passed, does not compile.
+template <FixedString Format, typename Write, DeferredArgument... Args>
+void encodeDeferred(const Write &write, const Args &...args) {
+  static_assert(parsedFormatOf<Format>.valid,
+                "logf(): malformed format string");
+  static_assert(parsedFormatOf<Format>.arguments == sizeof...(Args),
+                "logf(): the format string's replacement fields do not "
+                "match the number of arguments");
+  constexpr const DeferredFormat &Descriptor =
+      deferredFormatFor<Format, DecodedType<Args>...>;
+  if constexpr ((StringArgument<Args> || ...)) {
+    EncodeBuffer buffer{(std::size_t{0} + ... + encodedSize(args))};
+    std::byte *cursor = buffer.data();
+    ((cursor = encodeArg(cursor, args)), ...);
+    write(Descriptor, buffer.bytes());
+  } else {
+    // Deliberately uninitialised: every byte is written below.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+    std::array<std::byte, (std::size_t{0} + ... + sizeof(Args))> buffer;
+    encodeFixed(buffer.data(), std::index_sequence_for<Args...>{}, args...);
+    write(Descriptor, std::span<const std::byte>{buffer});
+  }
+}
+
+/// Encode `args` for the call site `Format`, followed by `context`, the
+/// `LogContext::text()` of the active context, and hand the record to
+/// `write`; see `encodeDeferred()`.
+template <FixedString Format, typename Write, DeferredArgument... Args>
+void encodeDeferredInContext(const Write &write, std::string_view context,
+                             const Args &...args) {
+  static_assert(parsedFormatOf<Format>.valid,
+                "logf(): malformed format string");
+  static_assert(parsedFormatOf<Format>.arguments == sizeof...(Args),
+                "logf(): the format string's replacement fields do not "
+                "match the number of arguments");
+  encodeDeferred<withContextField<Format>()>(write, args..., context);
+}
+
+} // namespace detail
+
+} // namespace sample::logger
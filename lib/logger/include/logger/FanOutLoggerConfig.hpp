@@ -0,0 +1,49 @@
+#pragma once
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/LogLevel.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace sample::logger {
+
+/// One destination of the fan-out logger.
+struct FanOutTarget {
+  /// Output destination.
+  LogTarget target = LogTarget::Stdout;
+
+  /// Log file for `LogTarget::File`; ignored for the other targets.
+  std::filesystem::path filePath{};
+
+  /// Lowest level written to this destination, applied after the logger's
+  /// own threshold.
+  Level minLevel = Level::Trace;
+
+  /// Write from a dedicated thread, so that a slow destination (a pipe, a
+  /// network file system) does not hold up the others.
+  bool ownThread = false;
+};
+
+/// Construction parameters for the fan-out logger.
+///
+/// Passed by value to `createFanOutLogger()`.
+struct FanOutLoggerConfig {
+  /// Queue, overflow policy, batching, timestamps and line layout, as for
+  /// `createAsyncLogger()`.
+  ///
+  /// `target` and `filePath` are ignored in favour of `targets`;
+  /// `outputFormat` must be `OutputFormat::Text` and `queueMode`
+  /// `QueueMode::Shared`.
+  AsyncLoggerConfig queue{};
+
+  /// Destinations every record is written to. Must not be empty.
+  std::vector<FanOutTarget> targets{};
+
+  /// Batches an `ownThread` destination may have waiting before the backend
+  /// thread waits for it. Must be at least 1.
+  std::size_t maxPendingBatches = 64;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <logger/DeferredFormat.hpp>
+#include <logger/LogContext.hpp>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace sample::logger {
+
+/// A typed key/value pair attached to a structured log message.
+///
+/// Made by `field()`. Refers to its value, so it is only valid until the end
+/// of the full expression that creates it: pass it straight to `log()`.
+template <typename T> struct Field {
+  std::string_view key;
+  const T &value;
+};
+
+/// Pair `key` with `value` for `ILogger::log(level, message, fields...)`.
+///
+/// `value` may be anything `logf()` accepts: strings are copied into the
+/// record, other types captured with `memcpy`.
+template <DeferredArgument T>
+[[nodiscard]] constexpr auto field(std::string_view key, const T &value)
+    -> Field<T> {
+  return {key, value};
+}
+
+namespace detail {
+
+/// Append `text` to `out` as a JSON string literal.
+///
+/// Escapes quotes, backslashes and control characters, and replaces each
+/// byte that is not part of well-formed UTF-8 with U+FFFD, so the literal is
+/// valid whatever `text` holds. Runs of bytes that need neither are found 16
+/// or 32 at a time with the vector instructions of the running CPU, but only
+/// runs of ASCII: each non-ASCII byte ends a run, and its UTF-8 sequence is
+/// validated a byte at a time, so text that is mostly non-ASCII is escaped
+/// at scalar speed.
+void appendJsonString(std::string_view text, fmt::memory_buffer &out);
+
+/// Append `text` to `out` as a logfmt value, quoted (as by
+/// `appendJsonString()`) only if it is empty, holds a space, `=`, a quote, a
+/// backslash or a control character, or is not well-formed UTF-8.
+void appendLogfmtString(std::string_view text, fmt::memory_buffer &out);
+
+/// Append `text` to `out` as a string value in `style`.
+inline void appendFieldText(std::string_view text, FieldStyle style,
+                            fmt::memory_buffer &out) {
+  if (style == FieldStyle::Json) {
+    appendJsonString(text, out);
+  } else {
+    appendLogfmtString(text, out);
+  }
+}
+
+/// Append `value` to `out` as a field value in `style`.
+///
+/// Numbers and booleans are written bare (non-finite numbers are `null` in
+/// JSON); everything else is written as a string, using `fmt` for types
+/// that are not strings.
+template <typename T>
+void appendFieldValue(const T &value, FieldStyle style,
+                      fmt::memory_buffer &out) {
+  if constexpr (StringArgument<T>) {
+    appendFieldText(std::string_view{value}, style, out);
+  } else if constexpr (std::same_as<T, char>) {
+    appendFieldText({&value, 1}, style, out);
+  } else if constexpr (std::same_as<T, bool> || std::is_arithmetic_v<T>) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (style == FieldStyle::Json && !std::isfinite(value)) {
+        out.append(std::string_view{"null"});
+        return;
+      }
+    }
+    fmt::format_to(std::back_inserter(out), "{}", value);
+  } else {
+    fmt::memory_buffer text;
+    fmt::format_to(std::back_inserter(text), "{}", value);
+    appendFieldText({text.data(), text.size()}, style, out);
+  }
+}
+
+/// Append `key` and the separators around it to `out`, ready for the value.
+inline void appendFieldKey(std::string_view key, FieldStyle style,
+                           fmt::memory_buffer &out) {
+  if (style == FieldStyle::Json) {
+    out.push_back(',');
+    appendJsonString(key, out);
+    out.push_back(':');
+  } else {
+    out.push_back(' ');
+    out.append(key);
+    out.push_back('=');
+  }
+}
+
+/// Append one `key` and `value` to `out` in `style`.
+template <typename T>
+void appendField(std::string_view key, const T &value, FieldStyle style,
+                 fmt::memory_buffer &out) {
+  appendFieldKey(key, style, out);
+  appendFieldValue(value, style, out);
+}
+
+/// Decode the next key and `T` value at `cursor` and append them to `out`.
+template <typename T>
+void renderNextField(const std::byte *&cursor, FieldStyle style,
+                     fmt::memory_buffer &out) {
+  const auto key = decodeArg<std::string_view>(cursor);
+  const T value = decodeArg<T>(cursor);
+  appendField(key, value, style, out);
+}
+
+/// `RenderFieldsFn` for structured records with values decoded as
+/// `Decoded...`.
+template <typename... Decoded>
+void renderFields(std::span<const std::byte> args,
+                  [[maybe_unused]] FieldStyle style,
+                  [[maybe_unused]] fmt::memory_buffer &out) {
+  const std::byte *cursor = args.data();
+  static_cast<void>(decodeArg<std::string_view>(cursor));
+  (renderNextField<Decoded>(cursor, style, out), ...);
+}
+
+/// The message of a structured record's encoded arguments.
+[[nodiscard]] inline auto structuredMessage(std::span<const std::byte> args)
+    -> std::string_view {
+  const std::byte *cursor = args.data();
+  return decodeArg<std::string_view>(cursor);
+}
+
+/// `DeferredFormatFn` for structured records: the message, then the fields
+/// in logfmt style.
+template <typename... Decoded>
+void formatStructured(std::span<const std::byte> args,
+                      fmt::memory_buffer &out) {
+  out.append(structuredMessage(args));
+  renderFields<Decoded...>(args, FieldStyle::Logfmt, out);
+}
+
+/// Layout descriptors of a structured record: the message, then a key and a
+/// value per field.
+template <typename... Decoded>
+consteval auto structuredArgsOf()
+    -> std::array<DeferredArg, 1 + 2 * sizeof...(Decoded)> {
+  constexpr DeferredArg Text = deferredArgOf<std::string_view>();
+  std::array<DeferredArg, 1 + 2 * sizeof...(Decoded)> args{};
+  std::size_t index = 0;
+  args[index++] = Text;
+  ((args[index++] = Text, args[index++] = deferredArgOf<Decoded>()), ...);
+  return args;
+}
+
+template <typename... Decoded>
+inline constexpr auto structuredArgsFor = structuredArgsOf<Decoded...>();
+
+/// The unique descriptor for structured records with these value types.
+template <typename... Decoded>
+inline constexpr DeferredFormat structuredFormatFor{
+    "", &formatStructured<Decoded...>, structuredArgsFor<Decoded...>,
+    &renderFields<Decoded...>};
+
+/// Encode `message` and `fields` and hand the record to `write`.
+///
+/// As `encodeDeferred()`: `write` is invoked once as
+/// `write(descriptor, bytes)`, with `bytes` only valid during the call.
+template <typename Write, DeferredArgument... Values>
+void encodeStructured(const Write &write, std::string_view message,
+                      const Field<Values> &...fields) {
+  EncodeBuffer buffer{
+      encodedSize(message) +
+      (std::size_t{0} + ... +
+       (encodedSize(fields.key) + encodedSize(fields.value)))};
+  [[maybe_unused]] std::byte *cursor = encodeArg(buffer.data(), message);
+  ((cursor = encodeArg(cursor, fields.key),
+    cursor = encodeArg(cursor, fields.value)),
+   ...);
+  write(structuredFormatFor<DecodedType<Values>...>, buffer.bytes());
+}
+
+/// As `encodeStructured()`, with the pairs of `context` as string fields
+/// after `fields`.
+template <typename Write, DeferredArgument... Values>
+void encodeStructuredInContext(const Write &write,
+                               std::span<const ContextField> context,
+                               std::string_view message,
+                               const Field<Values> &...fields) {
+  const auto encode =
+      [&]<std::size_t... Index>(std::index_sequence<Index...> /*pairs*/) {
+        encodeStructured(write, message, fields...,
+                         Field<std::string>{context[Index].key,
+                                            context[Index].value}...);
+      };
+  static_assert(LogContext::MaxFields == 4);
+  switch (context.size()) {
+  case 1:
+    encode(std::make_index_sequence<1>{});
+    break;
+  case 2:
+    encode(std::make_index_sequence<2>{});
+    break;
+  case 3:
+    encode(std::make_index_sequence<3>{});
+    break;
+  case 4:
+    encode(std::make_index_sequence<4>{});
+    break;
+  default:
+    encodeStructured(write, message, fields...);
+    break;
+  }
+}
+
+/// Append the text of a structured message to `out` without encoding it:
+/// what `formatStructured()` would produce.
+template <DeferredArgument... Values>
+void formatStructuredNow(fmt::memory_buffer &out, std::string_view message,
+                         const Field<Values> &...fields) {
+  out.append(message);
+  (appendField(fields.key, fields.value, FieldStyle::Logfmt, out), ...);
+}
+
+} // namespace detail
+
+} // namespace sample::logger
@@ -1,11 +1,57 @@
 #pragma once
 
+#include <logger/DeferredFormat.hpp>
+#include <logger/Fields.hpp>
+#include <logger/LogContext.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerStats.hpp>
+#include <logger/RateLimit.hpp>
+#include <logger/StagingBuffer.hpp>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <string_view>
+#include <utility>
 
 namespace sample::logger {
 
+class FlushAwaiter;
+class ILogger;
+
+/// Called by `ILogger::flushThen()` once the messages are written.
+using FlushCallback = std::move_only_function<void()>;
+
+/// Resumes a coroutine awaiting `ILogger::flushAsync()`, e.g. by posting it
+/// to an executor.
+using CoroutineScheduler =
+    std::move_only_function<void(std::coroutine_handle<>)>;
+
+namespace detail {
+
+/// Run `logger.flush()` and then `done` on the library's background thread.
+void flushInBackground(ILogger &logger, FlushCallback done);
+
+/// Resume `coroutine` on the library's background thread.
+void resumeInBackground(std::coroutine_handle<> coroutine);
+
+} // namespace detail
+
 /// Abstract interface for logging messages.
 ///
+/// Every message carries a `Level`. The public entry points apply the
+/// logger's runtime threshold (and `CompiledMinLevel`) before calling the
+/// protected `write()`/`writeDeferred()` that implementations override.
+///
+/// A logger may also throttle call sites (see `RateLimitConfig`); throttled
+/// and collapsed messages are discarded before `write()`/`writeDeferred()`.
+/// Messages at or above `flushLevel()` are followed by a `flush()`.
+///
+/// Records logged while a `LogContext` is active carry its pairs.
+///
 /// Implementations must be thread-safe if used in multi-threaded contexts.
 class ILogger {
 public:
@@ -17,11 +63,374 @@ public:
   ILogger(ILogger &&) = delete;
   auto operator=(ILogger &&) -> ILogger & = delete;
 
-  /// Log a message.
+  /// Log a message at `Level::Info`.
   ///
   /// ## Parameters
   /// - `message`: The message to log. Must be valid UTF-8.
-  virtual void log(std::string_view message) = 0;
+  void log(std::string_view message) { log(Level::Info, message); }
+
+  /// Log a message at `level`.
+  ///
+  /// Does nothing unless `isEnabled(level)`.
+  ///
+  /// ## Parameters
+  /// - `level`: Severity of the message.
+  /// - `message`: The message to log. Must be valid UTF-8.
+  void log(Level level, std::string_view message) {
+    if (!isEnabled(level)) {
+      return;
+    }
+    if (const LogContext *context = LogContext::active()) {
+      detail::encodeStructuredInContext(
+          [this, level](const DeferredFormat &format,
+                        std::span<const std::byte> bytes) {
+            writeDeferred(level, format, bytes);
+          },
+          context->fields(), message);
+    } else {
+      write(level, message);
+    }
+    flushIfSevere(level);
+  }
+
+  /// Log a structured message at `Level::Info`: `message` plus typed
+  /// key/value fields.
+  ///
+  /// The fields are encoded straight into the record, like `logf()`
+  /// arguments, and rendered by the writer: as ` key=value` pairs after the
+  /// message by default, or as JSON/logfmt by loggers configured for it.
+  ///
+  /// ```cpp
+  /// logger.log("request done", field("id", id), field("micros", micros));
+  /// ```
+  ///
+  /// ## Parameters
+  /// - `message`: The message to log. Must be valid UTF-8.
+  /// - `fields`: Made by `field()`. Need not outlive the call.
+  template <DeferredArgument... Values>
+    requires(sizeof...(Values) > 0)
+  void log(std::string_view message, const Field<Values> &...fields) {
+    log(Level::Info, message, fields...);
+  }
+
+  /// Log a structured message at `level`; see `log(message, fields...)`.
+  ///
+  /// Nothing is encoded unless `isEnabled(level)`.
+  template <DeferredArgument... Values>
+    requires(sizeof...(Values) > 0)
+  void log(Level level, std::string_view message,
+           const Field<Values> &...fields) {
+    if (!isEnabled(level)) {
+      return;
+    }
+    encodeMessage(deferredWriter(level), message, fields...);
+    flushIfSevere(level);
+  }
+
+  /// Log a message, optionally structured, from the call site `site`.
+  ///
+  /// As `log(level, message, fields...)`, after applying the logger's rate
+  /// limit and repeat collapsing to `site`. Used by the `LOGGER_*` macros.
+  template <DeferredArgument... Values>
+  void log(CallSite &site, Level level, std::string_view message,
+           const Field<Values> &...fields) {
+    if (!isEnabled(level) || !limiter_.admit(site, noteWriter(level))) {
+      return;
+    }
+    if (sizeof...(Values) == 0 && LogContext::active() == nullptr) {
+      if (isFresh(site, level, nullptr, std::as_bytes(std::span{message}))) {
+        write(level, message);
+      }
+    } else {
+      encodeMessage(deferredWriter(site, level), message, fields...);
+    }
+    flushIfSevere(level);
+  }
+
+  /// Log a message at `Level::Info` whose formatting may be deferred to
+  /// another thread.
+  ///
+  /// The arguments are captured into a compact binary record (strings by
+  /// value, everything else with `memcpy`) and `Format` is applied with `fmt`
+  /// when the record is written. The format string is parsed and checked
+  /// against the argument types at compile time, so a malformed string or a
+  /// wrong number or type of arguments does not build; it is compiled into
+  /// formatting code, so no thread parses it at run time.
+  ///
+  /// ```cpp
+  /// logger.logf<"request {} took {}us">(id, micros);
+  /// ```
+  ///
+  /// Pointers (other than `const void *`, for `{:p}`), iterators, spans and
+  /// other views do not build, as only the reference would be captured. A
+  /// trivially copyable struct holding one is captured as it is, so the data
+  /// it refers to must outlive the record.
+  ///
+  /// ## Parameters
+  /// - `args`: Values referenced by `Format`. Need not outlive the call.
+  template <FixedString Format, DeferredArgument... Args>
+  void logf(const Args &...args) {
+    logf<Format>(Level::Info, args...);
+  }
+
+  /// Log a deferred-format message at `level`; see `logf(args...)`.
+  ///
+  /// Nothing is encoded unless `isEnabled(level)`. Throttled as a call site
+  /// shared by every `logf()` with the same `Format` and argument types.
+  template <FixedString Format, DeferredArgument... Args>
+  void logf(Level level, const Args &...args) {
+    logf<Format>(detail::callSiteFor<Format, detail::DecodedType<Args>...>,
+                 level, args...);
+  }
+
+  /// Log a deferred-format message at `level` from the call site `site`.
+  ///
+  /// Nothing is encoded unless `isEnabled(level)` and `site` is within the
+  /// logger's rate limit. Used by the `LOGGER_*F` macros.
+  template <FixedString Format, DeferredArgument... Args>
+  void logf(CallSite &site, Level level, const Args &...args) {
+    if (!isEnabled(level) || !limiter_.admit(site, noteWriter(level))) {
+      return;
+    }
+    if (const LogContext *context = LogContext::active()) {
+      detail::encodeDeferredInContext<Format>(deferredWriter(site, level),
+                                              context->text(), args...);
+    } else {
+      detail::encodeDeferred<Format>(deferredWriter(site, level), args...);
+    }
+    flushIfSevere(level);
+  }
+
+  /// Whether a message at `level` would be written.
+  ///
+  /// A single relaxed atomic load plus the compile-time threshold; callers may
+  /// use it to skip building expensive messages.
+  [[nodiscard]] auto isEnabled(Level level) const -> bool {
+    return isCompiledIn(level) &&
+           level >= level_.load(std::memory_order_relaxed);
+  }
+
+  /// Current runtime threshold.
+  [[nodiscard]] auto level() const -> Level {
+    return level_.load(std::memory_order_relaxed);
+  }
+
+  /// Change the runtime threshold; messages below `level` are discarded.
+  ///
+  /// Safe to call concurrently with logging. Levels below `CompiledMinLevel`
+  /// stay disabled whatever the threshold.
+  void setLevel(Level level) {
+    level_.store(level, std::memory_order_relaxed);
+  }
+
+  /// Messages at or above `level` are flushed before the call that logs
+  /// them returns, as if followed by `flush()`; `Level::Off` (the default)
+  /// flushes none.
+  ///
+  /// Keeps output buffered and batched in normal operation while making sure
+  /// the lines that matter (e.g. errors before a crash) reach the output.
+  /// Safe to call concurrently with logging.
+  void setFlushLevel(Level level) {
+    flushLevel_.store(level, std::memory_order_relaxed);
+  }
+
+  /// Current flush threshold; see `setFlushLevel()`.
+  [[nodiscard]] auto flushLevel() const -> Level {
+    return flushLevel_.load(std::memory_order_relaxed);
+  }
+
+  /// Block until every message logged on this thread before the call has
+  /// been written to the output.
+  ///
+  /// Asynchronous loggers wake their writer thread, which writes its partial
+  /// batch at once instead of waiting out `maxLatency`. The default
+  /// implementation does nothing, for loggers that write synchronously.
+  virtual void flush() {}
+
+  /// Call `done` once every message logged on this thread before the call
+  /// has been written to the output, without waiting for it.
+  ///
+  /// `done` is called on a thread of the logger or the library, or before
+  /// this returns if nothing is pending: keep it short, and do not flush
+  /// this logger from it. The logger must outlive the call. The default
+  /// implementation calls `flush()` on a background thread shared by every
+  /// logger; the asynchronous loggers call `done` from their writer thread
+  /// once the records are written, or, with a queue per thread, wait for
+  /// the calling thread's queue on the background thread.
+  virtual void flushThen(FlushCallback done) {
+    detail::flushInBackground(*this, std::move(done));
+  }
+
+  /// `flushThen()` as an awaitable, for coroutines that must not block their
+  /// thread while the records are written.
+  ///
+  /// ```cpp
+  /// co_await logger.flushAsync();
+  /// ```
+  ///
+  /// ## Parameters
+  /// - `schedule`: Resumes the coroutine, e.g. on its executor; if empty,
+  ///   the coroutine resumes on the library's background thread.
+  [[nodiscard]] auto flushAsync(CoroutineScheduler schedule = {})
+      -> FlushAwaiter;
+
+  /// Number of messages this logger has discarded instead of writing.
+  ///
+  /// Only loggers configured with a lossy overflow policy drop messages; the
+  /// default implementation returns 0.
+  [[nodiscard]] virtual auto droppedMessages() const -> std::uint64_t {
+    return 0;
+  }
+
+  /// What the logger has done so far: records, bytes and output operations
+  /// written, drops, queue high-water mark and delivery latency.
+  ///
+  /// Sums relaxed counters each writer thread keeps on its own cache line,
+  /// so keeping them costs the logging threads no contention; safe to call
+  /// from any thread at any time. The default implementation reports only
+  /// `droppedMessages()`; use a `StatsReporter` for periodic snapshots.
+  [[nodiscard]] virtual auto stats() const -> LoggerStats {
+    return {.dropped = droppedMessages()};
+  }
+
+protected:
+  /// Throttle call sites as `rateLimit`.
+  ///
+  /// ## Throws
+  /// `std::invalid_argument` if `rateLimit` is invalid; see `RateLimiter`.
+  explicit ILogger(const RateLimitConfig &rateLimit) : limiter_{rateLimit} {}
+
+  /// Write a message that has passed the level check.
+  ///
+  /// ## Parameters
+  /// - `level`: Severity of the message.
+  /// - `message`: The message to write. Must be valid UTF-8.
+  virtual void write(Level level, std::string_view message) = 0;
+
+  /// Write a record produced by `logf()` or a structured `log()` that has
+  /// passed the level check.
+  ///
+  /// The default implementation formats into a `StagingBuffer` on the calling
+  /// thread and forwards the text to `write()`. Asynchronous implementations
+  /// queue `args` as-is and call `format.format` on their writer thread
+  /// instead.
+  ///
+  /// ## Parameters
+  /// - `level`: Severity of the message.
+  /// - `format`: Call-site descriptor; valid for the life of the program.
+  /// - `args`: Encoded arguments; only valid for the duration of the call.
+  virtual void writeDeferred(Level level, const DeferredFormat &format,
+                             std::span<const std::byte> args) {
+    StagingBuffer text;
+    format.format(args, text.buffer());
+    write(level, text.view());
+  }
+
+  /// Hand a message that has passed this logger's checks to `target`'s
+  /// `write()`, bypassing `target`'s own threshold and rate limit but not
+  /// its `flushLevel()`; for loggers that front another.
+  static void forward(ILogger &target, Level level, std::string_view message) {
+    target.write(level, message);
+    target.flushIfSevere(level);
+  }
+
+  /// Hand a deferred record that has passed this logger's checks to
+  /// `target`'s `writeDeferred()`; see `forward(target, level, message)`.
+  static void forward(ILogger &target, Level level,
+                      const DeferredFormat &format,
+                      std::span<const std::byte> args) {
+    target.writeDeferred(level, format, args);
+    target.flushIfSevere(level);
+  }
+
+private:
+  /// Flush after a message at `level` if `setFlushLevel()` asks for it.
+  void flushIfSevere(Level level) {
+    if (level >= flushLevel_.load(std::memory_order_relaxed)) {
+      flush();
+    }
+  }
+
+  /// Writes the rate limiter's notes at `level`.
+  auto noteWriter(Level level) {
+    return [this, level](std::string_view note) { write(level, note); };
+  }
+
+  /// Encode `message` and `fields`, and the pairs of the active
+  /// `LogContext` if any, and hand the record to `write`.
+  template <typename Write, DeferredArgument... Values>
+  static void encodeMessage(const Write &write, std::string_view message,
+                            const Field<Values> &...fields) {
+    if (const LogContext *context = LogContext::active()) {
+      detail::encodeStructuredInContext(write, context->fields(), message,
+                                        fields...);
+    } else {
+      detail::encodeStructured(write, message, fields...);
+    }
+  }
+
+  /// The `write` callback of `detail::encodeStructured()`.
+  auto deferredWriter(Level level) {
+    return [this, level](const DeferredFormat &format,
+                         std::span<const std::byte> bytes) {
+      writeDeferred(level, format, bytes);
+    };
+  }
+
+  /// Whether a message from `site` is not a repeat to collapse; see
+  /// `RateLimiter::isFresh()`.
+  auto isFresh(CallSite &site, Level level, const void *key,
+               std::span<const std::byte> bytes) -> bool {
+    return !limiter_.collapsesRepeats() ||
+           limiter_.isFresh(site, RateLimiter::digestOf(level, key, bytes),
+                            noteWriter(level));
+  }
+
+  /// The `write` callback of `detail::encodeDeferred()` for `site`.
+  auto deferredWriter(CallSite &site, Level level) {
+    return [this, &site, level](const DeferredFormat &format,
+                                std::span<const std::byte> bytes) {
+      if (isFresh(site, level, &format, bytes)) {
+        writeDeferred(level, format, bytes);
+      }
+    };
+  }
+
+  std::atomic<Level> level_{CompiledMinLevel};
+  std::atomic<Level> flushLevel_{Level::Off};
+  RateLimiter limiter_;
+};
+
+/// What `co_await logger.flushAsync()` awaits; see `ILogger::flushAsync()`.
+class FlushAwaiter {
+public:
+  FlushAwaiter(ILogger &logger, CoroutineScheduler schedule)
+      : logger_{logger}, schedule_{std::move(schedule)} {}
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+
+  void await_suspend(std::coroutine_handle<> coroutine) {
+    // The callback may resume the coroutine, ending this awaiter, before
+    // `flushThen()` returns.
+    logger_.flushThen(
+        [coroutine, schedule = std::move(schedule_)]() mutable {
+          if (schedule) {
+            schedule(coroutine);
+          } else {
+            detail::resumeInBackground(coroutine);
+          }
+        });
+  }
+
+  void await_resume() const noexcept {}
+
+private:
+  ILogger &logger_;
+  CoroutineScheduler schedule_;
 };
 
+inline auto ILogger::flushAsync(CoroutineScheduler schedule) -> FlushAwaiter {
+  return {*this, std::move(schedule)};
+}
+
 } // namespace sample::logger
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace sample::logger {
+
+/// One key/value pair of a `LogContext`.
+struct ContextField {
+  std::string key;
+  std::string value;
+};
+
+class LogContext;
+
+namespace detail {
+
+/// The context of the task running on this thread; see `LogContext`.
+inline thread_local const LogContext *currentLogContext = nullptr;
+
+} // namespace detail
+
+/// Key/value pairs, such as a request and a trace id, that every record
+/// logged while they are current carries.
+///
+/// A context is made current on a thread by a `ScopedLogContext`, or for
+/// the life of a coroutine whose promise derives from `LogContextPromise`,
+/// which reinstalls it each time the coroutine resumes, on whichever thread.
+/// Loggers look the current context up with one thread-local load per
+/// record, and add its pairs to each record they write: as fields of plain
+/// and structured `log()` records, and for `logf()` as ` key=value` text
+/// after the formatted message.
+///
+/// ```cpp
+/// logger::LogContext context;
+/// context.set("request_id", id);
+/// const logger::ScopedLogContext scope{context};
+/// logger.log("accepted"); // accepted request_id=...
+/// ```
+class LogContext {
+public:
+  /// Most pairs a context holds.
+  static constexpr std::size_t MaxFields = 4;
+
+  /// Set `key` to `value`, adding the pair if `key` is new.
+  ///
+  /// ## Throws
+  /// `std::invalid_argument` if `key` is empty, and `std::length_error` if
+  /// the context already holds `MaxFields` other keys.
+  void set(std::string_view key, std::string_view value);
+
+  /// Remove `key`, if present.
+  void erase(std::string_view key);
+
+  /// The pairs, in the order their keys were first set.
+  [[nodiscard]] auto fields() const -> std::span<const ContextField> {
+    return {fields_.data(), size_};
+  }
+
+  /// Whether the context holds no pairs.
+  [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+
+  /// The pairs as ` key=value` logfmt text, as appended to `logf()` records.
+  [[nodiscard]] auto text() const -> std::string_view { return text_; }
+
+  /// The context current on this thread, or null if there is none or it
+  /// is empty.
+  [[nodiscard]] static auto active() -> const LogContext * {
+    const LogContext *context = detail::currentLogContext;
+    return context != nullptr && !context->empty() ? context : nullptr;
+  }
+
+private:
+  /// Rebuild `text_` from the pairs.
+  void render();
+
+  std::array<ContextField, MaxFields> fields_{};
+  std::size_t size_ = 0;
+  std::string text_;
+};
+
+/// Makes a `LogContext` current on this thread until destroyed, then
+/// restores the one it replaced.
+///
+/// For code that is not a coroutine, or a coroutine that does not suspend
+/// while the guard lives: a coroutine that may resume on another thread
+/// needs a `LogContextPromise` instead.
+class ScopedLogContext {
+public:
+  /// Make `context`, which must outlive the guard, current.
+  explicit ScopedLogContext(const LogContext &context)
+      : outer_{std::exchange(detail::currentLogContext, &context)} {}
+
+  ~ScopedLogContext() { detail::currentLogContext = outer_; }
+
+  ScopedLogContext(const ScopedLogContext &) = delete;
+  auto operator=(const ScopedLogContext &) -> ScopedLogContext & = delete;
+  ScopedLogContext(ScopedLogContext &&) = delete;
+  auto operator=(ScopedLogContext &&) -> ScopedLogContext & = delete;
+
+private:
+  const LogContext *outer_;
+};
+
+namespace detail {
+
+/// The awaiter `co_await` obtains from `awaitable`: the result of its
+/// `operator co_await`, if it has one, or `awaitable` itself, moved from if
+/// an rvalue so that it may outlive the expression.
+template <typename Awaitable>
+auto awaiterOf(Awaitable &&awaitable) -> decltype(auto) {
+  if constexpr (requires {
+                  std::forward<Awaitable>(awaitable).operator co_await();
+                }) {
+    return std::forward<Awaitable>(awaitable).operator co_await();
+  } else if constexpr (requires {
+                         operator co_await(
+                             std::forward<Awaitable>(awaitable));
+                       }) {
+    return operator co_await(std::forward<Awaitable>(awaitable));
+  } else {
+    return static_cast<Awaitable>(std::forward<Awaitable>(awaitable));
+  }
+}
+
+} // namespace detail
+
+/// Base for coroutine promise types whose coroutines carry a `LogContext`.
+///
+/// The context starts as a copy of the one active where the coroutine is
+/// created, so a task started from a request handler inherits its request
+/// id; `logContext()` changes it. It is current on a thread from each time
+/// the coroutine starts or resumes there until it next suspends, whatever
+/// thread resumes it: `await_transform()` wraps every `co_await` in the
+/// coroutine. The promise type wraps the awaitables of its own suspension
+/// points too:
+///
+/// ```cpp
+/// struct promise_type : logger::LogContextPromise {
+///   auto initial_suspend() { return inContext(std::suspend_always{}); }
+///   auto final_suspend() noexcept { return leavingContext(Final{}); }
+///   auto yield_value(T v) { ...; return inContext(std::suspend_always{}); }
+///   ...
+/// };
+/// ```
+class LogContextPromise {
+public:
+  LogContextPromise() {
+    if (const LogContext *context = LogContext::active()) {
+      context_ = *context;
+    }
+  }
+
+  /// The coroutine's context; may be changed from within the coroutine.
+  [[nodiscard]] auto logContext() -> LogContext & { return context_; }
+
+  /// Awaits `awaitable` with the context current until the coroutine
+  /// suspends, and again once it resumes.
+  template <typename Awaitable>
+  auto inContext(Awaitable &&awaitable) {
+    return Awaiter<decltype(detail::awaiterOf(
+        std::forward<Awaitable>(awaitable)))>{
+        *this, detail::awaiterOf(std::forward<Awaitable>(awaitable))};
+  }
+
+  /// Awaits the final suspension point's `awaitable`, the context no
+  /// longer current.
+  template <typename Awaitable>
+  auto leavingContext(Awaitable &&awaitable) noexcept {
+    return FinalAwaiter<decltype(detail::awaiterOf(
+        std::forward<Awaitable>(awaitable)))>{
+        *this, detail::awaiterOf(std::forward<Awaitable>(awaitable))};
+  }
+
+  /// Every `co_await` in the coroutine is `inContext()`.
+  template <typename Awaitable>
+  auto await_transform(Awaitable &&awaitable) {
+    return inContext(std::forward<Awaitable>(awaitable));
+  }
+
+private:
+  template <typename Inner> struct Awaiter {
+    LogContextPromise &promise;
+    Inner inner;
+
+    auto await_ready() -> bool { return inner.await_ready(); }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> coroutine)
+        -> decltype(auto) {
+      // Once `inner` has the handle the coroutine may run elsewhere, and
+      // even be destroyed, so it leaves this thread first.
+      promise.leave();
+      try {
+        return inner.await_suspend(coroutine);
+      } catch (...) {
+        promise.enter();
+        throw;
+      }
+    }
+
+    auto await_resume() -> decltype(auto) {
+      promise.enter();
+      return inner.await_resume();
+    }
+  };
+
+  template <typename Inner> struct FinalAwaiter {
+    LogContextPromise &promise;
+    Inner inner;
+
+    auto await_ready() noexcept -> bool {
+      promise.leave();
+      return inner.await_ready();
+    }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> coroutine) noexcept
+        -> decltype(auto) {
+      return inner.await_suspend(coroutine);
+    }
+
+    void await_resume() noexcept { inner.await_resume(); }
+  };
+
+  /// Make the context current on this thread, unless it already is: an
+  /// awaitable that is ready resumes without the coroutine having left.
+  void enter() {
+    if (!entered_) {
+      outer_ = std::exchange(detail::currentLogContext, &context_);
+      entered_ = true;
+    }
+  }
+
+  /// Restore this thread's context from before `enter()`.
+  void leave() noexcept {
+    if (entered_) {
+      detail::currentLogContext = outer_;
+      entered_ = false;
+    }
+  }
+
+  LogContext context_;
+  const LogContext *outer_ = nullptr;
+  bool entered_ = false;
+};
+
+} // namespace sample::logger
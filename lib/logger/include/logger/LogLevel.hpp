@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/// Lowest level compiled into the `LOGGER_*` macros, as a `Level` value.
+///
+/// Set by the `LOGGER_MIN_LEVEL` CMake option; statements below it are
+/// discarded at compile time. Defaults to 0 (`Level::Trace`).
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
+
+namespace sample::logger {
+
+/// Severity of a log message, in increasing order.
+enum class Level : std::uint8_t {
+  Trace,
+  Debug,
+  Info,
+  Warning,
+  Error,
+  Critical,
+  /// Not a message severity: as a threshold, disables all logging.
+  Off,
+};
+
+/// Lowest level that survives compile-time filtering.
+inline constexpr Level CompiledMinLevel = static_cast<Level>(LOGGER_MIN_LEVEL);
+
+/// Whether statements at `level` are compiled in at all.
+[[nodiscard]] constexpr auto isCompiledIn(Level level) -> bool {
+  return level >= CompiledMinLevel && level != Level::Off;
+}
+
+/// Upper-case name of `level` (e.g. `"WARNING"`).
+[[nodiscard]] constexpr auto toString(Level level) -> std::string_view {
+  switch (level) {
+  case Level::Trace:
+    return "TRACE";
+  case Level::Debug:
+    return "DEBUG";
+  case Level::Info:
+    return "INFO";
+  case Level::Warning:
+    return "WARNING";
+  case Level::Error:
+    return "ERROR";
+  case Level::Critical:
+    return "CRITICAL";
+  case Level::Off:
+    return "OFF";
+  }
+  return "UNKNOWN";
+}
+
+/// The level `name` spells, ignoring ASCII case (e.g. `"warning"`), or
+/// nothing if it is not a level name of `toString()`.
+[[nodiscard]] constexpr auto parseLevel(std::string_view name)
+    -> std::optional<Level> {
+  const auto sameLetter = [](char given, char upper) {
+    return (given >= 'a' && given <= 'z' ? given - 'a' + 'A' : given) ==
+           upper;
+  };
+  for (int value = 0; value <= static_cast<int>(Level::Off); ++value) {
+    const auto level = static_cast<Level>(value);
+    if (std::ranges::equal(name, toString(level), sameLetter)) {
+      return level;
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace sample::logger
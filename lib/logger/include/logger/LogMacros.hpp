@@ -0,0 +1,87 @@
+#pragma once
+
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+
+/// Log `message` to `loggerObj` at compile-time constant `level`.
+///
+/// Below `LOGGER_MIN_LEVEL` the statement is discarded at compile time:
+/// `message` is not evaluated and no call is made. Otherwise the runtime
+/// threshold is checked before `message` is evaluated. Each expansion is its
+/// own `CallSite` for the logger's rate limit.
+///
+/// ## Parameters
+/// - `loggerObj`: A `Logger` lvalue, such as an `ILogger` (e.g. `*loggerPtr`)
+///   or a `BasicLogger`; evaluated once.
+/// - `level`: A constant `sample::logger::Level`.
+/// - `message`: Anything convertible to `std::string_view`.
+/// - `...`: Optional `field()`s for a structured message; not evaluated when
+///   filtered.
+#define LOGGER_LOG(loggerObj, level, message, ...)                             \
+  do {                                                                         \
+    if constexpr (::sample::logger::isCompiledIn(level)) {                     \
+      if (auto &sampleLoggerRef_ = (loggerObj);                                \
+          sampleLoggerRef_.isEnabled(level)) {                                 \
+        static ::sample::logger::CallSite sampleLoggerSite_;                   \
+        sampleLoggerRef_.log(sampleLoggerSite_, level,                         \
+                             message __VA_OPT__(, ) __VA_ARGS__);              \
+      }                                                                        \
+    }                                                                          \
+  } while (false)
+
+/// Deferred-format counterpart of `LOGGER_LOG`; see `ILogger::logf()`.
+///
+/// ## Parameters
+/// - `loggerObj`: A `Logger` lvalue; evaluated once.
+/// - `level`: A constant `sample::logger::Level`.
+/// - `format`: A string literal `fmt` format string.
+/// - `...`: Arguments referenced by `format`; not evaluated when filtered.
+#define LOGGER_LOGF(loggerObj, level, format, ...)                             \
+  do {                                                                         \
+    if constexpr (::sample::logger::isCompiledIn(level)) {                     \
+      if (auto &sampleLoggerRef_ = (loggerObj);                                \
+          sampleLoggerRef_.isEnabled(level)) {                                 \
+        static ::sample::logger::CallSite sampleLoggerSite_;                   \
+        sampleLoggerRef_.template logf<format>(                                \
+            sampleLoggerSite_, level __VA_OPT__(, ) __VA_ARGS__);              \
+      }                                                                        \
+    }                                                                          \
+  } while (false)
+
+#define LOGGER_TRACE(loggerObj, message, ...)                                  \
+  LOGGER_LOG(loggerObj, ::sample::logger::Level::Trace,                        \
+             message __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_DEBUG(loggerObj, message, ...)                                  \
+  LOGGER_LOG(loggerObj, ::sample::logger::Level::Debug,                        \
+             message __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_INFO(loggerObj, message, ...)                                   \
+  LOGGER_LOG(loggerObj, ::sample::logger::Level::Info,                         \
+             message __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_WARNING(loggerObj, message, ...)                                \
+  LOGGER_LOG(loggerObj, ::sample::logger::Level::Warning,                      \
+             message __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_ERROR(loggerObj, message, ...)                                  \
+  LOGGER_LOG(loggerObj, ::sample::logger::Level::Error,                        \
+             message __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_CRITICAL(loggerObj, message, ...)                               \
+  LOGGER_LOG(loggerObj, ::sample::logger::Level::Critical,                     \
+             message __VA_OPT__(, ) __VA_ARGS__)
+
+#define LOGGER_TRACEF(loggerObj, format, ...)                                  \
+  LOGGER_LOGF(loggerObj, ::sample::logger::Level::Trace,                       \
+              format __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_DEBUGF(loggerObj, format, ...)                                  \
+  LOGGER_LOGF(loggerObj, ::sample::logger::Level::Debug,                       \
+              format __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_INFOF(loggerObj, format, ...)                                   \
+  LOGGER_LOGF(loggerObj, ::sample::logger::Level::Info,                        \
+              format __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_WARNINGF(loggerObj, format, ...)                                \
+  LOGGER_LOGF(loggerObj, ::sample::logger::Level::Warning,                     \
+              format __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_ERRORF(loggerObj, format, ...)                                  \
+  LOGGER_LOGF(loggerObj, ::sample::logger::Level::Error,                       \
+              format __VA_OPT__(, ) __VA_ARGS__)
+#define LOGGER_CRITICALF(loggerObj, format, ...)                               \
+  LOGGER_LOGF(loggerObj, ::sample::logger::Level::Critical,                    \
+              format __VA_OPT__(, ) __VA_ARGS__)
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <logger/LogLevel.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace sample::logger {
+
+/// One record handed to a `LogTap` or read from a `TapRing`.
+struct TapRecord {
+  /// Severity of the record.
+  Level level = Level::Info;
+
+  /// The record as encoded for the output: a text line with its newline,
+  /// or with `OutputFormat::Binary` the frames `BinaryLogDecoder` reads,
+  /// including the definition of a `logf()` call site the first time it is
+  /// logged. A binary logger's first record is the session header, at
+  /// `Level::Off`, so the records decode in order as they arrive.
+  std::span<const std::byte> bytes{};
+};
+
+/// Receives every batch of records an asynchronous logger writes, on the
+/// backend thread, just before the batch goes to the output.
+///
+/// `records` point into the backend's own batch buffer and are only valid
+/// for the duration of the call: nothing is copied or reformatted for the
+/// tap. It must be quick, as the backend waits for it, and must not log to
+/// the same logger. With `QueueMode::PerThread` it may be called from
+/// several backend threads at once. Exceptions it throws are ignored.
+using LogTap = std::function<void(std::span<const TapRecord> records)>;
+
+/// A ring of records in shared memory, filled by a `LogTap` and read by a
+/// `TapReader` in this or another process.
+///
+/// The ring lives in an anonymous `memfd`; hand `fd()` to a log shipper
+/// (over a Unix socket with `SCM_RIGHTS`, by inheritance, or as
+/// `/proc/<pid>/fd/<fd>`) and it maps the records without a pipe or a
+/// parse. The logger never waits for the reader: records that do not fit
+/// are dropped and counted.
+///
+/// ```cpp
+/// logger::TapRing ring{1 << 20};
+/// auto log = logger::createAsyncLogger({.tap = ring.tap()});
+/// ```
+class TapRing {
+public:
+  /// Create a ring with room for `capacity` bytes of records.
+  ///
+  /// ## Throws
+  /// - `std::invalid_argument` if `capacity` is not a power of two of at
+  ///   least 4096.
+  /// - `std::system_error` if the memory cannot be created or mapped.
+  explicit TapRing(std::size_t capacity);
+
+  /// Unmap and close the ring; readers that mapped it keep their mapping.
+  ~TapRing();
+
+  TapRing(const TapRing &) = delete;
+  auto operator=(const TapRing &) -> TapRing & = delete;
+  TapRing(TapRing &&) = delete;
+  auto operator=(TapRing &&) -> TapRing & = delete;
+
+  /// The `memfd` holding the ring, for a `TapReader`. Owned by the ring.
+  [[nodiscard]] auto fd() const -> int { return fd_; }
+
+  /// Copy `records` into the ring and publish them together, dropping
+  /// those that do not fit. Thread-safe.
+  void publish(std::span<const TapRecord> records);
+
+  /// A tap publishing into this ring, which must outlive the logger.
+  [[nodiscard]] auto tap() -> LogTap {
+    return [this](std::span<const TapRecord> records) { publish(records); };
+  }
+
+  /// Records dropped because the reader had not made room for them.
+  [[nodiscard]] auto dropped() const -> std::uint64_t;
+
+private:
+  int fd_;
+  std::byte *memory_;
+  std::size_t capacity_;
+  std::mutex mutex_;
+};
+
+/// Reads the records of a `TapRing`, in this or another process.
+///
+/// Records are returned in the order the ring received them, as spans into
+/// the shared mapping. A ring has a single reader.
+class TapReader {
+public:
+  /// Map the ring in `fd`, a descriptor for a `TapRing::fd()`; `fd` may be
+  /// closed afterwards.
+  ///
+  /// ## Throws
+  /// - `std::invalid_argument` if `fd` does not hold a tap ring.
+  /// - `std::system_error` if it cannot be mapped.
+  explicit TapReader(int fd);
+
+  ~TapReader();
+
+  TapReader(const TapReader &) = delete;
+  auto operator=(const TapReader &) -> TapReader & = delete;
+  TapReader(TapReader &&) = delete;
+  auto operator=(TapReader &&) -> TapReader & = delete;
+
+  /// The next record, or nothing if the ring is empty.
+  ///
+  /// The record stays valid until the next call, which hands its space
+  /// back to the ring.
+  [[nodiscard]] auto next() -> std::optional<TapRecord>;
+
+  /// Records the ring has dropped so far; see `TapRing::dropped()`.
+  [[nodiscard]] auto dropped() const -> std::uint64_t;
+
+private:
+  std::byte *memory_;
+  std::size_t mappedBytes_;
+  std::size_t capacity_;
+  std::uint64_t read_ = 0;
+  std::size_t held_ = 0;
+};
+
+} // namespace sample::logger
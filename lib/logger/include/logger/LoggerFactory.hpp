@@ -1,5 +1,11 @@
 #pragma once
 
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/MappedFileLoggerConfig.hpp>
+#include <logger/RateLimit.hpp>
+#include <logger/UringLoggerConfig.hpp>
+
 #include <memory>
 
 namespace sample::logger {
@@ -8,11 +14,151 @@ class ILogger;
 
 /// Create a default console logger.
 ///
+/// ## Parameters
+/// - `rateLimit`: Per-call-site throttling; see `RateLimitConfig`.
+///
+/// ## Returns
+/// A unique pointer to an ILogger implementation. Never returns nullptr.
+///
+/// ## Throws
+/// - `std::invalid_argument` if `rateLimit.burst` is 0 while
+///   `rateLimit.messagesPerSecond` is set.
+/// - `std::runtime_error` if logger creation fails (rare).
+[[nodiscard]] auto createDefaultLogger(const RateLimitConfig &rateLimit = {})
+    -> std::unique_ptr<ILogger>;
+
+/// Create an asynchronous file logger that writes through Linux `io_uring`.
+///
+/// Queues, batches and formats like `createAsyncLogger()`, but the backend
+/// thread never blocks in `write(2)` or `fsync(2)`: each batch is formatted
+/// into one of `config.queueDepth` buffers registered with the kernel and
+/// submitted as a write at its own offset in `config.filePath`, and the
+/// thread goes on with the next batch while the kernel writes it. A
+/// `fdatasync` is queued behind the writes at most once per
+/// `config.syncInterval`. The thread waits only once every buffer is in
+/// flight, or when `flush()` asks for the records to be written.
+///
+/// On kernels without `io_uring`, or where it is disabled, the logger falls
+/// back to `pwrite(2)` and `fdatasync(2)` on the backend thread. Destroying
+/// the logger writes every queued record and syncs the file before
+/// returning. The ring and the buffers are set up by the first record, as
+/// for `createAsyncLogger()`.
+///
+/// ## Parameters
+/// - `config`: The queue settings, the file and the ring; see
+///   `UringLoggerConfig`.
+///
+/// ## Returns
+/// A unique pointer to an ILogger implementation. Never returns nullptr.
+///
+/// ## Throws
+/// - `std::invalid_argument` if `config.queue` is invalid (as for
+///   `createAsyncLogger()`) or asks for per-thread queues or compression,
+///   `config.queueDepth` is 0 or over 4096, or `config.syncInterval` is
+///   negative.
+/// - `std::system_error` if the log file cannot be opened.
+[[nodiscard]] auto createUringFileLogger(const UringLoggerConfig &config)
+    -> std::unique_ptr<ILogger>;
+
+/// Create an asynchronous logger writing to a file descriptor.
+///
+/// `log()` copies the message into a bounded lock-free ring and returns; a
+/// dedicated background thread drains the ring and writes to
+/// `config.target`, coalescing queued messages into batches of up to
+/// `config.maxBatchBytes` so that each batch costs one `write(2)`. Messages
+/// from a single thread are written in the order they were logged. Destroying
+/// the logger writes every queued message before returning.
+///
+/// With `QueueMode::PerThread` each producer thread gets its own ring on its
+/// first message and `config.backendThreads` threads drain them.
+/// `config.backendCpus`, `config.backendPerNode` and
+/// `config.nodeLocalQueues` keep the background threads and the rings on
+/// the CPUs and NUMA nodes of the producers.
+///
+/// When the ring is full, `config.overflowPolicy` decides whether the caller
+/// waits or a message is discarded; see `OverflowPolicy`. With
+/// `config.compression` the backends compress each batch before writing it.
+///
+/// Only the output is opened here: the ring, the batch buffer and the
+/// background threads are set up by the first message, so a logger that is
+/// never used costs no thread. If a thread cannot be started then, that
+/// call throws `std::system_error` and a later one tries again.
+///
+/// ## Parameters
+/// - `config`: Queue sizing, overflow behaviour, output target and batching;
+///   see `AsyncLoggerConfig`.
+///
+/// ## Returns
+/// A unique pointer to an ILogger implementation. Never returns nullptr.
+///
+/// ## Throws
+/// - `std::invalid_argument` if `config.capacity` is less than 2,
+///   `config.sampleRate`, `config.maxBatchBytes` or `config.backendThreads`
+///   is 0, `config.maxLatency` is negative, `config.backendThreads` is not 1
+///   or `config.backendPerNode` or `config.nodeLocalQueues` is set with
+///   `QueueMode::Shared`, `config.backendCpus` names a CPU the process may
+///   not run on or is combined with `config.backendPerNode`, or
+///   `config.rateLimit.burst` is 0 while `config.rateLimit.messagesPerSecond`
+///   is set.
+/// - `std::system_error` if the log file cannot be opened.
+[[nodiscard]] auto createAsyncLogger(const AsyncLoggerConfig &config = {})
+    -> std::unique_ptr<ILogger>;
+
+/// Create an asynchronous logger that writes every record to several
+/// destinations.
+///
+/// Queues, batches and formats like `createAsyncLogger()`, but each record
+/// is formatted exactly once, into a batch shared read-only by every
+/// destination in `config.targets`; each writes the records at or above its
+/// own `minLevel` with one `writev(2)` per batch. A destination with
+/// `ownThread` gets a background thread of its own, so a slow one only
+/// delays the others once `config.maxPendingBatches` batches are waiting for
+/// it. Destroying the logger writes every queued record to every
+/// destination before returning. Threads start with the first record, as
+/// for `createAsyncLogger()`.
+///
+/// ## Parameters
+/// - `config`: The shared queue settings and the destinations; see
+///   `FanOutLoggerConfig`.
+///
+/// ## Returns
+/// A unique pointer to an ILogger implementation. Never returns nullptr.
+///
+/// ## Throws
+/// - `std::invalid_argument` if `config.queue` is invalid (as for
+///   `createAsyncLogger()`), asks for binary output, per-thread queues or
+///   compression, `config.targets` is empty, or `config.maxPendingBatches`
+///   is 0.
+/// - `std::system_error` if a log file cannot be opened.
+[[nodiscard]] auto createFanOutLogger(const FanOutLoggerConfig &config)
+    -> std::unique_ptr<ILogger>;
+
+/// Create a logger that writes into memory-mapped, rotating segment files.
+///
+/// Each segment is preallocated to `config.segmentSize` bytes and mapped, so
+/// `log()` reserves space and copies the message without a system call. When
+/// a segment fills up, the next one, already prepared by a background thread,
+/// takes over and the full segment is trimmed to its contents and closed.
+/// Destroying the logger trims and closes the active segment.
+///
+/// While the logger is alive, the active segment still has its preallocated
+/// size: the bytes after the last message read as zeros.
+///
+/// ## Parameters
+/// - `config`: Location, naming and size of the segments; see
+///   `MappedFileLoggerConfig`.
+///
 /// ## Returns
 /// A unique pointer to an ILogger implementation. Never returns nullptr.
 ///
 /// ## Throws
-/// `std::runtime_error` if logger creation fails (rare).
-[[nodiscard]] auto createDefaultLogger() -> std::unique_ptr<ILogger>;
+/// - `std::invalid_argument` if `config.segmentSize` is less than 4096,
+///   `config.baseName` is empty, or `config.rateLimit.burst` is 0 while
+///   `config.rateLimit.messagesPerSecond` is set.
+/// - `std::system_error` (including `std::filesystem::filesystem_error`) if
+///   the directory or the first segment cannot be created, or the background
+///   thread cannot be started.
+[[nodiscard]] auto createMappedFileLogger(const MappedFileLoggerConfig &config)
+    -> std::unique_ptr<ILogger>;
 
 } // namespace sample::logger
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sample::logger {
+
+/// Named loggers sharing one output, each with a runtime level of its own.
+///
+/// `get("net.http")` returns the logger of one module; every named logger
+/// writes to the registry's `output`, but filters by its own level first,
+/// so checking it stays the single relaxed atomic load of
+/// `ILogger::isEnabled()`. Levels follow the dotted names: `setLevel("net",
+/// Level::Debug)` applies to `"net"`, `"net.http"` and every other logger
+/// below `"net"` without a level of its own, now and when they are created.
+/// The empty name is the root, which starts at `output`'s level.
+///
+/// Looking up an existing logger takes no lock, and levels change without
+/// one on the logging path: only creating loggers and changing levels
+/// serialise, with each other. Callers normally keep the reference `get()`
+/// returns.
+///
+/// ```cpp
+/// logger::LoggerRegistry loggers{logger::createAsyncLogger()};
+/// logger::ILogger &http = loggers.get("net.http");
+/// loggers.setLevels("warning,net=debug");
+/// ```
+class LoggerRegistry {
+public:
+  /// Create a registry whose loggers write to `output`.
+  ///
+  /// `output`'s own threshold and rate limit are bypassed: the named
+  /// loggers' levels decide.
+  ///
+  /// ## Throws
+  /// `std::invalid_argument` if `output` is null.
+  explicit LoggerRegistry(std::shared_ptr<ILogger> output);
+
+  ~LoggerRegistry();
+
+  LoggerRegistry(const LoggerRegistry &) = delete;
+  auto operator=(const LoggerRegistry &) -> LoggerRegistry & = delete;
+  LoggerRegistry(LoggerRegistry &&) = delete;
+  auto operator=(LoggerRegistry &&) -> LoggerRegistry & = delete;
+
+  /// The logger named `name`, created on first use with the level of its
+  /// nearest configured ancestor. Valid for the life of the registry.
+  /// Thread-safe.
+  ///
+  /// ## Throws
+  /// `std::bad_alloc` if a new logger cannot be allocated.
+  [[nodiscard]] auto get(std::string_view name) -> ILogger &;
+
+  /// Set the level of `name` and of the loggers below it that have no level
+  /// of their own. Thread-safe.
+  void setLevel(std::string_view name, Level level);
+
+  /// Forget the level set for `name`, which then follows its ancestors
+  /// again; the root keeps its level. Thread-safe.
+  void clearLevel(std::string_view name);
+
+  /// Apply a comma-separated list of `name=level` settings, and a bare
+  /// `level` for the root, e.g. `"warning,net=debug,net.http=trace"`.
+  /// Level names are those of `parseLevel()`. Thread-safe.
+  ///
+  /// ## Throws
+  /// `std::invalid_argument` if an entry is malformed; nothing is applied
+  /// then.
+  void setLevels(std::string_view spec);
+
+  /// The level a logger named `name` has, or would be created with.
+  [[nodiscard]] auto level(std::string_view name) const -> Level;
+
+  /// Names of the loggers created so far, in no particular order.
+  [[nodiscard]] auto names() const -> std::vector<std::string>;
+
+private:
+  struct Entry;
+
+  /// The logger named `name`, if it exists; lock-free.
+  [[nodiscard]] auto find(std::string_view name) const -> Entry *;
+
+  /// Level of `name` under the current settings; needs `mutex_`.
+  [[nodiscard]] auto effectiveLevel(std::string_view name) const -> Level;
+
+  /// Reapply the settings to the loggers below `name`; needs `mutex_`.
+  void refresh(std::string_view name);
+
+  std::shared_ptr<ILogger> output_;
+  mutable std::mutex mutex_;
+  std::map<std::string, Level, std::less<>> levels_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+  std::atomic<Entry *> first_{nullptr};
+};
+
+} // namespace sample::logger
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <thread>
+
+namespace sample::logger {
+
+class ILogger;
+
+/// Histogram of durations with HDR-style log-linear buckets.
+///
+/// Values below `SubBuckets` nanoseconds get a bucket each; above that every
+/// power of two is split into `SubBuckets` equal buckets, so any recorded
+/// value is known to within 1/`SubBuckets` (about 6%) across the whole
+/// 64-bit range, in a fixed `BucketCount` counters.
+class LatencyHistogram {
+public:
+  /// Buckets per power of two.
+  static constexpr std::size_t SubBuckets = 16;
+
+  /// Number of buckets covering every `std::uint64_t` nanosecond value.
+  static constexpr std::size_t BucketCount =
+      SubBuckets * (64 - std::countr_zero(SubBuckets) + 1);
+
+  /// Index of the bucket holding `nanos`.
+  [[nodiscard]] static constexpr auto bucketOf(std::uint64_t nanos)
+      -> std::size_t {
+    if (nanos < SubBuckets) {
+      return static_cast<std::size_t>(nanos);
+    }
+    const auto shift =
+        static_cast<std::size_t>(std::bit_width(nanos)) - SubBucketBits - 1;
+    return SubBuckets * (shift + 1) +
+           static_cast<std::size_t>((nanos >> shift) - SubBuckets);
+  }
+
+  /// Smallest value, in nanoseconds, held by bucket `bucket`.
+  [[nodiscard]] static constexpr auto lowerBound(std::size_t bucket)
+      -> std::uint64_t {
+    if (bucket < SubBuckets) {
+      return bucket;
+    }
+    const std::size_t shift = bucket / SubBuckets - 1;
+    return (SubBuckets + bucket % SubBuckets) << shift;
+  }
+
+  /// Largest value, in nanoseconds, held by bucket `bucket`.
+  [[nodiscard]] static constexpr auto upperBound(std::size_t bucket)
+      -> std::uint64_t {
+    return bucket + 1 == BucketCount
+               ? std::numeric_limits<std::uint64_t>::max()
+               : lowerBound(bucket + 1) - 1;
+  }
+
+  /// Count `count` occurrences of `duration`.
+  void record(std::chrono::nanoseconds duration, std::uint64_t count = 1) {
+    const auto nanos = static_cast<std::uint64_t>(
+        std::max(duration, std::chrono::nanoseconds::zero()).count());
+    addToBucket(bucketOf(nanos), count);
+  }
+
+  /// Add `count` occurrences to bucket `bucket`.
+  void addToBucket(std::size_t bucket, std::uint64_t count) {
+    counts_[bucket] += count;
+    total_ += count;
+  }
+
+  /// Add every count of `other`.
+  void merge(const LatencyHistogram &other) {
+    for (std::size_t bucket = 0; bucket < BucketCount; ++bucket) {
+      counts_[bucket] += other.counts_[bucket];
+    }
+    total_ += other.total_;
+  }
+
+  /// Number of recorded values.
+  [[nodiscard]] auto count() const -> std::uint64_t { return total_; }
+
+  /// Count of each bucket; see `lowerBound()` and `upperBound()`.
+  [[nodiscard]] auto buckets() const -> std::span<const std::uint64_t> {
+    return counts_;
+  }
+
+  /// The value at or below which `fraction` of the recorded values lie.
+  ///
+  /// Reports the upper bound of the bucket holding that value, so the true
+  /// value is overestimated by at most 1/`SubBuckets`.
+  ///
+  /// ## Parameters
+  /// - `fraction`: In [0, 1], e.g. 0.99 for the 99th percentile.
+  ///
+  /// ## Returns
+  /// The percentile, or zero if nothing was recorded.
+  [[nodiscard]] auto percentile(double fraction) const
+      -> std::chrono::nanoseconds {
+    if (total_ == 0) {
+      return std::chrono::nanoseconds::zero();
+    }
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(
+               std::clamp(fraction, 0.0, 1.0) *
+               static_cast<double>(total_)));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BucketCount; ++bucket) {
+      seen += counts_[bucket];
+      if (seen >= rank) {
+        constexpr auto Longest = static_cast<std::uint64_t>(
+            std::numeric_limits<std::int64_t>::max());
+        return std::chrono::nanoseconds{static_cast<std::int64_t>(
+            std::min(upperBound(bucket), Longest))};
+      }
+    }
+    return std::chrono::nanoseconds::max();
+  }
+
+private:
+  static constexpr std::size_t SubBucketBits = std::countr_zero(SubBuckets);
+
+  std::array<std::uint64_t, BucketCount> counts_{};
+  std::uint64_t total_ = 0;
+};
+
+/// What a logger has done since it was created; see `ILogger::stats()`.
+///
+/// Counters only grow. Loggers that lack a quantity (e.g. a queue) report 0.
+struct LoggerStats {
+  /// Records written to the output.
+  std::uint64_t records = 0;
+
+  /// Bytes written to the output, line terminators and binary framing
+  /// included, before any `AsyncLoggerConfig::compression`.
+  std::uint64_t bytes = 0;
+
+  /// Messages discarded instead of written; see `ILogger::droppedMessages()`.
+  std::uint64_t dropped = 0;
+
+  /// Most records seen waiting in a queue at once (in any one producer
+  /// thread's queue with `QueueMode::PerThread`).
+  std::uint64_t queueHighWater = 0;
+
+  /// Output operations: batches handed to `write(2)` by the asynchronous
+  /// loggers, segments completed by the memory-mapped file logger.
+  std::uint64_t flushes = 0;
+
+  /// Records longer than `AsyncLoggerConfig::inlineRecordBytes` queued in a
+  /// producer thread's record arena.
+  std::uint64_t arenaRecords = 0;
+
+  /// Records longer than `AsyncLoggerConfig::inlineRecordBytes` that did not
+  /// fit their arena and were copied to the heap instead.
+  std::uint64_t arenaFallbacks = 0;
+
+  /// CPU time used by the asynchronous loggers' backend threads, summed.
+  ///
+  /// Each backend samples its own after every batch, before it sleeps and,
+  /// while it polls, every few thousand polls, so the figure lags by at most
+  /// that much. Compare it with elapsed time to see what the
+  /// `AsyncLoggerConfig::waitStrategy` costs.
+  std::chrono::nanoseconds backendCpuTime{0};
+
+  /// Times a backend thread slept in the kernel waiting for records; always
+  /// 0 with `WaitStrategy::Spin` and `WaitStrategy::SpinYield`.
+  std::uint64_t backendSleeps = 0;
+
+  /// Time from each record's enqueue to the return of the write that
+  /// carried it. Filled by the asynchronous loggers with
+  /// `AsyncLoggerConfig::latencyHistogram` set; empty otherwise.
+  LatencyHistogram latency{};
+};
+
+/// Calls a callback with a logger's `stats()` at a fixed interval.
+///
+/// The callback runs on a thread owned by the reporter, first one interval
+/// after construction. The logger must outlive the reporter.
+class StatsReporter {
+public:
+  /// Receives each `stats()` snapshot.
+  using Callback = std::function<void(const LoggerStats &)>;
+
+  /// Start reporting `logger`'s statistics every `interval`.
+  ///
+  /// ## Throws
+  /// - `std::invalid_argument` if `interval` is not positive or `callback`
+  ///   is empty.
+  /// - `std::system_error` if the thread cannot be started.
+  StatsReporter(const ILogger &logger, std::chrono::milliseconds interval,
+                Callback callback);
+
+  /// Stop reporting; waits for a callback in progress to return.
+  ~StatsReporter();
+
+  StatsReporter(const StatsReporter &) = delete;
+  auto operator=(const StatsReporter &) -> StatsReporter & = delete;
+  StatsReporter(StatsReporter &&) = delete;
+  auto operator=(StatsReporter &&) -> StatsReporter & = delete;
+
+private:
+  void run();
+
+  const ILogger &logger_;
+  const std::chrono::milliseconds interval_;
+  const Callback callback_;
+  std::mutex mutex_;
+  std::condition_variable stopCv_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // namespace sample::logger
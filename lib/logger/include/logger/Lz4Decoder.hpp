@@ -0,0 +1,82 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+// liblz4's decompression context, which only the library's sources see.
+struct LZ4F_dctx_s;
+
+namespace sample::logger {
+
+/// Decompresses the output of a logger with `Compression::Lz4`.
+///
+/// Reads the standard LZ4 frame format with liblz4, so it also takes what
+/// `lz4` writes, and several frames one after the other, as an appended log
+/// file holds. The logger writes each batch as a block; when the process
+/// dies without closing its frame, the blocks it wrote still decode and a
+/// frame started after them is found. Checksums are verified. Feed the
+/// stream in chunks of any size:
+///
+/// ```cpp
+/// logger::Lz4Decoder decoder;
+/// const std::size_t used = decoder.decode(bytes, text);
+/// // Keep bytes[used..] and pass them again with the next chunk.
+/// ```
+///
+/// A `BinaryLogDecoder` given a compressed stream uses one of these itself.
+class Lz4Decoder {
+public:
+  /// ## Throws
+  /// `std::bad_alloc` if liblz4 cannot allocate its context.
+  Lz4Decoder();
+
+  /// Whether `input` starts with the magic number of an LZ4 frame.
+  [[nodiscard]] static auto startsFrame(std::span<const std::byte> input)
+      -> bool;
+
+  /// Decompress the complete headers and blocks at the start of `input`.
+  ///
+  /// Appends the decompressed bytes to `out`.
+  ///
+  /// ## Returns
+  /// Bytes consumed. The remainder is the start of an incomplete header or
+  /// block and should be passed again, followed by more data.
+  ///
+  /// ## Throws
+  /// `std::runtime_error` if the input is not LZ4 frames, needs a
+  /// dictionary, or is corrupt.
+  auto decode(std::span<const std::byte> input, fmt::memory_buffer &out)
+      -> std::size_t;
+
+private:
+  enum class State : std::uint8_t { Header, Blocks, Skip };
+
+  /// Decode the header, block or skipped bytes at the start of `input`.
+  ///
+  /// ## Returns
+  /// Bytes consumed; 0 if `input` holds only part of the next one.
+  auto decodeStep(std::span<const std::byte> input, fmt::memory_buffer &out)
+      -> std::size_t;
+
+  /// Have liblz4 decode `step`, a whole header, block or end mark.
+  void decompress(std::span<const std::byte> step, fmt::memory_buffer &out);
+
+  /// Frees the liblz4 context.
+  struct FreeContext {
+    void operator()(LZ4F_dctx_s *context) const noexcept;
+  };
+
+  std::unique_ptr<LZ4F_dctx_s, FreeContext> context_;
+  State state_ = State::Header;
+  std::uint64_t offset_ = 0;
+  std::size_t maxBlock_ = 0;
+  std::size_t blockChecksum_ = 0;
+  std::size_t contentChecksum_ = 0;
+  std::uint32_t skipping_ = 0;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <logger/RateLimit.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace sample::logger {
+
+/// Construction parameters for the memory-mapped rotating file logger.
+///
+/// Passed by value to `createMappedFileLogger()`. Segments are named
+/// `<directory>/<baseName>.<index>.log`, with a six-digit index that
+/// continues after the highest one already present in `directory`.
+struct MappedFileLoggerConfig {
+  /// Directory holding the segment files; created if it does not exist.
+  std::filesystem::path directory{"."};
+
+  /// File name prefix of every segment.
+  std::string baseName = "app";
+
+  /// Size each segment is preallocated to, in bytes. Must be at least 4096.
+  ///
+  /// A full segment is trimmed to the bytes actually written. A message is
+  /// truncated if it (with its line terminator) does not fit in one segment.
+  std::size_t segmentSize = 64 * 1024 * 1024;
+
+  /// Per-call-site throttling applied on the calling thread; off by default.
+  RateLimitConfig rateLimit{};
+};
+
+} // namespace sample::logger
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <logger/DeferredFormat.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/StagingBuffer.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace sample::logger {
+
+/// Per-call-site throttling of a logger; see `ILogger`.
+///
+/// Applies to the `LOGGER_*` macros, each of which owns a static `CallSite`,
+/// and to `logf()`, keyed on its format string and argument types. Direct
+/// `log()` calls without a `CallSite` are never throttled.
+struct RateLimitConfig {
+  /// Sustained messages per second each call site may log; 0 disables rate
+  /// limiting.
+  ///
+  /// Messages over the limit are discarded on the calling thread before
+  /// anything is encoded. The next message the site logs is preceded by
+  /// `[logger: N messages suppressed]`.
+  std::uint32_t messagesPerSecond = 0;
+
+  /// Messages a call site may log back to back before the limit applies.
+  /// Must be at least 1 when `messagesPerSecond` is set.
+  std::uint32_t burst = 10;
+
+  /// Collapse consecutive identical messages (same level and text or
+  /// arguments) from one call site.
+  ///
+  /// Repeats are discarded and counted; the site's next different message is
+  /// preceded by `[logger: last message repeated N times]`. Costs a hash of
+  /// the encoded message per call.
+  bool collapseRepeats = false;
+};
+
+/// Throttling state of one call site.
+///
+/// Normally a function-local `static` created by the `LOGGER_*` macros, so
+/// its address identifies the site. Shared by every logger the site logs to.
+class CallSite {
+public:
+  constexpr CallSite() = default;
+  ~CallSite() = default;
+
+  CallSite(const CallSite &) = delete;
+  auto operator=(const CallSite &) -> CallSite & = delete;
+  CallSite(CallSite &&) = delete;
+  auto operator=(CallSite &&) -> CallSite & = delete;
+
+private:
+  friend class RateLimiter;
+
+  /// Theoretical arrival time of the next message (GCRA), in steady-clock
+  /// nanoseconds.
+  std::atomic<std::int64_t> nextArrival_{
+      std::numeric_limits<std::int64_t>::min()};
+  std::atomic<std::uint64_t> suppressed_{0};
+  std::atomic<std::uint64_t> lastDigest_{0};
+  std::atomic<std::uint64_t> repeats_{0};
+};
+
+/// Applies a `RateLimitConfig` to call sites (used by the logger front-ends).
+///
+/// The rate limit is a generic cell rate algorithm: each site keeps the time
+/// its next message is due, so a throttled call costs one clock read and one
+/// atomic load (plus the count of suppressed messages). Under contention the
+/// suppressed and repeat counts are approximate.
+class RateLimiter {
+public:
+  /// A limiter that admits everything.
+  constexpr RateLimiter() = default;
+
+  /// ## Throws
+  /// `std::invalid_argument` if `config.burst` is 0 while
+  /// `config.messagesPerSecond` is set.
+  explicit RateLimiter(const RateLimitConfig &config)
+      : collapse_{config.collapseRepeats} {
+    if (config.messagesPerSecond == 0) {
+      return;
+    }
+    if (config.burst == 0) {
+      throw std::invalid_argument("RateLimitConfig::burst must be at least 1");
+    }
+    interval_ = std::max<std::int64_t>(
+        1, std::int64_t{1'000'000'000} / config.messagesPerSecond);
+    tolerance_ = interval_ * (std::int64_t{config.burst} - 1);
+  }
+
+  /// Whether a message from `site` is within the rate limit now.
+  ///
+  /// If it is and earlier messages were suppressed, first calls
+  /// `writeNote(text)` with a note saying how many.
+  template <typename WriteNote>
+  [[nodiscard]] auto admit(CallSite &site, const WriteNote &writeNote) const
+      -> bool {
+    if (interval_ == 0) {
+      return true;
+    }
+    const std::int64_t now =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    std::int64_t due = site.nextArrival_.load(std::memory_order_relaxed);
+    do {
+      if (due > now + tolerance_) {
+        site.suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    } while (!site.nextArrival_.compare_exchange_weak(
+        due, std::max(due, now) + interval_, std::memory_order_relaxed));
+    if (site.suppressed_.load(std::memory_order_relaxed) != 0) {
+      note(writeNote, "[logger: {} messages suppressed]",
+           site.suppressed_.exchange(0, std::memory_order_relaxed));
+    }
+    return true;
+  }
+
+  /// Whether consecutive identical messages are collapsed.
+  [[nodiscard]] auto collapsesRepeats() const -> bool { return collapse_; }
+
+  /// Whether the message identified by `digest` differs from the previous
+  /// one from `site`; see `digestOf()`.
+  ///
+  /// If it does and the previous one was repeated, first calls
+  /// `writeNote(text)` with a note saying how many times.
+  template <typename WriteNote>
+  [[nodiscard]] auto isFresh(CallSite &site, std::uint64_t digest,
+                             const WriteNote &writeNote) const -> bool {
+    if (site.lastDigest_.load(std::memory_order_relaxed) == digest) {
+      site.repeats_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    site.lastDigest_.store(digest, std::memory_order_relaxed);
+    if (site.repeats_.load(std::memory_order_relaxed) != 0) {
+      note(writeNote, "[logger: last message repeated {} times]",
+           site.repeats_.exchange(0, std::memory_order_relaxed));
+    }
+    return true;
+  }
+
+  /// Identify a message by its level, a key for its kind (e.g. its format
+  /// descriptor) and its text or encoded arguments.
+  [[nodiscard]] static auto digestOf(Level level, const void *key,
+                                     std::span<const std::byte> bytes)
+      -> std::uint64_t {
+    // FNV-1a.
+    constexpr std::uint64_t Prime = 0x100000001b3;
+    std::uint64_t hash = 0xcbf29ce484222325;
+    const auto mix = [&hash](std::uint64_t value) {
+      hash = (hash ^ value) * Prime;
+    };
+    mix(static_cast<std::uint64_t>(level));
+    mix(reinterpret_cast<std::uintptr_t>(key));
+    for (const std::byte byte : bytes) {
+      mix(std::to_integer<std::uint64_t>(byte));
+    }
+    return hash;
+  }
+
+private:
+  template <typename WriteNote>
+  static void note(const WriteNote &writeNote,
+                   fmt::format_string<std::uint64_t> text,
+                   std::uint64_t count) {
+    if (count == 0) {
+      return;
+    }
+    StagingBuffer message;
+    fmt::format_to(std::back_inserter(message.buffer()), text,
+                   std::uint64_t{count});
+    writeNote(message.view());
+  }
+
+  std::int64_t interval_ = 0;
+  std::int64_t tolerance_ = 0;
+  bool collapse_ = false;
+};
+
+namespace detail {
+
+/// The call site of `logf()` calls made without one: shared by every call
+/// with the same format string and argument types.
+template <FixedString Format, typename... Decoded>
+inline CallSite callSiteFor{};
+
+} // namespace detail
+
+} // namespace sample::logger
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace sample::logger {
+
+/// A reusable per-thread buffer for building log messages.
+///
+/// Each thread owns a small pool of `fmt::memory_buffer`s whose capacity
+/// survives between uses, so once a thread has built its largest message,
+/// building another performs no heap allocation. A `StagingBuffer` leases one
+/// buffer from the pool for its lifetime; nested leases take the next free
+/// one, and only when the pool is exhausted does a lease fall back to a
+/// buffer of its own.
+///
+/// ```cpp
+/// logger::StagingBuffer message;
+/// message.format("Processing request #{}", id);
+/// logger->log(message.view());
+/// ```
+///
+/// Not thread-safe: a `StagingBuffer` must be used and destroyed on the
+/// thread that created it.
+class StagingBuffer {
+public:
+  /// Lease a buffer from the calling thread's pool. The buffer starts empty.
+  StagingBuffer();
+  ~StagingBuffer();
+
+  StagingBuffer(const StagingBuffer &) = delete;
+  auto operator=(const StagingBuffer &) -> StagingBuffer & = delete;
+  StagingBuffer(StagingBuffer &&) = delete;
+  auto operator=(StagingBuffer &&) -> StagingBuffer & = delete;
+
+  /// Append formatted text.
+  template <typename... Args>
+  auto format(fmt::format_string<Args...> pattern, Args &&...args)
+      -> StagingBuffer & {
+    fmt::format_to(std::back_inserter(*buffer_), pattern,
+                   std::forward<Args>(args)...);
+    return *this;
+  }
+
+  /// Append `text` verbatim.
+  auto append(std::string_view text) -> StagingBuffer & {
+    buffer_->append(text.data(), text.data() + text.size());
+    return *this;
+  }
+
+  /// Discard the contents, keeping the capacity.
+  void clear() { buffer_->clear(); }
+
+  /// The underlying buffer, for direct `fmt::format_to()` calls.
+  [[nodiscard]] auto buffer() -> fmt::memory_buffer & { return *buffer_; }
+
+  /// The contents built so far; invalidated by further appends.
+  [[nodiscard]] auto view() const -> std::string_view {
+    return {buffer_->data(), buffer_->size()};
+  }
+
+private:
+  fmt::memory_buffer *buffer_;
+  std::size_t slot_;
+  std::unique_ptr<fmt::memory_buffer> fallback_;
+};
+
+} // namespace sample::logger
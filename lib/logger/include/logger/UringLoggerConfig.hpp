@@ -0,0 +1,43 @@
+#pragma once
+
+#include <logger/AsyncLoggerConfig.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+
+namespace sample::logger {
+
+/// Construction parameters for the `io_uring` file logger.
+///
+/// Passed by value to `createUringFileLogger()`.
+struct UringLoggerConfig {
+  /// Queue, overflow policy, batching, timestamps and record layout, as for
+  /// `createAsyncLogger()`.
+  ///
+  /// `target` and `filePath` are ignored in favour of `filePath` below;
+  /// `queueMode` must be `QueueMode::Shared`.
+  AsyncLoggerConfig queue{};
+
+  /// Log file, created if it does not exist and appended to otherwise.
+  ///
+  /// Batches are written at offsets the logger assigns, so nothing else may
+  /// write to the file while the logger is alive.
+  std::filesystem::path filePath{};
+
+  /// Batches that may be in flight at once, each in a buffer of its own
+  /// registered with the kernel. Must be at least 1.
+  std::size_t queueDepth = 8;
+
+  /// Least time between two `fdatasync` requests, each queued behind the
+  /// writes before it; zero requests one after every batch. The file is
+  /// also synced when the logger is destroyed.
+  std::chrono::milliseconds syncInterval{1000};
+
+  /// Use `io_uring` when the kernel allows it. When false, or when the
+  /// kernel lacks or forbids `io_uring`, batches are written with plain
+  /// `pwrite(2)` and synced with `fdatasync(2)` on the backend thread.
+  bool useUring = true;
+};
+
+} // namespace sample::logger
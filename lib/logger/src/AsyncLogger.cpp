@@ -0,0 +1,633 @@
+#include "AsyncRecord.hpp"
+#include "BackendSignals.hpp"
+#include "Backoff.hpp"
+#include "BatchTap.hpp"
+#include "BinaryEncoder.hpp"
+#include "BinaryLogFormat.hpp"
+#include "CpuTopology.hpp"
+#include "CrashDrain.hpp"
+#include "CycleClock.hpp"
+#include "FanOutSink.hpp"
+#include "FdSink.hpp"
+#include "LineFormatter.hpp"
+#include "MpscRing.hpp"
+#include "PerThreadAsyncLogger.hpp"
+#include "RecordArena.hpp"
+#include "StatsCounters.hpp"
+#include "ThreadSlots.hpp"
+#include "UringSink.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/DeferredFormat.hpp>
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+#include <logger/UringLoggerConfig.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sample::logger {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Empty polls the consumer makes before it parks on the wakeup counter (the
+/// starting budget with `WaitStrategy::Adaptive`).
+constexpr std::size_t SpinsBeforeSleep = 256;
+
+/// One producer thread's record arena for a shared-ring logger (private).
+struct ProducerArena {
+  explicit ProducerArena(std::size_t bytes) : arena{bytes, std::nullopt} {}
+
+  RecordArena arena;
+  /// Set when the owning thread exits; the logger then hands the arena (and
+  /// any records still queued in it) to the next thread that needs one.
+  std::atomic<bool> abandoned{false};
+};
+
+thread_local ThreadSlots<ProducerArena> threadArenas;
+
+/// Asynchronous logger implementation (private).
+///
+/// Producers copy each message into a slot of an `MpscRing` and return; a
+/// full ring is resolved by the configured `OverflowPolicy`. A single consumer
+/// thread drains the ring, formats any `logf()` records and gathers the text
+/// in an `Output`: an `FdSink`, which writes each batch with one `write(2)`,
+/// for `createFanOutLogger()` a `FanOutSink`, or for
+/// `createUringFileLogger()` a `UringSink`. A batch is
+/// written when it reaches `maxBatchBytes`, or once the ring is empty and its
+/// first record is `maxLatency` old; until then the consumer lingers on a
+/// timed futex wait. When the ring is empty and nothing is pending, the
+/// consumer parks on the same futex; producers only touch it while the
+/// consumer is parked, or while it lingers and the ring has filled up.
+/// `waitStrategy` may have the consumer poll instead of waiting on the futex,
+/// through a `Backoff` that also sizes its batches for `Adaptive`.
+/// The consumer alone updates the `WriterStats` behind `stats()`, and hands
+/// each batch to the configured `LogTap` just before the output gets it.
+///
+/// Records longer than `inlineRecordBytes` are copied into a `RecordArena`
+/// of the producer thread's, registered with its first such record, rather
+/// than the slot; the consumer frees each block once it has formatted it.
+///
+/// Nothing but the output is set up until the first record: that allocates
+/// the ring and the batch and starts the consumer, so a logger that is
+/// created and never used (e.g. by a short-lived tool) costs no thread.
+///
+/// `flush()` records the ring position it needs written in `flushTarget_`
+/// and waits on `flushEpoch_`; the consumer stops lingering while a flush is
+/// pending and publishes the position written so far in `written_` after
+/// each batch. The crash handler drains the logger the same way, and
+/// `flushThen()` records its callback with the position in `completions_`
+/// instead of waiting: the consumer calls it once it publishes the position.
+template <typename Output>
+class AsyncLogger final : public ILogger, private CrashDrainable {
+public:
+  /// Start a logger configured as `config` writing to an `Output`
+  /// constructed from `outputConfig`.
+  template <typename OutputConfig>
+  AsyncLogger(const AsyncLoggerConfig &config,
+              const OutputConfig &outputConfig)
+      : ILogger{config.rateLimit}, capacity_{config.capacity},
+        maxLatency_{config.maxLatency}, timestamps_{config.timestamps},
+        latency_{config.latencyHistogram},
+        binary_{config.outputFormat == OutputFormat::Binary},
+        lineFormat_{config.lineFormat},
+        inlineRecordBytes_{config.inlineRecordBytes},
+        arenaBytes_{config.arenaBytes}, backendCpus_{config.backendCpus},
+        tapCallback_{config.tap}, tap_{&tapCallback_}, sink_{outputConfig},
+        backoff_{config.waitStrategy, SpinsBeforeSleep, config.maxBatchBytes,
+                 stats_},
+        overflow_{config.overflowPolicy, config.sampleRate} {
+    registerCrashDrain(*this);
+  }
+
+  ~AsyncLogger() override {
+    unregisterCrashDrain(*this);
+    if (started_.load(std::memory_order_acquire)) {
+      stopping_.store(true, std::memory_order_release);
+      wakeup_.wakeAll();
+      consumer_.join();
+    }
+  }
+
+  AsyncLogger(const AsyncLogger &) = delete;
+  auto operator=(const AsyncLogger &) -> AsyncLogger & = delete;
+  AsyncLogger(AsyncLogger &&) = delete;
+  auto operator=(AsyncLogger &&) -> AsyncLogger & = delete;
+
+  [[nodiscard]] auto droppedMessages() const -> std::uint64_t override {
+    return overflow_.dropped();
+  }
+
+  [[nodiscard]] auto stats() const -> LoggerStats override {
+    LoggerStats result{.dropped = droppedMessages()};
+    stats_.addTo(result);
+    const std::lock_guard lock{arenasMutex_};
+    for (const auto &arena : arenas_) {
+      arena->arena.addTo(result);
+    }
+    return result;
+  }
+
+  void flush() override {
+    if (started_.load(std::memory_order_acquire)) {
+      static_cast<void>(awaitWritten(ring_->claimed(), std::nullopt));
+    }
+  }
+
+  void flushThen(FlushCallback done) override {
+    if (!started_.load(std::memory_order_acquire)) {
+      done();
+      return;
+    }
+    const std::size_t target = ring_->claimed();
+    {
+      const std::lock_guard lock{completionsMutex_};
+      completions_.push_back({target, std::move(done)});
+    }
+    static_cast<void>(requestWritten(target));
+    // seq_cst pairs with `publishWritten()`: either this thread sees the
+    // position written or the consumer sees the target and completes it.
+    if (written_.load(std::memory_order_seq_cst) >= target) {
+      completeFlushes();
+    }
+  }
+
+  void drainForCrash(Clock::time_point deadline) noexcept override {
+    if (started_.load(std::memory_order_acquire) &&
+        currentThreadId() != consumerThread_.load(std::memory_order_relaxed)) {
+      static_cast<void>(awaitWritten(ring_->claimed(), deadline));
+    }
+  }
+
+private:
+  void write(Level level, std::string_view message) override {
+    RecordArena *arena = arenaFor(message.size());
+    enqueue([level, message, arena, cycles = stamp()](Record &slot) noexcept {
+      slot.assign(level, cycles, nullptr, message.data(), message.size(),
+                  arena);
+    });
+  }
+
+  void writeDeferred(Level level, const DeferredFormat &format,
+                     std::span<const std::byte> args) override {
+    RecordArena *arena = arenaFor(args.size());
+    enqueue([level, &format, args, arena,
+             cycles = stamp()](Record &slot) noexcept {
+      slot.assign(level, cycles, &format,
+                  reinterpret_cast<const char *>(args.data()), args.size(),
+                  arena);
+    });
+  }
+
+  /// The calling thread's arena for a record of `size` bytes, or null if
+  /// the record fits its slot or arenas are disabled.
+  ///
+  /// ## Throws
+  /// `std::bad_alloc` if the thread's arena cannot be allocated.
+  auto arenaFor(std::size_t size) -> RecordArena * {
+    if (size <= inlineRecordBytes_ || arenaBytes_ == 0) {
+      return nullptr;
+    }
+    if (ProducerArena *local = threadArenas.find(id_)) {
+      return local->arena.ready();
+    }
+    std::shared_ptr<ProducerArena> local;
+    {
+      const std::lock_guard lock{arenasMutex_};
+      for (const auto &candidate : arenas_) {
+        if (candidate->abandoned.load(std::memory_order_acquire)) {
+          candidate->abandoned.store(false, std::memory_order_relaxed);
+          local = candidate;
+          break;
+        }
+      }
+      if (!local) {
+        local = std::make_shared<ProducerArena>(arenaBytes_);
+        arenas_.push_back(local);
+      }
+    }
+    RecordArena &arena = local->arena;
+    threadArenas.add(id_, std::move(local));
+    return arena.ready();
+  }
+
+  /// The timestamp for a record logged now, or 0 if neither timestamps nor
+  /// latencies are recorded.
+  [[nodiscard]] auto stamp() const -> std::uint64_t {
+    return timestamps_ || latency_ ? readCycleCounter() : 0;
+  }
+
+  /// Publish a record filled by `fill`, applying the overflow policy.
+  template <typename Fill> void enqueue(const Fill &fill) {
+    if (!started_.load(std::memory_order_acquire)) {
+      start();
+    }
+    if (!ring_->tryPush(fill)) {
+      handleOverflow(fill);
+    }
+    // `MpscRing::tryPush()` publishes seq_cst, as `wakeParked()` requires.
+    wakeup_.wakeParked();
+  }
+
+  /// Apply the overflow policy to a message that did not fit (producer side).
+  template <typename Fill> void handleOverflow(const Fill &fill) {
+    const auto tryPush = [this, &fill] { return ring_->tryPush(fill); };
+    const auto evictOldest = [this] {
+      const bool evicted =
+          ring_->tryPop([](const Record &record) { record.release(); });
+      return evicted ? Eviction::Evicted : Eviction::Empty;
+    };
+    wakeup_.wakeLingering();
+    overflow_.handle(tryPush, evictOldest, [this] { wakeup_.wakeParked(); });
+  }
+
+  /// On the first record: allocate the ring and the batch, then start the
+  /// consumer.
+  ///
+  /// ## Throws
+  /// `std::bad_alloc`, or `std::system_error` if the consumer thread cannot
+  /// be started; the next record tries again.
+  void start() {
+    const std::lock_guard lock{startMutex_};
+    if (started_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    sink_.start();
+    if (!ring_) {
+      ring_.emplace(capacity_);
+    }
+    consumer_ = std::thread{[this] { run(); }};
+    started_.store(true, std::memory_order_release);
+  }
+
+  /// Have the consumer write every record below ring position `target`, and
+  /// wait until it has or until `deadline`.
+  ///
+  /// ## Returns
+  /// Whether the records were written before the deadline.
+  auto awaitWritten(std::size_t target,
+                    std::optional<Clock::time_point> deadline) -> bool {
+    if (!requestWritten(target)) {
+      return true;
+    }
+    return flushEpoch_.await([this, target] {
+      return written_.load(std::memory_order_seq_cst) >= target;
+    }, deadline);
+  }
+
+  /// Have the consumer write every record below ring position `target`.
+  ///
+  /// ## Returns
+  /// Whether it is still to be written; if not, nothing was requested.
+  auto requestWritten(std::size_t target) -> bool {
+    if (written_.load(std::memory_order_acquire) >= target) {
+      return false;
+    }
+    std::size_t requested = flushTarget_.load(std::memory_order_relaxed);
+    while (requested < target &&
+           !flushTarget_.compare_exchange_weak(requested, target,
+                                               std::memory_order_seq_cst)) {
+    }
+    wakeup_.wakeAll();
+    return true;
+  }
+
+  /// Call the `flushThen()` callbacks whose records are written; called by
+  /// the consumer, and by `flushThen()` for a position already published.
+  void completeFlushes() {
+    std::vector<FlushCallback> ready;
+    {
+      const std::lock_guard lock{completionsMutex_};
+      const std::size_t written = written_.load(std::memory_order_seq_cst);
+      std::erase_if(completions_, [&ready, written](Completion &completion) {
+        if (completion.target > written) {
+          return false;
+        }
+        ready.push_back(std::move(completion.done));
+        return true;
+      });
+    }
+    for (FlushCallback &done : ready) {
+      try {
+        done();
+      } catch (...) {
+        // As for output errors: a logger has nowhere to report them.
+      }
+    }
+  }
+
+  /// Whether a `flush()` is waiting for records the consumer has not yet
+  /// reported written.
+  [[nodiscard]] auto flushPending() const -> bool {
+    return flushTarget_.load(std::memory_order_seq_cst) >
+           written_.load(std::memory_order_relaxed);
+  }
+
+  /// Report every popped record written, waking waiting `flush()` calls.
+  ///
+  /// A sink with destinations that write on their own threads has to be
+  /// waited for first, so it is only reported while a flush is pending.
+  void publishWritten() {
+    if (!sink_.synchronous()) {
+      if (!flushPending()) {
+        return;
+      }
+      sink_.sync();
+    }
+    const std::size_t previous = written_.load(std::memory_order_relaxed);
+    // seq_cst pairs with `awaitWritten()`: either it sees the new position
+    // or this thread sees its target and wakes it.
+    written_.store(ring_->popped(), std::memory_order_seq_cst);
+    if (flushTarget_.load(std::memory_order_seq_cst) > previous) {
+      flushEpoch_.advance();
+      completeFlushes();
+    }
+  }
+
+  /// Consumer thread body.
+  void run() {
+    consumerThread_.store(currentThreadId(), std::memory_order_relaxed);
+    if (!backendCpus_.empty()) {
+      pinCurrentThread({backendCpus_.data(), 1});
+    }
+    if (binary_) {
+      sink_.write(binary::SessionMagic);
+      tap_.publish(Level::Off, binary::SessionMagic);
+      encoder_.emplace(formatIds_, timestamps_);
+    } else {
+      lineFormatter_.emplace(lineFormat_, timestamps_);
+    }
+    for (;;) {
+      const bool stopping = stopping_.load(std::memory_order_acquire);
+      const std::size_t count = drain();
+      if (!sink_.empty()) {
+        if (stopping || flushPending() ||
+            maxLatency_ == Clock::duration::zero() ||
+            Clock::now() >= batchDeadline_) {
+          writeBatch();
+        } else {
+          lingerUntil(batchDeadline_);
+        }
+        continue;
+      }
+      if (count == 0) {
+        if (flushPending()) {
+          publishWritten();
+        }
+        if (stopping) {
+          backoff_.noteCpuTime();
+          return;
+        }
+        wakeup_.park(backoff_, [this] { return workReady(); });
+      }
+    }
+  }
+
+  /// Format every ready record into the sink, writing each full batch.
+  ///
+  /// ## Returns
+  /// Number of records consumed.
+  auto drain() -> std::size_t {
+    const std::size_t depth = ring_->size();
+    stats_.noteQueueDepth(depth);
+    backoff_.noteDepth(depth);
+    std::size_t count = 0;
+    while (ring_->tryPop([this](const Record &record) {
+      append(record);
+      record.release();
+    })) {
+      ++count;
+      if (sink_.full() || sink_.buffer().size() >= backoff_.batchBytes()) {
+        writeBatch();
+      }
+    }
+    return count;
+  }
+
+  /// Append `record` and its line terminator to the pending batch.
+  void append(const Record &record) {
+    fmt::memory_buffer &batch = sink_.buffer();
+    if (batch.size() == 0 && maxLatency_ != Clock::duration::zero()) {
+      batchDeadline_ = Clock::now() + maxLatency_;
+    }
+    if (encoder_) {
+      encoder_->append(record, batch);
+    } else {
+      lineFormatter_->append(record, batch);
+    }
+    sink_.endRecord(record.level);
+    tap_.endRecord(record.level, batch.size());
+    ++batchRecords_;
+    if (latency_) {
+      batchStamps_.push_back(record.cycles);
+    }
+  }
+
+  /// Write the pending batch and count it in the statistics.
+  void writeBatch() {
+    const std::size_t bytes = sink_.buffer().size();
+    tap_.publish(sink_.buffer());
+    sink_.flush();
+    stats_.countFlush(batchRecords_, bytes);
+    batchRecords_ = 0;
+    if (latency_) {
+      const std::uint64_t now = readCycleCounter();
+      for (const std::uint64_t cycles : batchStamps_) {
+        stats_.countLatency(latencyClock_.elapsed(cycles, now));
+      }
+      batchStamps_.clear();
+    }
+    // Published once counted, so `stats()` after a `flush()` includes it.
+    publishWritten();
+    backoff_.noteCpuTime();
+  }
+
+  /// Wait for more records until `deadline`, holding a partial batch.
+  void lingerUntil(Clock::time_point deadline) {
+    wakeup_.linger(
+        backoff_, [this] { return workReady(); },
+        [this] {
+          return stopping_.load(std::memory_order_relaxed) || flushPending();
+        },
+        deadline);
+  }
+
+  /// Whether the consumer has records to drain, a flush to complete or is
+  /// to stop.
+  [[nodiscard]] auto workReady() const -> bool {
+    return ring_->readable() || stopping_.load(std::memory_order_relaxed) ||
+           flushPending();
+  }
+
+  /// A `flushThen()` callback and the ring position it waits for.
+  struct Completion {
+    std::size_t target;
+    FlushCallback done;
+  };
+
+  const std::size_t capacity_;
+  std::mutex startMutex_;
+  std::atomic<bool> started_{false};
+  std::optional<MpscRing<Record>> ring_;
+  const Clock::duration maxLatency_;
+  const bool timestamps_;
+  const bool latency_;
+  const bool binary_;
+  const LineFormat lineFormat_;
+  const std::size_t inlineRecordBytes_;
+  const std::size_t arenaBytes_;
+  const std::vector<unsigned> backendCpus_;
+  const std::uint64_t id_ = nextThreadSlotsOwner();
+  mutable std::mutex arenasMutex_;
+  std::vector<std::shared_ptr<ProducerArena>> arenas_;
+  const LogTap tapCallback_;
+  BatchTap tap_;
+  Output sink_;
+  std::optional<LineFormatter> lineFormatter_;
+  FormatIds formatIds_;
+  std::optional<BinaryEncoder> encoder_;
+  Clock::time_point batchDeadline_;
+  std::uint64_t batchRecords_ = 0;
+  std::vector<std::uint64_t> batchStamps_;
+  CycleClock latencyClock_;
+  WriterStats stats_;
+  Backoff backoff_;
+  std::atomic<bool> stopping_{false};
+  alignas(CacheLineSize) OverflowHandler overflow_;
+  alignas(CacheLineSize) BackendWakeup wakeup_;
+  alignas(CacheLineSize) std::atomic<std::size_t> flushTarget_{0};
+  std::atomic<std::size_t> written_{0};
+  FlushEpoch flushEpoch_;
+  std::atomic<int> consumerThread_{0};
+  std::mutex completionsMutex_;
+  std::vector<Completion> completions_;
+  std::thread consumer_;
+};
+
+/// Check the settings shared by every queue mode.
+///
+/// ## Throws
+/// `std::invalid_argument` on an invalid setting; see `createAsyncLogger()`.
+void validate(const AsyncLoggerConfig &config) {
+  if (config.capacity < 2) {
+    throw std::invalid_argument("AsyncLoggerConfig::capacity must be >= 2");
+  }
+  if (config.sampleRate < 1) {
+    throw std::invalid_argument("AsyncLoggerConfig::sampleRate must be >= 1");
+  }
+  if (config.maxBatchBytes < 1) {
+    throw std::invalid_argument(
+        "AsyncLoggerConfig::maxBatchBytes must be >= 1");
+  }
+  if (config.maxLatency < std::chrono::microseconds::zero()) {
+    throw std::invalid_argument(
+        "AsyncLoggerConfig::maxLatency must not be negative");
+  }
+  if (config.backendThreads < 1) {
+    throw std::invalid_argument(
+        "AsyncLoggerConfig::backendThreads must be >= 1");
+  }
+  const std::vector<unsigned> allowed = allowedCpus();
+  for (const unsigned cpu : config.backendCpus) {
+    if (std::ranges::find(allowed, cpu) == allowed.end()) {
+      throw std::invalid_argument(
+          "AsyncLoggerConfig::backendCpus must name CPUs the process may "
+          "run on");
+    }
+  }
+  if ((config.backendPerNode || config.nodeLocalQueues) &&
+      config.queueMode != QueueMode::PerThread) {
+    throw std::invalid_argument(
+        "AsyncLoggerConfig::backendPerNode and nodeLocalQueues require "
+        "QueueMode::PerThread");
+  }
+  if (config.backendPerNode && !config.backendCpus.empty()) {
+    throw std::invalid_argument(
+        "AsyncLoggerConfig::backendPerNode excludes backendCpus");
+  }
+}
+
+} // anonymous namespace
+
+auto createAsyncLogger(const AsyncLoggerConfig &config)
+    -> std::unique_ptr<ILogger> {
+  validate(config);
+  if (config.queueMode == QueueMode::PerThread) {
+    return createPerThreadAsyncLogger(config);
+  }
+  if (config.backendThreads != 1) {
+    throw std::invalid_argument(
+        "AsyncLoggerConfig::backendThreads must be 1 with QueueMode::Shared");
+  }
+  return std::make_unique<AsyncLogger<FdSink>>(config, config);
+}
+
+auto createFanOutLogger(const FanOutLoggerConfig &config)
+    -> std::unique_ptr<ILogger> {
+  validate(config.queue);
+  if (config.queue.outputFormat != OutputFormat::Text) {
+    throw std::invalid_argument(
+        "FanOutLoggerConfig::queue.outputFormat must be Text");
+  }
+  if (config.queue.queueMode != QueueMode::Shared ||
+      config.queue.backendThreads != 1) {
+    throw std::invalid_argument(
+        "FanOutLoggerConfig::queue must use one backend and a shared queue");
+  }
+  if (config.queue.compression != Compression::None) {
+    throw std::invalid_argument(
+        "FanOutLoggerConfig::queue.compression must be None");
+  }
+  if (config.targets.empty()) {
+    throw std::invalid_argument(
+        "FanOutLoggerConfig::targets must not be empty");
+  }
+  if (config.maxPendingBatches < 1) {
+    throw std::invalid_argument(
+        "FanOutLoggerConfig::maxPendingBatches must be >= 1");
+  }
+  return std::make_unique<AsyncLogger<FanOutSink>>(config.queue, config);
+}
+
+auto createUringFileLogger(const UringLoggerConfig &config)
+    -> std::unique_ptr<ILogger> {
+  validate(config.queue);
+  if (config.queue.queueMode != QueueMode::Shared ||
+      config.queue.backendThreads != 1) {
+    throw std::invalid_argument(
+        "UringLoggerConfig::queue must use one backend and a shared queue");
+  }
+  if (config.queue.compression != Compression::None) {
+    throw std::invalid_argument(
+        "UringLoggerConfig::queue.compression must be None");
+  }
+  if (config.queueDepth < 1 || config.queueDepth > MaxUringQueueDepth) {
+    throw std::invalid_argument(
+        "UringLoggerConfig::queueDepth must be between 1 and 4096");
+  }
+  if (config.syncInterval < std::chrono::milliseconds::zero()) {
+    throw std::invalid_argument(
+        "UringLoggerConfig::syncInterval must not be negative");
+  }
+  return std::make_unique<AsyncLogger<UringSink>>(config.queue, config);
+}
+
+} // namespace sample::logger
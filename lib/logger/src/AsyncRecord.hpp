@@ -0,0 +1,66 @@
+#pragma once
+
+#include "RecordArena.hpp"
+
+#include <logger/DeferredFormat.hpp>
+#include <logger/LogLevel.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sample::logger {
+
+/// A queued log record of the asynchronous loggers (private).
+///
+/// Holds either plain text (`format == nullptr`) or the encoded arguments of
+/// a `logf()` call or a structured `log()`, in which case the backend formats
+/// `bytes()` with `format`. `cycles` is the `readCycleCounter()` value at the
+/// call, or 0 when timestamps are off. The bytes live in `payload`, which
+/// keeps its capacity when the slot is reused, or for an oversize record in
+/// a `RecordArena` block, which whoever pops the record must `release()`.
+struct Record {
+  Level level = Level::Info;
+  std::uint64_t cycles = 0;
+  const DeferredFormat *format = nullptr;
+  std::string payload;
+  const RecordArena::Block *block = nullptr;
+
+  /// The text or encoded arguments.
+  [[nodiscard]] auto bytes() const -> std::string_view {
+    return block != nullptr ? RecordArena::text(*block)
+                            : std::string_view{payload};
+  }
+
+  /// Free the arena block, if any; `bytes()` must not be used afterwards.
+  void release() const noexcept {
+    if (block != nullptr) {
+      RecordArena::release(*block);
+    }
+  }
+
+  /// Replace the contents, degrading to an empty text record if out of memory
+  /// (a claimed slot must always be published).
+  ///
+  /// The bytes go to a block of `arena` if one is given and has room.
+  void assign(Level newLevel, std::uint64_t newCycles,
+              const DeferredFormat *newFormat, const char *data,
+              std::size_t size, RecordArena *arena) noexcept {
+    level = newLevel;
+    cycles = newCycles;
+    format = newFormat;
+    block = arena != nullptr ? arena->allocate({data, size}) : nullptr;
+    if (block != nullptr) {
+      return;
+    }
+    try {
+      payload.assign(data, size);
+    } catch (...) {
+      payload.clear();
+      format = nullptr;
+    }
+  }
+};
+
+} // namespace sample::logger
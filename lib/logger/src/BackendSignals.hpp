@@ -0,0 +1,215 @@
+#pragma once
+
+#include "Backoff.hpp"
+#include "Futex.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+namespace sample::logger {
+
+/// What evicting the oldest record of a full queue did (private).
+enum class Eviction : std::uint8_t {
+  /// A record was discarded.
+  Evicted,
+  /// There was none to discard; a backend emptied the queue meanwhile.
+  Empty,
+  /// The queue could not be evicted from, so the new record is discarded.
+  Refused,
+};
+
+/// Applies an asynchronous logger's `OverflowPolicy` to the records that do
+/// not fit their queue, counting those it drops (private).
+///
+/// The queue is reached through callables, so every backend applies the
+/// policies alike whatever queue a producer writes to.
+class OverflowHandler {
+public:
+  OverflowHandler(OverflowPolicy policy, std::size_t sampleRate)
+      : policy_{policy}, sampleRate_{sampleRate} {}
+
+  /// Apply the policy to a record for which `tryPush()` just failed
+  /// (producer side).
+  ///
+  /// `tryPush()` pushes the record and returns whether it fit,
+  /// `evictOldest()` discards the oldest queued record and returns an
+  /// `Eviction`, and `wake()` wakes a backend while `Block` waits for room.
+  template <typename TryPush, typename EvictOldest, typename Wake>
+  void handle(const TryPush &tryPush, const EvictOldest &evictOldest,
+              const Wake &wake) {
+    switch (policy_) {
+    case OverflowPolicy::Block:
+      while (!tryPush()) {
+        wake();
+        std::this_thread::yield();
+      }
+      return;
+    case OverflowPolicy::DropNewest:
+      countDrop();
+      return;
+    case OverflowPolicy::DropOldest:
+      pushEvictingOldest(tryPush, evictOldest);
+      return;
+    case OverflowPolicy::Sample:
+      if (overflows_.fetch_add(1, std::memory_order_relaxed) % sampleRate_ ==
+          0) {
+        pushEvictingOldest(tryPush, evictOldest);
+      } else {
+        countDrop();
+      }
+      return;
+    }
+  }
+
+  /// Number of records dropped so far.
+  [[nodiscard]] auto dropped() const -> std::uint64_t {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  /// Push the record, discarding queued records until it fits.
+  template <typename TryPush, typename EvictOldest>
+  void pushEvictingOldest(const TryPush &tryPush,
+                          const EvictOldest &evictOldest) {
+    while (!tryPush()) {
+      switch (evictOldest()) {
+      case Eviction::Evicted:
+        countDrop();
+        break;
+      case Eviction::Empty:
+        break;
+      case Eviction::Refused:
+        countDrop();
+        return;
+      }
+    }
+  }
+
+  void countDrop() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+  const OverflowPolicy policy_;
+  const std::size_t sampleRate_;
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint64_t> overflows_{0};
+};
+
+/// The futex an asynchronous logger's backend threads park and linger on,
+/// with counts of those doing each so producers skip the system call while
+/// none is (private).
+///
+/// A parked backend is woken by the next record; a lingering one, holding a
+/// partial batch, only when a queue overflows or by `wakeAll()`, so a
+/// trickle of records is gathered into one write.
+class BackendWakeup {
+public:
+  /// Wake one backend if any is parked (producer side).
+  ///
+  /// The record must have been published seq_cst: with this load, and the
+  /// count and `ready()` check in `park()`, either this thread sees a parked
+  /// backend or the backend sees the record.
+  void wakeParked() {
+    if (sleeping_.load(std::memory_order_seq_cst) != 0) {
+      wakeups_.fetch_add(1, std::memory_order_release);
+      futexWakeOne(wakeups_);
+    }
+  }
+
+  /// Wake every lingering backend, for a producer whose queue is full.
+  void wakeLingering() {
+    if (lingering_.load(std::memory_order_relaxed) != 0) {
+      wakeAll();
+    }
+  }
+
+  /// Wake every parked or lingering backend.
+  void wakeAll() {
+    wakeups_.fetch_add(1, std::memory_order_release);
+    futexWakeAll(wakeups_);
+  }
+
+  /// Poll for `ready()` as `backoff` says, then park until woken (backend
+  /// side).
+  template <typename Ready> void park(Backoff &backoff, const Ready &ready) {
+    if (backoff.poll(ready)) {
+      return;
+    }
+    sleeping_.fetch_add(1, std::memory_order_seq_cst);
+    const std::uint32_t token = wakeups_.load(std::memory_order_acquire);
+    if (!ready()) {
+      backoff.sleeping();
+      futexWait(wakeups_, token);
+    }
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Poll for `ready()` as `backoff` says, then wait until `deadline` or
+  /// until woken, holding a partial batch (backend side).
+  ///
+  /// Does not wait if `interrupted()`: the batch is to be written now.
+  template <typename Ready, typename Interrupted>
+  void linger(Backoff &backoff, const Ready &ready,
+              const Interrupted &interrupted,
+              std::chrono::steady_clock::time_point deadline) {
+    if (backoff.pollUntil(ready, deadline)) {
+      return;
+    }
+    lingering_.fetch_add(1, std::memory_order_relaxed);
+    const std::uint32_t token = wakeups_.load(std::memory_order_acquire);
+    if (!interrupted()) {
+      futexWait(wakeups_, token, deadline - std::chrono::steady_clock::now());
+    }
+    lingering_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<std::uint32_t> sleeping_{0};
+  std::atomic<std::uint32_t> lingering_{0};
+  std::atomic<std::uint32_t> wakeups_{0};
+};
+
+/// The futex `flush()` calls wait on for their records to be written,
+/// advanced by the backends after the batches they wait for (private).
+///
+/// Only atomics and futex calls, so the crash handler may use it.
+class FlushEpoch {
+public:
+  /// Wait until `written()` holds or `deadline` passes.
+  ///
+  /// ## Returns
+  /// Whether `written()` held before the deadline.
+  template <typename Written>
+  auto await(const Written &written,
+             std::optional<std::chrono::steady_clock::time_point> deadline)
+      -> bool {
+    for (;;) {
+      const std::uint32_t token = epoch_.load(std::memory_order_acquire);
+      if (written()) {
+        return true;
+      }
+      if (!deadline) {
+        futexWait(epoch_, token);
+      } else if (std::chrono::steady_clock::now() < *deadline) {
+        futexWait(epoch_, token, *deadline - std::chrono::steady_clock::now());
+      } else {
+        return false;
+      }
+    }
+  }
+
+  /// Wake every waiter to check `written()` again (backend side).
+  void advance() {
+    epoch_.fetch_add(1, std::memory_order_release);
+    futexWakeAll(epoch_);
+  }
+
+private:
+  std::atomic<std::uint32_t> epoch_{0};
+};
+
+} // namespace sample::logger
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "StatsCounters.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+
+#include <time.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sample::logger {
+
+/// Tell the CPU the calling thread is busy-waiting (private).
+///
+/// `pause` on x86 and `yield` on arm64: a hint that frees pipeline resources
+/// for a sibling hyperthread and saves power, at a few dozen cycles a poll.
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/// CPU time the calling thread has used so far (private).
+[[nodiscard]] inline auto threadCpuTime() noexcept
+    -> std::chrono::nanoseconds {
+  ::timespec now{};
+  ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return std::chrono::seconds{now.tv_sec} +
+         std::chrono::nanoseconds{now.tv_nsec};
+}
+
+/// How one backend thread waits for records, per its `WaitStrategy`
+/// (private).
+///
+/// `poll()` and `pollUntil()` wait on the CPU and return false when the
+/// strategy sleeps instead: the backend then parks on its futex as it
+/// decides, calling `sleeping()` first. With `WaitStrategy::Adaptive` the
+/// spin budget doubles each time polling finds work and halves each time
+/// the backend sleeps, and `batchBytes()` follows an average of the queue
+/// depths given to `noteDepth()`. The backend's `WriterStats` get its CPU
+/// time from `noteCpuTime()`, also sampled while polling.
+///
+/// Owned by the backend thread.
+class Backoff {
+public:
+  /// Wait as `strategy` says, first polling `spins` times; batches are at
+  /// most `maxBatchBytes`.
+  Backoff(WaitStrategy strategy, std::size_t spins, std::size_t maxBatchBytes,
+          WriterStats &stats)
+      : strategy_{strategy}, spins_{spins}, maxBatchBytes_{maxBatchBytes},
+        stats_{stats} {}
+
+  /// Poll until `ready()` holds.
+  ///
+  /// ## Returns
+  /// Whether it does; false once the strategy would rather sleep.
+  template <typename Ready> auto poll(const Ready &ready) -> bool {
+    for (std::size_t spin = 0; spin < spins_; ++spin) {
+      if (ready()) {
+        if (strategy_ == WaitStrategy::Adaptive) {
+          spins_ = std::min(spins_ * 2, MaxAdaptiveSpins);
+        }
+        return true;
+      }
+      cpuRelax();
+    }
+    if (strategy_ == WaitStrategy::Park ||
+        strategy_ == WaitStrategy::Adaptive) {
+      return false;
+    }
+    for (std::uint64_t polls = 1;; ++polls) {
+      if (ready()) {
+        return true;
+      }
+      pause(polls);
+    }
+  }
+
+  /// Poll until `ready()` holds or `deadline` passes.
+  ///
+  /// ## Returns
+  /// False, without polling, if the strategy would rather sleep.
+  template <typename Ready, typename TimePoint>
+  auto pollUntil(const Ready &ready, TimePoint deadline) -> bool {
+    if (strategy_ == WaitStrategy::Park ||
+        strategy_ == WaitStrategy::Adaptive) {
+      return false;
+    }
+    for (std::uint64_t polls = 1;
+         !ready() && TimePoint::clock::now() < deadline; ++polls) {
+      pause(polls);
+    }
+    return true;
+  }
+
+  /// Count a sleep and publish the CPU time used before it.
+  void sleeping() {
+    if (strategy_ == WaitStrategy::Adaptive) {
+      spins_ = std::max(spins_ / 2, MinAdaptiveSpins);
+    }
+    stats_.countSleep();
+    noteCpuTime();
+  }
+
+  /// Note that `depth` records were seen waiting in a queue.
+  void noteDepth(std::size_t depth) {
+    // An exponential average, in sixteenths of a record, over about eight
+    // samples.
+    meanDepth_ = meanDepth_ - meanDepth_ / 8 + 2 * depth;
+  }
+
+  /// Bytes of output at which the backend writes its batch.
+  [[nodiscard]] auto batchBytes() const -> std::size_t {
+    if (strategy_ != WaitStrategy::Adaptive) {
+      return maxBatchBytes_;
+    }
+    // Halve the batch for each power of two the average depth is below
+    // `DeepQueue`, down to 1/64 of the largest.
+    const auto depthBits = static_cast<std::size_t>(
+        std::bit_width(meanDepth_ / 16));
+    const std::size_t shift = std::min(
+        DeepQueueBits - std::min(depthBits, DeepQueueBits), MaxBatchShift);
+    return std::max<std::size_t>(maxBatchBytes_ >> shift, 1);
+  }
+
+  /// Publish the CPU time the thread has used.
+  void noteCpuTime() { stats_.noteCpuTime(threadCpuTime()); }
+
+private:
+  /// Fewest and most polls before sleeping with `WaitStrategy::Adaptive`.
+  static constexpr std::size_t MinAdaptiveSpins = 16;
+  static constexpr std::size_t MaxAdaptiveSpins = 16 * 1024;
+
+  /// Average queue depth, in records, from which batches are full size:
+  /// `std::bit_width(64)`.
+  static constexpr std::size_t DeepQueueBits = 7;
+
+  /// Most halvings of `maxBatchBytes` for a shallow queue.
+  static constexpr std::size_t MaxBatchShift = 6;
+
+  /// Polls between samples of the CPU time while polling indefinitely.
+  static constexpr std::uint64_t PollsPerCpuSample = 4096;
+
+  /// Wait between two polls of an indefinite poll, `polls` so far.
+  void pause(std::uint64_t polls) {
+    if (strategy_ == WaitStrategy::SpinYield) {
+      std::this_thread::yield();
+    } else {
+      cpuRelax();
+    }
+    if (polls % PollsPerCpuSample == 0) {
+      noteCpuTime();
+    }
+  }
+
+  const WaitStrategy strategy_;
+  std::size_t spins_;
+  const std::size_t maxBatchBytes_;
+  std::size_t meanDepth_ = 0;
+  WriterStats &stats_;
+};
+
+} // namespace sample::logger
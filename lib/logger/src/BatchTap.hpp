@@ -0,0 +1,80 @@
+#pragma once
+
+#include <logger/LogLevel.hpp>
+#include <logger/LogTap.hpp>
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace sample::logger {
+
+/// Collects the record boundaries of a backend's batch for its `LogTap`
+/// (private).
+///
+/// The backend notes where each record ends as it formats it;
+/// `publish()` turns the boundaries into spans over the finished batch,
+/// which by then will not move, and calls the tap. Without a tap every
+/// call is a no-op. Belongs to one backend thread.
+class BatchTap {
+public:
+  /// Collect for `tap`, which must outlive this; null or empty for none.
+  explicit BatchTap(const LogTap *tap = nullptr)
+      : tap_{tap != nullptr && *tap ? tap : nullptr} {}
+
+  /// Note a record of `level` ending at `end` in the batch.
+  void endRecord(Level level, std::size_t end) {
+    if (tap_ != nullptr) {
+      ends_.push_back({end, level});
+    }
+  }
+
+  /// Hand the records noted in `batch` to the tap and forget them.
+  void publish(const fmt::memory_buffer &batch) {
+    if (tap_ == nullptr || ends_.empty()) {
+      return;
+    }
+    const auto bytes = std::as_bytes(std::span{batch.data(), batch.size()});
+    std::size_t start = 0;
+    for (const End &end : ends_) {
+      records_.push_back(
+          {.level = end.level, .bytes = bytes.subspan(start, end.end - start)});
+      start = end.end;
+    }
+    call(records_);
+    ends_.clear();
+    records_.clear();
+  }
+
+  /// Hand `text`, written outside any batch, to the tap as one record.
+  void publish(Level level, std::string_view text) const {
+    if (tap_ != nullptr) {
+      const TapRecord record{.level = level,
+                             .bytes = std::as_bytes(std::span{text})};
+      call({&record, 1});
+    }
+  }
+
+private:
+  struct End {
+    std::size_t end;
+    Level level;
+  };
+
+  void call(std::span<const TapRecord> records) const {
+    try {
+      (*tap_)(records);
+    } catch (...) {
+      // As for output errors: a logger has nowhere to report them.
+    }
+  }
+
+  const LogTap *tap_;
+  std::vector<End> ends_;
+  std::vector<TapRecord> records_;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,65 @@
+#include "BinaryEncoder.hpp"
+
+#include "AsyncRecord.hpp"
+#include "BinaryLogFormat.hpp"
+#include "CycleClock.hpp"
+
+#include <logger/DeferredFormat.hpp>
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace sample::logger {
+
+auto FormatIds::idFor(const DeferredFormat *format) -> std::uint32_t {
+  const std::lock_guard lock{mutex_};
+  const auto [entry, inserted] = ids_.try_emplace(format, nextId_);
+  if (inserted) {
+    ++nextId_;
+  }
+  return entry->second;
+}
+
+BinaryEncoder::BinaryEncoder(FormatIds &ids, bool timestamps) : ids_{ids} {
+  if (timestamps) {
+    clock_.emplace();
+  }
+}
+
+void BinaryEncoder::append(const Record &record, fmt::memory_buffer &out) {
+  std::uint32_t id = binary::TextId;
+  if (record.format != nullptr) {
+    auto entry = defined_.find(record.format);
+    if (entry == defined_.end()) {
+      entry = defined_.emplace(record.format, ids_.idFor(record.format)).first;
+      const DeferredFormat &format = *record.format;
+      binary::put(out, binary::FrameKind::Definition);
+      binary::put(out, entry->second);
+      binary::put(out, static_cast<std::uint8_t>(
+                           format.fields != nullptr ? binary::Structured : 0));
+      binary::put(out, static_cast<std::uint32_t>(format.pattern.size()));
+      binary::putBytes(out, format.pattern);
+      binary::put(out, static_cast<std::uint8_t>(format.args.size()));
+      for (const DeferredArg &arg : format.args) {
+        binary::put(out, arg.kind);
+        binary::put(out, arg.size);
+      }
+    }
+    id = entry->second;
+  }
+  const std::int64_t timestamp =
+      clock_ ? clock_->toWallClock(record.cycles).time_since_epoch().count()
+             : 0;
+  binary::put(out, binary::FrameKind::Record);
+  binary::put(out, id);
+  binary::put(out, record.level);
+  binary::put(out, timestamp);
+  const std::string_view bytes = record.bytes();
+  binary::put(out, static_cast<std::uint32_t>(bytes.size()));
+  binary::putBytes(out, bytes);
+}
+
+} // namespace sample::logger
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AsyncRecord.hpp"
+#include "CycleClock.hpp"
+
+#include <logger/DeferredFormat.hpp>
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace sample::logger {
+
+/// Format ids shared by the encoders writing to one stream (private).
+class FormatIds {
+public:
+  /// The id of `format`, assigned on first request. Thread-safe.
+  [[nodiscard]] auto idFor(const DeferredFormat *format) -> std::uint32_t;
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<const DeferredFormat *, std::uint32_t> ids_;
+  std::uint32_t nextId_ = 1;
+};
+
+/// Encodes records as binary log frames (private).
+///
+/// Emits a format's definition the first time this encoder meets it, so each
+/// encoder's output is self-contained; encoders writing to the same stream
+/// share a `FormatIds` so that a repeated definition carries the same id.
+/// Not thread-safe: owned by one backend thread.
+class BinaryEncoder {
+public:
+  /// Encode with ids from `ids`, converting timestamps if `timestamps`.
+  BinaryEncoder(FormatIds &ids, bool timestamps);
+
+  /// Append the frames for `record` (a definition first, if needed) to `out`.
+  void append(const Record &record, fmt::memory_buffer &out);
+
+private:
+  FormatIds &ids_;
+  std::unordered_map<const DeferredFormat *, std::uint32_t> defined_;
+  std::optional<CycleClock> clock_;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,439 @@
+#include "BinaryLogFormat.hpp"
+#include "CycleClock.hpp"
+
+#include <logger/BinaryLogDecoder.hpp>
+#include <logger/DeferredFormat.hpp>
+#include <logger/Fields.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/Lz4Decoder.hpp>
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace sample::logger {
+
+namespace {
+
+/// An `ArgKind::Other` argument, which only the logging program can format.
+struct Opaque {
+  std::uint32_t size;
+};
+
+/// One decoded `logf()` argument.
+using Value = std::variant<bool, char, std::int64_t, std::uint64_t, double,
+                           const void *, std::string_view, Opaque>;
+
+/// Reads fields from a frame, reporting whether the frame is complete.
+class Reader {
+public:
+  explicit Reader(std::span<const std::byte> input) : input_{input} {}
+
+  /// Read a `T`, or return false if the input ends first.
+  template <typename T> auto read(T &value) -> bool {
+    if (input_.size() - position_ < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, input_.data() + position_, sizeof(T));
+    position_ += sizeof(T);
+    return true;
+  }
+
+  /// Read `size` bytes, or return false if the input ends first.
+  auto read(std::size_t size, std::span<const std::byte> &bytes) -> bool {
+    if (input_.size() - position_ < size) {
+      return false;
+    }
+    bytes = input_.subspan(position_, size);
+    position_ += size;
+    return true;
+  }
+
+  [[nodiscard]] auto position() const -> std::size_t { return position_; }
+
+private:
+  std::span<const std::byte> input_;
+  std::size_t position_ = 0;
+};
+
+[[noreturn]] void corrupt(std::uint64_t offset, std::string_view what) {
+  throw std::runtime_error(
+      fmt::format("binary log: {} at offset {}", what, offset));
+}
+
+[[nodiscard]] auto asText(std::span<const std::byte> bytes)
+    -> std::string_view {
+  return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+/// Read an integer of `size` bytes at `data` and widen it to `T`.
+template <typename T>
+auto readInteger(const std::byte *data, std::uint32_t size) -> T {
+  switch (size) {
+  case 1: {
+    using Narrow = std::conditional_t<std::is_signed_v<T>, std::int8_t,
+                                      std::uint8_t>;
+    Narrow value = 0;
+    std::memcpy(&value, data, size);
+    return value;
+  }
+  case 2: {
+    using Narrow = std::conditional_t<std::is_signed_v<T>, std::int16_t,
+                                      std::uint16_t>;
+    Narrow value = 0;
+    std::memcpy(&value, data, size);
+    return value;
+  }
+  case 4: {
+    using Narrow = std::conditional_t<std::is_signed_v<T>, std::int32_t,
+                                      std::uint32_t>;
+    Narrow value = 0;
+    std::memcpy(&value, data, size);
+    return value;
+  }
+  default: {
+    T value = 0;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+  }
+}
+
+/// Whether `arg` has a layout this decoder understands.
+[[nodiscard]] auto isDecodable(const DeferredArg &arg) -> bool {
+  switch (arg.kind) {
+  case ArgKind::Bool:
+  case ArgKind::Char:
+    return arg.size == 1;
+  case ArgKind::Signed:
+  case ArgKind::Unsigned:
+    return arg.size == 1 || arg.size == 2 || arg.size == 4 || arg.size == 8;
+  case ArgKind::Float:
+    return arg.size == 4 || arg.size == 8;
+  case ArgKind::Pointer:
+    return arg.size == sizeof(void *);
+  case ArgKind::String:
+    return arg.size == sizeof(std::size_t);
+  case ArgKind::Other:
+    return true;
+  }
+  return false;
+}
+
+/// Decode the arguments in `payload` laid out as `args`.
+auto decodeArgs(std::span<const DeferredArg> args,
+                std::span<const std::byte> payload, std::uint64_t offset)
+    -> std::vector<Value> {
+  std::vector<Value> values;
+  values.reserve(args.size());
+  std::size_t position = 0;
+  for (const DeferredArg &arg : args) {
+    if (payload.size() - position < arg.size) {
+      corrupt(offset, "truncated arguments");
+    }
+    const std::byte *data = payload.data() + position;
+    position += arg.size;
+    switch (arg.kind) {
+    case ArgKind::Bool:
+      values.emplace_back(std::to_integer<std::uint8_t>(*data) != 0);
+      break;
+    case ArgKind::Char:
+      values.emplace_back(static_cast<char>(*data));
+      break;
+    case ArgKind::Signed:
+      values.emplace_back(readInteger<std::int64_t>(data, arg.size));
+      break;
+    case ArgKind::Unsigned:
+      values.emplace_back(readInteger<std::uint64_t>(data, arg.size));
+      break;
+    case ArgKind::Float:
+      if (arg.size == sizeof(float)) {
+        float value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        values.emplace_back(static_cast<double>(value));
+      } else {
+        double value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        values.emplace_back(value);
+      }
+      break;
+    case ArgKind::Pointer: {
+      const void *value = nullptr;
+      std::memcpy(&value, data, sizeof(value));
+      values.emplace_back(value);
+      break;
+    }
+    case ArgKind::String: {
+      std::size_t size = 0;
+      std::memcpy(&size, data, sizeof(size));
+      if (payload.size() - position < size) {
+        corrupt(offset, "truncated string argument");
+      }
+      values.emplace_back(asText(payload.subspan(position, size)));
+      position += size;
+      break;
+    }
+    case ArgKind::Other:
+      values.emplace_back(Opaque{arg.size});
+      break;
+    }
+  }
+  return values;
+}
+
+/// Format `pattern` with `values` as the logger would have.
+void appendMessage(std::string_view pattern, const std::vector<Value> &values,
+                   fmt::memory_buffer &out) {
+  fmt::dynamic_format_arg_store<fmt::format_context> store;
+  for (const Value &value : values) {
+    std::visit(
+        [&store](const auto &arg) {
+          if constexpr (std::same_as<std::decay_t<decltype(arg)>, Opaque>) {
+            store.push_back(fmt::format("<{} bytes>", arg.size));
+          } else {
+            store.push_back(arg);
+          }
+        },
+        value);
+  }
+  const std::size_t start = out.size();
+  try {
+    fmt::vformat_to(std::back_inserter(out), pattern, store);
+  } catch (const fmt::format_error &error) {
+    out.resize(start);
+    fmt::format_to(std::back_inserter(out), "[logDecode: {}: {}]", pattern,
+                   error.what());
+  }
+}
+
+/// Append `value` to `out` as a field value in `style`.
+void appendValue(const Value &value, FieldStyle style,
+                 fmt::memory_buffer &out) {
+  std::visit(
+      [style, &out](const auto &arg) {
+        if constexpr (std::same_as<std::decay_t<decltype(arg)>, Opaque>) {
+          if (style == FieldStyle::Json) {
+            out.append(std::string_view{"null"});
+          } else {
+            detail::appendFieldText(fmt::format("<{} bytes>", arg.size),
+                                    style, out);
+          }
+        } else {
+          detail::appendFieldValue(arg, style, out);
+        }
+      },
+      value);
+}
+
+/// Append the fields of a structured record's `values` to `out` in `style`.
+void appendFields(const std::vector<Value> &values, FieldStyle style,
+                  fmt::memory_buffer &out) {
+  for (std::size_t i = 1; i + 1 < values.size(); i += 2) {
+    detail::appendFieldKey(std::get<std::string_view>(values[i]), style, out);
+    appendValue(values[i + 1], style, out);
+  }
+}
+
+/// Whether `args` is the layout of a structured record: a string message,
+/// then pairs of a string key and a value.
+[[nodiscard]] auto isStructuredLayout(std::span<const DeferredArg> args)
+    -> bool {
+  if (args.size() % 2 == 0 || args.front().kind != ArgKind::String) {
+    return false;
+  }
+  for (std::size_t i = 1; i < args.size(); i += 2) {
+    if (args[i].kind != ArgKind::String) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+BinaryLogDecoder::BinaryLogDecoder(DecodeFormat format) : format_{format} {}
+
+auto BinaryLogDecoder::decode(std::span<const std::byte> input,
+                              fmt::memory_buffer &out) -> std::size_t {
+  if (!started_ && !lz4_) {
+    if (input.size() < sizeof(std::uint32_t)) {
+      return 0;
+    }
+    if (Lz4Decoder::startsFrame(input)) {
+      lz4_.emplace();
+    }
+  }
+  if (!lz4_) {
+    return decodeFrames(input, out);
+  }
+  const std::size_t consumed = lz4_->decode(input, plain_);
+  const std::size_t used = decodeFrames(
+      std::as_bytes(std::span{plain_.data(), plain_.size()}), out);
+  std::memmove(plain_.data(), plain_.data() + used, plain_.size() - used);
+  plain_.resize(plain_.size() - used);
+  return consumed;
+}
+
+auto BinaryLogDecoder::decodeFrames(std::span<const std::byte> input,
+                                    fmt::memory_buffer &out) -> std::size_t {
+  std::size_t consumed = 0;
+  while (consumed < input.size()) {
+    const std::size_t used = decodeFrame(input.subspan(consumed), out);
+    if (used == 0) {
+      break;
+    }
+    consumed += used;
+    offset_ += used;
+  }
+  return consumed;
+}
+
+auto BinaryLogDecoder::decodeFrame(std::span<const std::byte> input,
+                                   fmt::memory_buffer &out) -> std::size_t {
+  using binary::FrameKind;
+  Reader reader{input};
+  FrameKind kind{};
+  if (!reader.read(kind)) {
+    return 0;
+  }
+  if (!started_ && kind != FrameKind::Session) {
+    corrupt(offset_, "missing session header (not a binary log?)");
+  }
+  switch (kind) {
+  case FrameKind::Session: {
+    std::span<const std::byte> magic;
+    if (!reader.read(binary::SessionMagic.size() - 1, magic)) {
+      return 0;
+    }
+    if (asText(magic) != binary::SessionMagic.substr(1)) {
+      corrupt(offset_, "bad session header");
+    }
+    started_ = true;
+    definitions_.clear();
+    return reader.position();
+  }
+  case FrameKind::Definition: {
+    std::uint32_t id = 0;
+    std::uint8_t flags = 0;
+    std::uint32_t patternSize = 0;
+    std::span<const std::byte> pattern;
+    std::uint8_t argCount = 0;
+    if (!reader.read(id) || !reader.read(flags) || !reader.read(patternSize) ||
+        !reader.read(patternSize, pattern) || !reader.read(argCount)) {
+      return 0;
+    }
+    Definition definition{std::string{asText(pattern)}, {},
+                          (flags & binary::Structured) != 0};
+    for (std::uint8_t i = 0; i < argCount; ++i) {
+      DeferredArg arg{};
+      if (!reader.read(arg.kind) || !reader.read(arg.size)) {
+        return 0;
+      }
+      if (!isDecodable(arg)) {
+        corrupt(offset_, "unknown argument layout");
+      }
+      definition.args.push_back(arg);
+    }
+    if (definition.structured && !isStructuredLayout(definition.args)) {
+      corrupt(offset_, "malformed structured definition");
+    }
+    definitions_.insert_or_assign(id, std::move(definition));
+    return reader.position();
+  }
+  case FrameKind::Record:
+    break;
+  default:
+    corrupt(offset_, "unknown frame kind");
+  }
+
+  std::uint32_t id = 0;
+  Level level{};
+  std::int64_t timestamp = 0;
+  std::uint32_t payloadSize = 0;
+  std::span<const std::byte> payload;
+  if (!reader.read(id) || !reader.read(level) || !reader.read(timestamp) ||
+      !reader.read(payloadSize) || !reader.read(payloadSize, payload)) {
+    return 0;
+  }
+  const Definition *definition = nullptr;
+  std::vector<Value> values;
+  if (id != binary::TextId) {
+    const auto entry = definitions_.find(id);
+    if (entry == definitions_.end()) {
+      corrupt(offset_, "record refers to an undefined format");
+    }
+    definition = &entry->second;
+    values = decodeArgs(definition->args, payload, offset_);
+  }
+  const std::chrono::sys_time<std::chrono::nanoseconds> time{
+      std::chrono::nanoseconds{timestamp}};
+
+  const bool structured = definition != nullptr && definition->structured;
+  fmt::memory_buffer message;
+  if (definition == nullptr) {
+    const std::string_view text = asText(payload);
+    message.append(text.data(), text.data() + text.size());
+  } else if (structured) {
+    const auto text = std::get<std::string_view>(values.front());
+    message.append(text.data(), text.data() + text.size());
+  } else {
+    appendMessage(definition->pattern, values, message);
+  }
+  const std::string_view messageText{message.data(), message.size()};
+
+  if (format_ == DecodeFormat::Text) {
+    if (timestamp != 0) {
+      appendTimestamp(time, out);
+      out.push_back(' ');
+    }
+    out.append(messageText.data(), messageText.data() + messageText.size());
+    if (structured) {
+      appendFields(values, FieldStyle::Logfmt, out);
+    }
+    out.push_back('\n');
+    return reader.position();
+  }
+
+  out.push_back('{');
+  if (timestamp != 0) {
+    fmt::memory_buffer stamp;
+    appendTimestamp(time, stamp);
+    fmt::format_to(std::back_inserter(out), "\"time\":\"{}\",",
+                   std::string_view{stamp.data(), stamp.size()});
+  }
+  fmt::format_to(std::back_inserter(out), "\"level\":\"{}\",\"message\":",
+                 toString(level));
+  detail::appendJsonString(messageText, out);
+  if (structured) {
+    appendFields(values, FieldStyle::Json, out);
+  } else if (definition != nullptr) {
+    fmt::format_to(std::back_inserter(out), ",\"pattern\":");
+    detail::appendJsonString(definition->pattern, out);
+    fmt::format_to(std::back_inserter(out), ",\"args\":[");
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (i != 0) {
+        out.push_back(',');
+      }
+      appendValue(values[i], FieldStyle::Json, out);
+    }
+    out.push_back(']');
+  }
+  fmt::format_to(std::back_inserter(out), "}}\n");
+  return reader.position();
+}
+
+} // namespace sample::logger
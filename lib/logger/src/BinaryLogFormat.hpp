@@ -0,0 +1,71 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace sample::logger::binary {
+
+// Layout of the binary log stream (private); see `BinaryLogDecoder.hpp` for
+// the description of record contents.
+//
+// A stream is a sequence of frames, each starting with a `FrameKind` byte:
+//
+// - `Session` (the 8 bytes `SLOGBIN\x01`): starts a logger's output and
+//   clears the format dictionary, so several sessions may be appended to one
+//   file.
+// - `Definition`: u32 id, u8 `DefinitionFlags`, u32 pattern size, the
+//   pattern, u8 argument count, then per argument a u8 `ArgKind` and a u32
+//   encoded size.
+// - `Record`: u32 id (`TextId` for a plain message), u8 `Level`, i64
+//   nanoseconds since the Unix epoch (0 if timestamps are off), u32 payload
+//   size, then the payload: the text, or the arguments encoded as by
+//   `ILogger::logf()`.
+//
+// Integers are little-endian and string lengths inside payloads are 64-bit,
+// which matches the in-memory encoding on every supported platform.
+
+static_assert(std::endian::native == std::endian::little &&
+                  sizeof(std::size_t) == 8,
+              "the binary log format assumes a little-endian 64-bit target");
+
+/// First byte of every frame.
+enum class FrameKind : std::uint8_t {
+  Session = 'S',
+  Definition = 'D',
+  Record = 'R',
+};
+
+/// Bits of a definition's flags byte.
+enum DefinitionFlags : std::uint8_t {
+  /// A structured `log()`: the arguments are the message, then a key and a
+  /// value per field.
+  Structured = 1U << 0U,
+};
+
+/// The session frame, kind byte included.
+inline constexpr std::string_view SessionMagic{"SLOGBIN\x01", 8};
+
+/// Record id of a plain-text message (no definition).
+inline constexpr std::uint32_t TextId = 0;
+
+/// Append the bytes of `value` to `out`.
+template <typename T> void put(fmt::memory_buffer &out, const T &value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  std::array<char, sizeof(T)> raw{};
+  std::memcpy(raw.data(), &value, sizeof(T));
+  out.append(raw.data(), raw.data() + raw.size());
+}
+
+/// Append `text` to `out`.
+inline void putBytes(fmt::memory_buffer &out, std::string_view text) {
+  out.append(text.data(), text.data() + text.size());
+}
+
+} // namespace sample::logger::binary
@@ -1,6 +1,12 @@
+#include "StatsCounters.hpp"
+
+#include <logger/ConsoleSink.hpp>
 #include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+#include <logger/RateLimit.hpp>
 
-#include <iostream>
 #include <memory>
 #include <string_view>
 
@@ -10,16 +16,35 @@ namespace {
 
 /// Console logger implementation (private).
 ///
-/// Writes log messages to stdout.
+/// Writes log messages to stdout through `ConsoleSink`, counting them in
+/// `StripedCounters` for `stats()`. Every message is written before `log()`
+/// returns, so the default `flush()` suffices.
 class ConsoleLogger final : public ILogger {
 public:
-  void log(std::string_view message) override { std::cout << message << '\n'; }
+  explicit ConsoleLogger(const RateLimitConfig &rateLimit)
+      : ILogger{rateLimit} {}
+
+  [[nodiscard]] auto stats() const -> LoggerStats override {
+    LoggerStats result{.dropped = droppedMessages()};
+    counters_.addTo(result);
+    return result;
+  }
+
+private:
+  void write(Level level, std::string_view message) override {
+    sink_.write(level, message);
+    counters_.countRecord(message.size() + 1);
+  }
+
+  [[no_unique_address]] ConsoleSink sink_;
+  StripedCounters counters_;
 };
 
 } // anonymous namespace
 
-auto createDefaultLogger() -> std::unique_ptr<ILogger> {
-  return std::make_unique<ConsoleLogger>();
+auto createDefaultLogger(const RateLimitConfig &rateLimit)
+    -> std::unique_ptr<ILogger> {
+  return std::make_unique<ConsoleLogger>(rateLimit);
 }
 
 } // namespace sample::logger
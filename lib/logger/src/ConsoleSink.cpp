@@ -0,0 +1,25 @@
+#include "FdSink.hpp"
+
+#include <logger/ConsoleSink.hpp>
+#include <logger/LogLevel.hpp>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <array>
+#include <string_view>
+
+namespace sample::logger {
+
+void ConsoleSink::write(Level /*level*/, std::string_view message) const {
+  static constexpr char Newline = '\n';
+  // writev() does not write through iov_base.
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-const-cast)
+  std::array<::iovec, 2> parts{
+      {{const_cast<char *>(message.data()), message.size()},
+       {const_cast<char *>(&Newline), 1}}};
+  // NOLINTEND(cppcoreguidelines-pro-type-const-cast)
+  writeFully(STDOUT_FILENO, parts);
+}
+
+} // namespace sample::logger
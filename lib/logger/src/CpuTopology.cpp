@@ -0,0 +1,169 @@
+#include "CpuTopology.hpp"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace sample::logger {
+
+namespace {
+
+/// `MPOL_PREFERRED` from `<linux/mempolicy.h>`: allocate on the given node
+/// while it has free pages, elsewhere after that.
+constexpr int MpolPreferred = 1;
+
+/// Read the whole of a small (sysfs) file, or return an empty string.
+auto readSmallFile(const std::filesystem::path &path) -> std::string {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return {};
+  }
+  std::string text;
+  std::array<char, 4096> chunk{};
+  for (;;) {
+    const ::ssize_t count = ::read(fd, chunk.data(), chunk.size());
+    if (count <= 0) {
+      break;
+    }
+    text.append(chunk.data(), static_cast<std::size_t>(count));
+  }
+  ::close(fd);
+  return text;
+}
+
+/// Parse a kernel CPU list such as `0-3,8,10-11`; stops at the first
+/// malformed entry.
+auto parseCpuList(std::string_view text) -> std::vector<unsigned> {
+  std::vector<unsigned> cpus;
+  const char *cursor = text.data();
+  const char *const end = text.data() + text.size();
+  while (cursor != end) {
+    unsigned first = 0;
+    std::from_chars_result parsed = std::from_chars(cursor, end, first);
+    if (parsed.ec != std::errc{}) {
+      break;
+    }
+    unsigned last = first;
+    if (parsed.ptr != end && *parsed.ptr == '-') {
+      parsed = std::from_chars(parsed.ptr + 1, end, last);
+      if (parsed.ec != std::errc{}) {
+        break;
+      }
+    }
+    const char *const next = parsed.ptr;
+    for (unsigned cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+    cursor = next != end && *next == ',' ? next + 1 : end;
+  }
+  return cpus;
+}
+
+} // anonymous namespace
+
+auto allowedCpus() -> std::vector<unsigned> {
+  ::cpu_set_t set;
+  CPU_ZERO(&set);
+  std::vector<unsigned> cpus;
+  if (::sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+auto numaNodes() -> std::vector<NumaNode> {
+  const std::vector<unsigned> allowed = allowedCpus();
+  std::vector<NumaNode> nodes;
+  std::error_code error;
+  for (const auto &entry : std::filesystem::directory_iterator{
+           "/sys/devices/system/node", error}) {
+    const std::string name = entry.path().filename().string();
+    unsigned id = 0;
+    if (!name.starts_with("node") ||
+        std::from_chars(name.data() + 4, name.data() + name.size(), id).ec !=
+            std::errc{}) {
+      continue;
+    }
+    NumaNode node{.id = id, .cpus = {}};
+    for (const unsigned cpu :
+         parseCpuList(readSmallFile(entry.path() / "cpulist"))) {
+      if (std::ranges::binary_search(allowed, cpu)) {
+        node.cpus.push_back(cpu);
+      }
+    }
+    if (!node.cpus.empty()) {
+      nodes.push_back(std::move(node));
+    }
+  }
+  if (nodes.empty()) {
+    nodes.push_back({.id = 0, .cpus = allowed});
+  }
+  std::ranges::sort(nodes, {}, &NumaNode::id);
+  return nodes;
+}
+
+auto currentNumaNode() -> unsigned {
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return node;
+}
+
+void pinCurrentThread(std::span<const unsigned> cpus) noexcept {
+  ::cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const unsigned cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  static_cast<void>(
+      ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set));
+}
+
+auto mapOnNode(std::size_t bytes, unsigned node) -> void * {
+  void *memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  // No page has been touched yet, so the policy decides where every page
+  // goes. A kernel without NUMA support refuses; the memory is still usable.
+  constexpr std::size_t MaskBits = 64;
+  if (node < MaskBits) {
+    const std::uint64_t mask = std::uint64_t{1} << node;
+    static_cast<void>(::syscall(SYS_mbind, memory, bytes, MpolPreferred,
+                                &mask, MaskBits + 1, 0U));
+  }
+  return memory;
+}
+
+void unmapFromNode(void *memory, std::size_t bytes) noexcept {
+  ::munmap(memory, bytes);
+}
+
+} // namespace sample::logger
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sample::logger {
+
+/// A NUMA node and the CPUs on it the process may run on (private).
+struct NumaNode {
+  unsigned id = 0;
+  std::vector<unsigned> cpus;
+};
+
+/// CPUs the calling thread may run on, from `sched_getaffinity(2)`
+/// (private).
+[[nodiscard]] auto allowedCpus() -> std::vector<unsigned>;
+
+/// The NUMA nodes with at least one allowed CPU, by ascending id (private).
+///
+/// Read from `/sys/devices/system/node`; a machine (or container) that does
+/// not expose it is reported as node 0 holding every allowed CPU.
+[[nodiscard]] auto numaNodes() -> std::vector<NumaNode>;
+
+/// The NUMA node of the CPU the calling thread is running on (private).
+///
+/// A snapshot: the thread may migrate right after. 0 if unknown.
+[[nodiscard]] auto currentNumaNode() -> unsigned;
+
+/// Restrict the calling thread to `cpus` (private).
+///
+/// Best effort: the CPUs are checked against `allowedCpus()` when the logger
+/// is configured, and a thread has nowhere to report a later failure.
+void pinCurrentThread(std::span<const unsigned> cpus) noexcept;
+
+/// Storage for `size` default-constructed `T`, optionally in pages bound to
+/// a NUMA node (private).
+///
+/// Without a node this is a plain `new T[]`. With one, the array gets a
+/// mapping of its own whose pages the kernel prefers to take from `node`
+/// when they are first touched, which the constructors do at once.
+template <typename T> class NodeLocalArray {
+public:
+  NodeLocalArray(std::size_t size, std::optional<unsigned> node);
+  ~NodeLocalArray();
+
+  NodeLocalArray(const NodeLocalArray &) = delete;
+  auto operator=(const NodeLocalArray &) -> NodeLocalArray & = delete;
+  NodeLocalArray(NodeLocalArray &&) = delete;
+  auto operator=(NodeLocalArray &&) -> NodeLocalArray & = delete;
+
+  [[nodiscard]] auto operator[](std::size_t index) -> T & {
+    return data_[index];
+  }
+
+  [[nodiscard]] auto operator[](std::size_t index) const -> const T & {
+    return data_[index];
+  }
+
+private:
+  std::size_t size_;
+  std::unique_ptr<T[]> heap_;
+  T *mapped_ = nullptr;
+  T *data_ = nullptr;
+};
+
+/// Map `bytes` of zeroed memory whose pages prefer NUMA node `node`
+/// (private).
+///
+/// ## Throws
+/// `std::bad_alloc` if the mapping cannot be made.
+[[nodiscard]] auto mapOnNode(std::size_t bytes, unsigned node) -> void *;
+
+/// Unmap memory from `mapOnNode()` (private).
+void unmapFromNode(void *memory, std::size_t bytes) noexcept;
+
+template <typename T>
+NodeLocalArray<T>::NodeLocalArray(std::size_t size,
+                                  std::optional<unsigned> node)
+    : size_{size} {
+  if (!node) {
+    heap_ = std::make_unique<T[]>(size_);
+    data_ = heap_.get();
+    return;
+  }
+  void *memory = mapOnNode(size_ * sizeof(T), *node);
+  data_ = static_cast<T *>(memory);
+  std::size_t constructed = 0;
+  try {
+    for (; constructed < size_; ++constructed) {
+      new (data_ + constructed) T();
+    }
+  } catch (...) {
+    while (constructed-- > 0) {
+      data_[constructed].~T();
+    }
+    unmapFromNode(memory, size_ * sizeof(T));
+    throw;
+  }
+  mapped_ = data_;
+}
+
+template <typename T> NodeLocalArray<T>::~NodeLocalArray() {
+  if (mapped_ == nullptr) {
+    return;
+  }
+  for (std::size_t index = 0; index < size_; ++index) {
+    mapped_[index].~T();
+  }
+  unmapFromNode(mapped_, size_ * sizeof(T));
+}
+
+} // namespace sample::logger
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+
+namespace sample::logger {
+
+/// A logger whose queued records the crash handler can write out
+/// (private); see `installCrashHandler()`.
+class CrashDrainable {
+public:
+  CrashDrainable(const CrashDrainable &) = delete;
+  auto operator=(const CrashDrainable &) -> CrashDrainable & = delete;
+  CrashDrainable(CrashDrainable &&) = delete;
+  auto operator=(CrashDrainable &&) -> CrashDrainable & = delete;
+
+  /// Have every record queued so far written to the output, giving up at
+  /// `deadline`.
+  ///
+  /// Runs in a signal handler on the crashing thread: may only use
+  /// async-signal-safe operations (atomics, futexes, `clock_gettime`).
+  virtual void drainForCrash(
+      std::chrono::steady_clock::time_point deadline) noexcept = 0;
+
+protected:
+  CrashDrainable() = default;
+  ~CrashDrainable() = default;
+};
+
+/// Most loggers drained at once; later ones are not drained on a crash.
+inline constexpr int MaxCrashDrainables = 64;
+
+/// Have the crash handler drain `logger` until `unregisterCrashDrain()`.
+void registerCrashDrain(CrashDrainable &logger) noexcept;
+
+/// Stop draining `logger`; call before it starts to shut down.
+void unregisterCrashDrain(CrashDrainable &logger) noexcept;
+
+/// Kernel thread id of the calling thread; async-signal-safe.
+[[nodiscard]] auto currentThreadId() noexcept -> int;
+
+} // namespace sample::logger
@@ -0,0 +1,111 @@
+#include "CrashDrain.hpp"
+
+#include <logger/CrashHandler.hpp>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <system_error>
+
+namespace sample::logger {
+
+namespace {
+
+/// Signals the crash handler is installed for.
+constexpr std::array HandledSignals{SIGSEGV, SIGBUS,  SIGFPE,
+                                    SIGILL,  SIGABRT, SIGTERM};
+
+/// Loggers to drain; null slots are free.
+std::array<std::atomic<CrashDrainable *>, MaxCrashDrainables> drainables{};
+
+/// `installCrashHandler()`'s timeout, in nanoseconds.
+std::atomic<std::int64_t> drainTimeoutNanos{0};
+
+/// Dispositions from before `installCrashHandler()`, by `HandledSignals`
+/// index; written once, before any handler can run.
+std::array<struct ::sigaction, HandledSignals.size()> previousActions{};
+
+std::once_flag installed;
+
+/// The signal handler: drain every logger, then re-raise `signal` under its
+/// previous disposition.
+void onFatalSignal(int signal) {
+  const int savedErrno = errno;
+  const auto deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::nanoseconds{
+          drainTimeoutNanos.load(std::memory_order_relaxed)};
+  for (std::atomic<CrashDrainable *> &slot : drainables) {
+    if (CrashDrainable *logger = slot.load(std::memory_order_acquire)) {
+      logger->drainForCrash(deadline);
+    }
+  }
+  for (std::size_t index = 0; index < HandledSignals.size(); ++index) {
+    if (HandledSignals[index] == signal) {
+      ::sigaction(signal, &previousActions[index], nullptr);
+    }
+  }
+  errno = savedErrno;
+  ::raise(signal);
+}
+
+} // anonymous namespace
+
+void registerCrashDrain(CrashDrainable &logger) noexcept {
+  for (std::atomic<CrashDrainable *> &slot : drainables) {
+    CrashDrainable *expected = nullptr;
+    if (slot.compare_exchange_strong(expected, &logger,
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+void unregisterCrashDrain(CrashDrainable &logger) noexcept {
+  for (std::atomic<CrashDrainable *> &slot : drainables) {
+    CrashDrainable *expected = &logger;
+    if (slot.compare_exchange_strong(expected, nullptr,
+                                     std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+auto currentThreadId() noexcept -> int {
+  return static_cast<int>(::syscall(SYS_gettid));
+}
+
+void installCrashHandler(std::chrono::milliseconds drainTimeout) {
+  drainTimeoutNanos.store(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(drainTimeout)
+          .count(),
+      std::memory_order_relaxed);
+  std::call_once(installed, [] {
+    struct ::sigaction action{};
+    action.sa_handler = &onFatalSignal;
+    ::sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_ONSTACK;
+    for (std::size_t index = 0; index < HandledSignals.size(); ++index) {
+      if (::sigaction(HandledSignals[index], &action,
+                      &previousActions[index]) != 0) {
+        const int error = errno;
+        while (index-- > 0) {
+          ::sigaction(HandledSignals[index], &previousActions[index], nullptr);
+        }
+        throw std::system_error(error, std::generic_category(),
+                                "cannot install crash handler");
+      }
+    }
+  });
+}
+
+} // namespace sample::logger
@@ -0,0 +1,124 @@
+#include "CycleClock.hpp"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+
+namespace sample::logger {
+
+namespace {
+
+/// Signed difference `to - from` of two counter readings.
+[[nodiscard]] auto cycleDelta(std::uint64_t from, std::uint64_t to)
+    -> std::int64_t {
+  return static_cast<std::int64_t>(to - from);
+}
+
+/// Write the `DateTimeLength` characters of `second` to `out`.
+void formatDateTime(std::chrono::sys_seconds second, char *out) {
+  using namespace std::chrono;
+  const auto day = floor<days>(second);
+  const year_month_day date{day};
+  const hh_mm_ss timeOfDay{second - day};
+  fmt::format_to_n(out, DateTimeLength, "{:04}-{:02}-{:02}T{:02}:{:02}:{:02}",
+                   static_cast<int>(date.year()),
+                   static_cast<unsigned>(date.month()),
+                   static_cast<unsigned>(date.day()), timeOfDay.hours().count(),
+                   timeOfDay.minutes().count(), timeOfDay.seconds().count());
+}
+
+/// Append the fractional second and terminator of `time` to `out`.
+void appendFraction(std::chrono::sys_time<std::chrono::nanoseconds> time,
+                    std::chrono::sys_seconds second, fmt::memory_buffer &out) {
+  fmt::format_to(std::back_inserter(out), ".{:09}Z", (time - second).count());
+}
+
+} // anonymous namespace
+
+void appendTimestamp(std::chrono::sys_time<std::chrono::nanoseconds> time,
+                     fmt::memory_buffer &out) {
+  const auto second = std::chrono::floor<std::chrono::seconds>(time);
+  std::array<char, DateTimeLength> dateTime{};
+  formatDateTime(second, dateTime.data());
+  out.append(dateTime.data(), dateTime.data() + dateTime.size());
+  appendFraction(time, second, out);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+CycleClock::CycleClock()
+    : startCycles_{readCycleCounter()},
+      startTime_{std::chrono::steady_clock::now()} {}
+#else
+CycleClock::CycleClock() = default;
+#endif
+
+auto CycleClock::toWallClock(std::uint64_t cycles)
+    -> std::chrono::sys_time<std::chrono::nanoseconds> {
+  if (!calibrated_ || std::chrono::steady_clock::now() >= nextCalibration_) {
+    calibrate();
+  }
+  const auto offset = static_cast<std::int64_t>(
+      static_cast<double>(cycleDelta(anchorCycles_, cycles)) *
+      nanosPerCycle_);
+  return anchorTime_ + std::chrono::nanoseconds{offset};
+}
+
+auto CycleClock::elapsed(std::uint64_t from, std::uint64_t to)
+    -> std::chrono::nanoseconds {
+  if (!calibrated_) {
+    calibrate();
+  }
+  const std::int64_t cycles = cycleDelta(from, to);
+  if (cycles <= 0) {
+    return std::chrono::nanoseconds::zero();
+  }
+  return std::chrono::nanoseconds{static_cast<std::int64_t>(
+      static_cast<double>(cycles) * nanosPerCycle_)};
+}
+
+void CycleClock::calibrate() {
+  using std::chrono::steady_clock;
+#if defined(__aarch64__)
+  std::uint64_t frequency = 0;
+  asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+  nanosPerCycle_ = 1e9 / static_cast<double>(frequency);
+  const auto now = steady_clock::now();
+#elif defined(__x86_64__) || defined(__i386__)
+  auto now = steady_clock::now();
+  std::uint64_t cycles = readCycleCounter();
+  while (now - startTime_ < MinCalibration) {
+    now = steady_clock::now();
+    cycles = readCycleCounter();
+  }
+  const std::chrono::nanoseconds elapsed = now - startTime_;
+  nanosPerCycle_ = static_cast<double>(elapsed.count()) /
+                   static_cast<double>(cycleDelta(startCycles_, cycles));
+#else
+  nanosPerCycle_ = static_cast<double>(steady_clock::period::num) * 1e9 /
+                   static_cast<double>(steady_clock::period::den);
+  const auto now = steady_clock::now();
+#endif
+  anchorCycles_ = readCycleCounter();
+  anchorTime_ = std::chrono::time_point_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now());
+  nextCalibration_ = now + RecalibrationInterval;
+  calibrated_ = true;
+}
+
+void TimestampFormatter::append(std::uint64_t cycles,
+                                fmt::memory_buffer &out) {
+  const auto time = clock_.toWallClock(cycles);
+  const auto second = std::chrono::floor<std::chrono::seconds>(time);
+  if (!hasCachedPrefix_ || second != cachedSecond_) {
+    formatDateTime(second, cachedPrefix_.data());
+    cachedSecond_ = second;
+    hasCachedPrefix_ = true;
+  }
+  out.append(cachedPrefix_.data(), cachedPrefix_.data() + cachedPrefix_.size());
+  appendFraction(time, second, out);
+}
+
+} // namespace sample::logger
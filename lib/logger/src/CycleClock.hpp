@@ -0,0 +1,106 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace sample::logger {
+
+/// Read the CPU's free-running cycle counter (private).
+///
+/// `rdtsc` on x86 and the virtual counter `cntvct_el0` on arm64, each a few
+/// nanoseconds and neither a system call; other architectures fall back to
+/// `std::chrono::steady_clock`. The unit is architecture-specific: convert
+/// readings with `CycleClock`. Assumes an invariant TSC on x86, as on every
+/// CPU of the last decade.
+[[nodiscard]] inline auto readCycleCounter() noexcept -> std::uint64_t {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t value = 0;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/// Converts `readCycleCounter()` values to wall-clock time (private).
+///
+/// Keeps an anchor pairing a counter reading with `system_clock` and the
+/// counter's rate. On x86 the rate is measured against `steady_clock`: the
+/// first conversion waits until at least `MinCalibration` has passed since
+/// construction, and later conversions refine the rate over the whole
+/// lifetime. On arm64 the rate is read from `cntfrq_el0`. The anchor is
+/// renewed every `RecalibrationInterval` so wall-clock adjustments are
+/// followed. Not thread-safe: owned by one backend thread.
+class CycleClock {
+public:
+  /// Shortest interval the initial rate is measured over.
+  static constexpr std::chrono::milliseconds MinCalibration{1};
+
+  /// How often the anchor and the rate are refreshed.
+  static constexpr std::chrono::seconds RecalibrationInterval{1};
+
+  /// Start calibrating; cheap, the measurement finishes on first use.
+  CycleClock();
+
+  /// Wall-clock time at which `cycles` was read.
+  [[nodiscard]] auto toWallClock(std::uint64_t cycles)
+      -> std::chrono::sys_time<std::chrono::nanoseconds>;
+
+  /// Time between the readings `from` and `to`; zero if `to` is earlier.
+  ///
+  /// Uses the rate measured by the latest calibration, but unlike
+  /// `toWallClock()` never recalibrates after the first, so it costs no
+  /// clock read.
+  [[nodiscard]] auto elapsed(std::uint64_t from, std::uint64_t to)
+      -> std::chrono::nanoseconds;
+
+private:
+  void calibrate();
+
+#if defined(__x86_64__) || defined(__i386__)
+  std::uint64_t startCycles_;
+  std::chrono::steady_clock::time_point startTime_;
+#endif
+  std::uint64_t anchorCycles_ = 0;
+  std::chrono::sys_time<std::chrono::nanoseconds> anchorTime_{};
+  std::chrono::steady_clock::time_point nextCalibration_{};
+  double nanosPerCycle_ = 0.0;
+  bool calibrated_ = false;
+};
+
+/// Length of the date and time of day in a timestamp,
+/// `YYYY-MM-DDTHH:MM:SS`.
+inline constexpr std::size_t DateTimeLength = 19;
+
+/// Append `time` to `out` as `YYYY-MM-DDTHH:MM:SS.nnnnnnnnnZ`.
+void appendTimestamp(std::chrono::sys_time<std::chrono::nanoseconds> time,
+                     fmt::memory_buffer &out);
+
+/// Formats counter readings as UTC timestamps (private).
+///
+/// Produces the same text as `appendTimestamp()`; the date and time of day
+/// are formatted once per second and reused.
+class TimestampFormatter {
+public:
+  /// Append the timestamp of `cycles` to `out`.
+  void append(std::uint64_t cycles, fmt::memory_buffer &out);
+
+private:
+  CycleClock clock_;
+  std::chrono::sys_seconds cachedSecond_{};
+  std::array<char, DateTimeLength> cachedPrefix_{};
+  bool hasCachedPrefix_ = false;
+};
+
+} // namespace sample::logger
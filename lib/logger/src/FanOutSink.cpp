@@ -0,0 +1,217 @@
+#include "FanOutSink.hpp"
+
+#include "FdSink.hpp"
+
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/LogLevel.hpp>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sample::logger {
+
+namespace {
+
+/// Upper bound on the batch capacity reserved up front.
+constexpr std::size_t MaxInitialReserve = 64 * 1024;
+
+} // anonymous namespace
+
+/// One destination of a `FanOutSink`.
+///
+/// Writes shared batches, inline or from its own thread, keeping only the
+/// records at or above its level. The thread is started by `start()`.
+class FanOutSink::Destination {
+public:
+  Destination(const FanOutTarget &config, std::size_t maxPending)
+      : fd_{openLogTarget(config.target, config.filePath)},
+        ownsFd_{config.target == LogTarget::File},
+        ownThread_{config.ownThread}, minLevel_{config.minLevel},
+        maxPending_{maxPending} {}
+
+  ~Destination() {
+    if (writer_.joinable()) {
+      {
+        const std::lock_guard lock{mutex_};
+        stopping_ = true;
+      }
+      ready_.notify_one();
+      writer_.join();
+    }
+    close();
+  }
+
+  Destination(const Destination &) = delete;
+  auto operator=(const Destination &) -> Destination & = delete;
+  Destination(Destination &&) = delete;
+  auto operator=(Destination &&) -> Destination & = delete;
+
+  /// Write `batch` now, or queue it for the destination's thread (waiting
+  /// while `maxPending` batches are already queued).
+  void deliver(const std::shared_ptr<const FanOutBatch> &batch) {
+    if (!writer_.joinable()) {
+      writeBatch(*batch);
+      return;
+    }
+    std::unique_lock lock{mutex_};
+    space_.wait(lock, [this] { return pending_.size() < maxPending_; });
+    pending_.push_back(batch);
+    lock.unlock();
+    ready_.notify_one();
+  }
+
+  /// Start the destination's thread, if it has one and it is not running.
+  ///
+  /// ## Throws
+  /// `std::system_error` if the thread cannot be started.
+  void start() {
+    if (ownThread_ && !writer_.joinable()) {
+      writer_ = std::thread{[this] { run(); }};
+    }
+  }
+
+  /// Whether batches are written by a thread of the destination's own.
+  [[nodiscard]] auto threaded() const -> bool { return ownThread_; }
+
+  /// Wait until the destination's thread has written every batch delivered
+  /// so far.
+  void sync() {
+    if (!writer_.joinable()) {
+      return;
+    }
+    std::unique_lock lock{mutex_};
+    space_.wait(lock, [this] { return pending_.empty() && !writing_; });
+  }
+
+private:
+  /// Destination thread body: write queued batches until stopped and idle.
+  void run() {
+    std::unique_lock lock{mutex_};
+    for (;;) {
+      ready_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      const std::shared_ptr<const FanOutBatch> batch =
+          std::move(pending_.front());
+      pending_.pop_front();
+      writing_ = true;
+      lock.unlock();
+      space_.notify_all();
+      writeBatch(*batch);
+      lock.lock();
+      writing_ = false;
+      space_.notify_all();
+    }
+  }
+
+  /// Write the records of `batch` at or above `minLevel_`, coalescing
+  /// adjacent ones into a single buffer.
+  void writeBatch(const FanOutBatch &batch) {
+    parts_.clear();
+    // writev() does not write through iov_base.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    char *text = const_cast<char *>(batch.text.data());
+    std::size_t start = 0;
+    bool previousKept = false;
+    for (const FanOutBatch::Line &line : batch.lines) {
+      const bool kept = line.level >= minLevel_;
+      if (kept && previousKept) {
+        parts_.back().iov_len += line.end - start;
+      } else if (kept) {
+        parts_.push_back({text + start, line.end - start});
+      }
+      previousKept = kept;
+      start = line.end;
+    }
+    writeFully(fd_, parts_);
+  }
+
+  void close() const {
+    if (ownsFd_) {
+      ::close(fd_);
+    }
+  }
+
+  int fd_;
+  bool ownsFd_;
+  bool ownThread_;
+  Level minLevel_;
+  std::size_t maxPending_;
+  std::vector<::iovec> parts_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable space_;
+  std::deque<std::shared_ptr<const FanOutBatch>> pending_;
+  bool writing_ = false;
+  bool stopping_ = false;
+  std::thread writer_;
+};
+
+FanOutSink::FanOutSink(const FanOutLoggerConfig &config)
+    : maxBatchBytes_{config.queue.maxBatchBytes} {
+  destinations_.reserve(config.targets.size());
+  for (const FanOutTarget &target : config.targets) {
+    destinations_.push_back(
+        std::make_unique<Destination>(target, config.maxPendingBatches));
+    synchronous_ = synchronous_ && !destinations_.back()->threaded();
+  }
+}
+
+FanOutSink::~FanOutSink() = default;
+
+void FanOutSink::start() {
+  for (const auto &destination : destinations_) {
+    destination->start();
+  }
+  if (!batch_) {
+    startBatch();
+  }
+}
+
+void FanOutSink::endRecord(Level level) {
+  batch_->lines.push_back({batch_->text.size(), level});
+}
+
+void FanOutSink::flush() {
+  if (batch_->lines.empty()) {
+    batch_->text.clear();
+    return;
+  }
+  const std::shared_ptr<const FanOutBatch> published = std::move(batch_);
+  for (const auto &destination : destinations_) {
+    destination->deliver(published);
+  }
+  startBatch();
+}
+
+void FanOutSink::write(std::string_view text) {
+  flush();
+  batch_->text.append(text.data(), text.data() + text.size());
+  endRecord(Level::Off);
+  flush();
+}
+
+void FanOutSink::sync() {
+  for (const auto &destination : destinations_) {
+    destination->sync();
+  }
+}
+
+void FanOutSink::startBatch() {
+  batch_ = std::make_shared<FanOutBatch>();
+  batch_->text.reserve(std::min(maxBatchBytes_, MaxInitialReserve));
+}
+
+} // namespace sample::logger
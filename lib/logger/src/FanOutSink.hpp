@@ -0,0 +1,105 @@
+#pragma once
+
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/LogLevel.hpp>
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace sample::logger {
+
+/// A formatted batch shared by the destinations of a `FanOutSink` (private).
+///
+/// Immutable once published: every destination writes straight from `text`.
+struct FanOutBatch {
+  /// End offset in `text` and level of one record.
+  struct Line {
+    std::size_t end;
+    Level level;
+  };
+
+  fmt::memory_buffer text;
+  std::vector<Line> lines;
+};
+
+/// Batching writer that hands each batch to several destinations (private).
+///
+/// Offers the interface `AsyncLogger` expects of `FdSink`: the consumer
+/// thread formats each record once into `buffer()` and notes its level with
+/// `endRecord()`. `flush()` freezes the batch into a shared `FanOutBatch`
+/// and hands it to every destination, which writes the records at or above
+/// its level with `writev(2)`, without copying. Destinations with their own
+/// thread take the batch from a bounded queue; the others are written in
+/// `flush()`. Formatting cost is therefore independent of the number of
+/// destinations.
+class FanOutSink {
+public:
+  /// Open every destination of `config`.
+  ///
+  /// ## Throws
+  /// `std::system_error` if a log file cannot be opened.
+  explicit FanOutSink(const FanOutLoggerConfig &config);
+
+  /// Write every batch still queued for a destination thread, then close the
+  /// files this sink opened. The unflushed batch is discarded.
+  ~FanOutSink();
+
+  FanOutSink(const FanOutSink &) = delete;
+  auto operator=(const FanOutSink &) -> FanOutSink & = delete;
+  FanOutSink(FanOutSink &&) = delete;
+  auto operator=(FanOutSink &&) -> FanOutSink & = delete;
+
+  /// Start the destination threads and the first batch, before the first
+  /// record. Idempotent, so it may be retried after a failure.
+  ///
+  /// ## Throws
+  /// `std::system_error` if a thread cannot be started.
+  void start();
+
+  /// The pending batch; append records here.
+  [[nodiscard]] auto buffer() -> fmt::memory_buffer & { return batch_->text; }
+
+  /// Whether nothing is pending.
+  [[nodiscard]] auto empty() const -> bool {
+    return batch_->text.size() == 0;
+  }
+
+  /// Whether the pending batch has reached the configured size.
+  [[nodiscard]] auto full() const -> bool {
+    return batch_->text.size() >= maxBatchBytes_;
+  }
+
+  /// Note that the text appended since the previous record is a record of
+  /// `level`.
+  void endRecord(Level level);
+
+  /// Hand the pending batch to every destination and start a new one.
+  void flush();
+
+  /// Write `text` to every destination, after everything flushed before.
+  void write(std::string_view text);
+
+  /// Whether `flush()` has written the batch to every destination by the
+  /// time it returns: true unless a destination has its own thread.
+  [[nodiscard]] auto synchronous() const -> bool { return synchronous_; }
+
+  /// Wait until every destination thread has written every batch flushed so
+  /// far.
+  void sync();
+
+private:
+  class Destination;
+
+  void startBatch();
+
+  std::size_t maxBatchBytes_;
+  bool synchronous_ = true;
+  std::shared_ptr<FanOutBatch> batch_;
+  std::vector<std::unique_ptr<Destination>> destinations_;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,126 @@
+#include "FdSink.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace sample::logger {
+
+namespace {
+
+/// Permissions for a newly created log file, before the umask.
+constexpr ::mode_t LogFileMode = 0644;
+
+/// Upper bound on the batch capacity reserved up front.
+constexpr std::size_t MaxInitialReserve = 64 * 1024;
+
+/// Most buffers passed to one `writev(2)` (POSIX guarantees `IOV_MAX` >= 16;
+/// Linux allows 1024).
+constexpr std::size_t MaxIoVectors = 1024;
+
+} // anonymous namespace
+
+auto openLogTarget(LogTarget target, const std::filesystem::path &filePath)
+    -> int {
+  switch (target) {
+  case LogTarget::Stdout:
+    return STDOUT_FILENO;
+  case LogTarget::Stderr:
+    return STDERR_FILENO;
+  case LogTarget::File:
+    break;
+  }
+  const int fd = ::open(filePath.c_str(),
+                        O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, LogFileMode);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "cannot open log file '" + filePath.string() +
+                                "'");
+  }
+  return fd;
+}
+
+void writeFully(int fd, std::span<::iovec> parts) {
+  while (!parts.empty()) {
+    const auto count = static_cast<int>(
+        std::min<std::size_t>(parts.size(), MaxIoVectors));
+    const ::ssize_t written = ::writev(fd, parts.data(), count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    auto remaining = static_cast<std::size_t>(written);
+    while (!parts.empty() && remaining >= parts.front().iov_len) {
+      remaining -= parts.front().iov_len;
+      parts = parts.subspan(1);
+    }
+    if (remaining != 0) {
+      parts.front().iov_base = static_cast<char *>(parts.front().iov_base) +
+                               remaining;
+      parts.front().iov_len -= remaining;
+    }
+  }
+}
+
+FdSink::FdSink(const AsyncLoggerConfig &config)
+    : fd_{openLogTarget(config.target, config.filePath)},
+      ownsFd_{config.target == LogTarget::File},
+      maxBatchBytes_{config.maxBatchBytes} {
+  if (config.compression == Compression::Lz4) {
+    lz4_.emplace();
+    writeEncoded(lz4_->header());
+  }
+}
+
+FdSink::~FdSink() {
+  if (lz4_) {
+    writeEncoded(lz4_->end());
+  }
+  if (ownsFd_) {
+    ::close(fd_);
+  }
+}
+
+void FdSink::start() {
+  batch_.reserve(std::min(maxBatchBytes_, MaxInitialReserve));
+}
+
+void FdSink::flush() {
+  write({batch_.data(), batch_.size()});
+  batch_.clear();
+}
+
+void FdSink::write(std::string_view text) {
+  writeEncoded(lz4_ ? lz4_->encode(text) : text);
+}
+
+void FdSink::writeEncoded(std::string_view bytes) const {
+  const char *data = bytes.data();
+  std::size_t remaining = bytes.size();
+  while (remaining != 0) {
+    const ::ssize_t written = ::write(fd_, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    data += written;
+    remaining -= static_cast<std::size_t>(written);
+  }
+}
+
+} // namespace sample::logger
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Lz4Encoder.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/LogLevel.hpp>
+
+#include <fmt/format.h>
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace sample::logger {
+
+/// Resolve `target` to a file descriptor, opening `filePath` for appending
+/// (and creating it) for `LogTarget::File` (private).
+///
+/// ## Returns
+/// The descriptor; only one opened for `LogTarget::File` should be closed.
+///
+/// ## Throws
+/// `std::system_error` if the file cannot be opened.
+[[nodiscard]] auto openLogTarget(LogTarget target,
+                                 const std::filesystem::path &filePath) -> int;
+
+/// Write all of `parts` to `fd` with `writev(2)` (private).
+///
+/// Retries short writes and `EINTR`; any other error drops the rest, as a
+/// logger has nowhere to report its own output failures. `parts` is
+/// consumed in the process.
+void writeFully(int fd, std::span<::iovec> parts);
+
+/// Batching writer for a raw file descriptor (private).
+///
+/// Callers append formatted records to `buffer()`; `flush()` hands the whole
+/// batch to the kernel in a single `write(2)` (retrying only short writes).
+/// The batch is not thread-safe and belongs to one consumer thread; `write()`
+/// may be called from any thread.
+///
+/// With `Compression::Lz4` the sink writes an LZ4 frame header when it opens
+/// and the end mark when it closes, and `flush()` and `write()` compress
+/// their bytes into blocks first; threads writing batches of their own
+/// compress them with their own `Lz4Encoder` for `writeEncoded()`.
+class FdSink {
+public:
+  /// Open the destination selected by `config.target`.
+  ///
+  /// ## Throws
+  /// `std::system_error` if `LogTarget::File` is requested and the file
+  /// cannot be opened.
+  explicit FdSink(const AsyncLoggerConfig &config);
+
+  /// Close the compressed frame, and the file if this sink opened one.
+  /// Unflushed data is discarded.
+  ~FdSink();
+
+  FdSink(const FdSink &) = delete;
+  auto operator=(const FdSink &) -> FdSink & = delete;
+  FdSink(FdSink &&) = delete;
+  auto operator=(FdSink &&) -> FdSink & = delete;
+
+  /// Reserve the batch's capacity, before the first record is appended
+  /// rather than when the sink is opened. Idempotent.
+  void start();
+
+  /// The pending batch; append records here.
+  [[nodiscard]] auto buffer() -> fmt::memory_buffer & { return batch_; }
+
+  /// Whether nothing is pending.
+  [[nodiscard]] auto empty() const -> bool { return batch_.size() == 0; }
+
+  /// Whether the pending batch has reached the configured size.
+  [[nodiscard]] auto full() const -> bool {
+    return batch_.size() >= maxBatchBytes_;
+  }
+
+  /// Note the end of a record of `level` in the batch; every record is
+  /// written, so there is nothing to track.
+  void endRecord(Level /*level*/) {}
+
+  /// Write out and clear the pending batch.
+  ///
+  /// Errors other than `EINTR` drop the batch: a logger has nowhere to report
+  /// its own output failures.
+  void flush();
+
+  /// Write `text` directly, bypassing the batch.
+  ///
+  /// Compressed with the sink's own encoder, then written as by
+  /// `writeEncoded()`; callers that write from several threads serialise the
+  /// calls.
+  void write(std::string_view text);
+
+  /// Write `bytes`, already compressed as `compression()` says, directly.
+  ///
+  /// One `write(2)`, retried only on a short write or `EINTR`; callers that
+  /// write from several threads serialise the calls to keep lines whole.
+  /// Errors are ignored as in `flush()`.
+  void writeEncoded(std::string_view bytes) const;
+
+  /// How the output is compressed.
+  [[nodiscard]] auto compression() const -> Compression {
+    return lz4_ ? Compression::Lz4 : Compression::None;
+  }
+
+  /// Whether `flush()` has written the batch by the time it returns; always
+  /// true.
+  [[nodiscard]] static constexpr auto synchronous() -> bool { return true; }
+
+  /// Wait until every flushed batch has been written; nothing to wait for.
+  void sync() const {}
+
+private:
+  int fd_;
+  bool ownsFd_;
+  std::size_t maxBatchBytes_;
+  fmt::memory_buffer batch_;
+  std::optional<Lz4Encoder> lz4_;
+};
+
+} // namespace sample::logger
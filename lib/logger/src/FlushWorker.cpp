@@ -0,0 +1,102 @@
+#include "FlushWorker.hpp"
+
+#include <logger/ILogger.hpp>
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace sample::logger {
+
+namespace {
+
+/// The thread behind `runInBackground()` (private).
+///
+/// Runs jobs one at a time, in the order they are posted. At exit it runs
+/// the jobs still queued, then stops.
+class FlushWorker {
+public:
+  FlushWorker() : thread_{[this] { run(); }} {}
+
+  ~FlushWorker() {
+    {
+      const std::lock_guard lock{mutex_};
+      stopping_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+  }
+
+  FlushWorker(const FlushWorker &) = delete;
+  auto operator=(const FlushWorker &) -> FlushWorker & = delete;
+  FlushWorker(FlushWorker &&) = delete;
+  auto operator=(FlushWorker &&) -> FlushWorker & = delete;
+
+  /// The process's worker, started on first use.
+  static auto instance() -> FlushWorker & {
+    static FlushWorker worker;
+    return worker;
+  }
+
+  /// Run `job` on the worker thread.
+  void post(std::move_only_function<void()> job) {
+    {
+      const std::lock_guard lock{mutex_};
+      jobs_.push_back(std::move(job));
+    }
+    wakeup_.notify_one();
+  }
+
+private:
+  void run() {
+    std::unique_lock lock{mutex_};
+    for (;;) {
+      wakeup_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      std::move_only_function<void()> job = std::move(jobs_.front());
+      jobs_.pop_front();
+      lock.unlock();
+      try {
+        job();
+      } catch (...) {
+        // Nowhere to report it, and the other jobs still have to run.
+      }
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<std::move_only_function<void()>> jobs_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // anonymous namespace
+
+void runInBackground(std::move_only_function<void()> job) {
+  FlushWorker::instance().post(std::move(job));
+}
+
+void detail::flushInBackground(ILogger &logger, FlushCallback done) {
+  runInBackground([&logger, done = std::move(done)]() mutable {
+    try {
+      logger.flush();
+    } catch (...) {
+      // `done` still has to run: a waiting coroutine must resume.
+    }
+    done();
+  });
+}
+
+void detail::resumeInBackground(std::coroutine_handle<> coroutine) {
+  runInBackground([coroutine] { coroutine.resume(); });
+}
+
+} // namespace sample::logger
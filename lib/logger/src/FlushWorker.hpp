@@ -0,0 +1,15 @@
+#pragma once
+
+#include <functional>
+
+namespace sample::logger {
+
+/// Run `job` on the library's background thread (private).
+///
+/// One thread, started by the first job, runs every job in turn: the
+/// `flush()` calls behind `ILogger::flushThen()` and the coroutines that
+/// `ILogger::flushAsync()` resumes. A job that blocks delays the ones after
+/// it. Exceptions from `job` are swallowed.
+void runInBackground(std::move_only_function<void()> job);
+
+} // namespace sample::logger
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+namespace sample::logger {
+
+/// Block while `word` holds `expected`, or until `timeout` elapses.
+///
+/// May return spuriously; callers re-check their condition. A negative or
+/// zero `timeout` returns immediately.
+inline void futexWait(std::atomic<std::uint32_t> &word, std::uint32_t expected,
+                      std::chrono::nanoseconds timeout) {
+  if (timeout <= std::chrono::nanoseconds::zero()) {
+    return;
+  }
+  const auto seconds = std::chrono::floor<std::chrono::seconds>(timeout);
+  const ::timespec relative{
+      .tv_sec = static_cast<std::time_t>(seconds.count()),
+      .tv_nsec = static_cast<long>((timeout - seconds).count())};
+  ::syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, expected, &relative,
+            nullptr, 0);
+}
+
+/// Block while `word` holds `expected`, with no timeout.
+inline void futexWait(std::atomic<std::uint32_t> &word,
+                      std::uint32_t expected) {
+  ::syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr,
+            0);
+}
+
+/// Wake one thread blocked in `futexWait()` on `word`.
+inline void futexWakeOne(std::atomic<std::uint32_t> &word) {
+  ::syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+/// Wake every thread blocked in `futexWait()` on `word`.
+inline void futexWakeAll(std::atomic<std::uint32_t> &word) {
+  ::syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr,
+            0);
+}
+
+} // namespace sample::logger
@@ -0,0 +1,134 @@
+#include "LineFormatter.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/DeferredFormat.hpp>
+#include <logger/Fields.hpp>
+#include <logger/LogLevel.hpp>
+
+#include "AsyncRecord.hpp"
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <span>
+#include <string_view>
+
+namespace sample::logger {
+
+namespace {
+
+/// The encoded arguments of a deferred record.
+[[nodiscard]] auto argsOf(const Record &record) -> std::span<const std::byte> {
+  return std::as_bytes(std::span{record.bytes()});
+}
+
+/// Whether `record` is a structured message.
+[[nodiscard]] auto isStructured(const Record &record) -> bool {
+  return record.format != nullptr && record.format->fields != nullptr;
+}
+
+} // anonymous namespace
+
+LineFormatter::LineFormatter(LineFormat format, bool timestamps)
+    : format_{format} {
+  if (timestamps) {
+    timestamps_.emplace();
+  }
+}
+
+void LineFormatter::append(const Record &record, fmt::memory_buffer &out) {
+  const std::size_t start = out.size();
+  try {
+    switch (format_) {
+    case LineFormat::Plain:
+      appendPlain(record, out);
+      break;
+    case LineFormat::Logfmt:
+      appendLogfmt(record, out);
+      break;
+    case LineFormat::Json:
+      appendJson(record, out);
+      break;
+    }
+  } catch (const std::exception &error) {
+    out.resize(start);
+    scratch_.clear();
+    const std::string_view pattern =
+        record.format != nullptr ? record.format->pattern : "";
+    fmt::format_to(std::back_inserter(scratch_), "[logger: {}: {}]", pattern,
+                   error.what());
+    const std::string_view marker{scratch_.data(), scratch_.size()};
+    if (format_ == LineFormat::Json) {
+      out.append(std::string_view{"{\"message\":"});
+      detail::appendJsonString(marker, out);
+      out.push_back('}');
+    } else {
+      out.append(marker);
+    }
+  }
+  out.push_back('\n');
+}
+
+void LineFormatter::appendPlain(const Record &record,
+                                fmt::memory_buffer &out) {
+  if (timestamps_) {
+    timestamps_->append(record.cycles, out);
+    out.push_back(' ');
+  }
+  appendText(record, out);
+}
+
+void LineFormatter::appendLogfmt(const Record &record,
+                                 fmt::memory_buffer &out) {
+  if (timestamps_) {
+    out.append(std::string_view{"time="});
+    timestamps_->append(record.cycles, out);
+    out.push_back(' ');
+  }
+  out.append(std::string_view{"level="});
+  out.append(toString(record.level));
+  out.append(std::string_view{" msg="});
+  if (isStructured(record)) {
+    detail::appendLogfmtString(detail::structuredMessage(argsOf(record)),
+                               out);
+    record.format->fields(argsOf(record), FieldStyle::Logfmt, out);
+  } else {
+    scratch_.clear();
+    appendText(record, scratch_);
+    detail::appendLogfmtString({scratch_.data(), scratch_.size()}, out);
+  }
+}
+
+void LineFormatter::appendJson(const Record &record, fmt::memory_buffer &out) {
+  out.push_back('{');
+  if (timestamps_) {
+    out.append(std::string_view{"\"time\":\""});
+    timestamps_->append(record.cycles, out);
+    out.append(std::string_view{"\","});
+  }
+  out.append(std::string_view{"\"level\":\""});
+  out.append(toString(record.level));
+  out.append(std::string_view{"\",\"message\":"});
+  if (isStructured(record)) {
+    detail::appendJsonString(detail::structuredMessage(argsOf(record)), out);
+    record.format->fields(argsOf(record), FieldStyle::Json, out);
+  } else {
+    scratch_.clear();
+    appendText(record, scratch_);
+    detail::appendJsonString({scratch_.data(), scratch_.size()}, out);
+  }
+  out.push_back('}');
+}
+
+void LineFormatter::appendText(const Record &record, fmt::memory_buffer &out) {
+  if (record.format == nullptr) {
+    const std::string_view text = record.bytes();
+    out.append(text.data(), text.data() + text.size());
+  } else {
+    record.format->format(argsOf(record), out);
+  }
+}
+
+} // namespace sample::logger
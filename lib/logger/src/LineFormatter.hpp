@@ -0,0 +1,43 @@
+#pragma once
+
+#include <logger/AsyncLoggerConfig.hpp>
+
+#include "AsyncRecord.hpp"
+#include "CycleClock.hpp"
+
+#include <fmt/format.h>
+
+#include <optional>
+
+namespace sample::logger {
+
+/// Formats queued records as lines of text (private).
+///
+/// Lays each record out as configured by `LineFormat`, converts its cycle
+/// counter reading when timestamps are on, and renders the fields of
+/// structured records in the matching style. Not thread-safe: owned by one
+/// backend thread.
+class LineFormatter {
+public:
+  LineFormatter(LineFormat format, bool timestamps);
+
+  /// Append the line of `record` and its terminator to `out`.
+  ///
+  /// A record whose formatting fails is replaced by a marker naming its
+  /// pattern and the error.
+  void append(const Record &record, fmt::memory_buffer &out);
+
+private:
+  void appendPlain(const Record &record, fmt::memory_buffer &out);
+  void appendLogfmt(const Record &record, fmt::memory_buffer &out);
+  void appendJson(const Record &record, fmt::memory_buffer &out);
+
+  /// Append the text of a record that is not structured to `out`.
+  static void appendText(const Record &record, fmt::memory_buffer &out);
+
+  LineFormat format_;
+  std::optional<TimestampFormatter> timestamps_;
+  fmt::memory_buffer scratch_;
+};
+
+} // namespace sample::logger
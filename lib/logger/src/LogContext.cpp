@@ -0,0 +1,52 @@
+#include <logger/DeferredFormat.hpp>
+#include <logger/Fields.hpp>
+#include <logger/LogContext.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace sample::logger {
+
+void LogContext::set(std::string_view key, std::string_view value) {
+  if (key.empty()) {
+    throw std::invalid_argument("LogContext keys must not be empty");
+  }
+  const auto pairs = std::span{fields_.data(), size_};
+  const auto found = std::ranges::find(pairs, key, &ContextField::key);
+  if (found != pairs.end()) {
+    found->value = value;
+  } else if (size_ == MaxFields) {
+    throw std::length_error("LogContext holds at most MaxFields pairs");
+  } else {
+    fields_[size_++] = {.key = std::string{key}, .value = std::string{value}};
+  }
+  render();
+}
+
+void LogContext::erase(std::string_view key) {
+  const auto pairs = std::span{fields_.data(), size_};
+  const auto found = std::ranges::find(pairs, key, &ContextField::key);
+  if (found == pairs.end()) {
+    return;
+  }
+  std::ranges::move(found + 1, pairs.end(), found);
+  fields_[--size_] = {};
+  render();
+}
+
+void LogContext::render() {
+  fmt::memory_buffer text;
+  for (const ContextField &field : fields()) {
+    detail::appendField(field.key, std::string_view{field.value},
+                        FieldStyle::Logfmt, text);
+  }
+  text_.assign(text.data(), text.size());
+}
+
+} // namespace sample::logger
@@ -0,0 +1,221 @@
+#include <logger/LogLevel.hpp>
+#include <logger/LogTap.hpp>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+
+namespace sample::logger {
+
+namespace {
+
+/// Identifies a tap ring: `"SLOGTAP"` and a layout version.
+constexpr std::uint64_t RingMagic = 0x01'50'41'54'47'4F'4C'53;
+
+/// Smallest ring capacity accepted.
+constexpr std::size_t MinCapacity = 4096;
+
+/// Offset of the records from the start of the shared memory; the header
+/// has the first page to itself.
+constexpr std::size_t DataOffset = 4096;
+
+/// Alignment of every entry in the ring.
+constexpr std::size_t EntryAlignment = 8;
+
+/// `EntryHeader::level` of the filler before a wrap to the ring's start.
+constexpr std::uint8_t WrapLevel = 0xFF;
+
+/// Start of the shared memory: the ring's identity and its positions, which
+/// only ever increase; an entry is at `position % capacity` of the records.
+///
+/// The writer advances `written` with a release store once a batch of
+/// entries is in place, and reads `read` with acquire before reusing space;
+/// the reader does the opposite.
+struct RingHeader {
+  std::uint64_t magic;
+  std::uint64_t capacity;
+  alignas(64) std::atomic<std::uint64_t> written;
+  std::atomic<std::uint64_t> dropped;
+  alignas(64) std::atomic<std::uint64_t> read;
+};
+
+static_assert(sizeof(RingHeader) <= DataOffset);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "the positions are shared between processes");
+
+/// Precedes each record in the ring, padded to `EntryAlignment`.
+struct EntryHeader {
+  std::uint32_t size;
+  std::uint8_t level;
+  std::uint8_t reserved[3];
+};
+
+static_assert(sizeof(EntryHeader) == EntryAlignment);
+
+auto header(std::byte *memory) -> RingHeader & {
+  return *std::launder(reinterpret_cast<RingHeader *>(memory));
+}
+
+auto entrySize(std::size_t bytes) -> std::size_t {
+  return sizeof(EntryHeader) +
+         (bytes + EntryAlignment - 1) / EntryAlignment * EntryAlignment;
+}
+
+void putEntry(std::byte *at, std::uint32_t size, std::uint8_t level) {
+  const EntryHeader entry{.size = size, .level = level, .reserved = {}};
+  std::memcpy(at, &entry, sizeof(entry));
+}
+
+/// Map `bytes` of `fd` shared, or throw `std::system_error`.
+auto mapShared(int fd, std::size_t bytes) -> std::byte * {
+  void *memory =
+      ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED) {
+    throw std::system_error(errno, std::generic_category(),
+                            "cannot map the tap ring");
+  }
+  return static_cast<std::byte *>(memory);
+}
+
+} // anonymous namespace
+
+TapRing::TapRing(std::size_t capacity) : capacity_{capacity} {
+  if (capacity < MinCapacity || !std::has_single_bit(capacity)) {
+    throw std::invalid_argument(
+        "TapRing capacity must be a power of two >= 4096");
+  }
+  fd_ = ::memfd_create("logger-tap", MFD_CLOEXEC);
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "cannot create the tap ring");
+  }
+  try {
+    if (::ftruncate(fd_, static_cast<::off_t>(DataOffset + capacity)) != 0) {
+      throw std::system_error(errno, std::generic_category(),
+                              "cannot size the tap ring");
+    }
+    memory_ = mapShared(fd_, DataOffset + capacity);
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+  // A fresh memfd reads as zeros: only the identity needs writing.
+  RingHeader *ring = new (memory_) RingHeader{};
+  ring->capacity = capacity;
+  std::atomic_ref{ring->magic}.store(RingMagic, std::memory_order_release);
+}
+
+TapRing::~TapRing() {
+  ::munmap(memory_, DataOffset + capacity_);
+  ::close(fd_);
+}
+
+void TapRing::publish(std::span<const TapRecord> records) {
+  const std::lock_guard lock{mutex_};
+  RingHeader &ring = header(memory_);
+  std::byte *data = memory_ + DataOffset;
+  std::uint64_t written = ring.written.load(std::memory_order_relaxed);
+  std::uint64_t dropped = 0;
+  for (const TapRecord &record : records) {
+    const std::size_t size = entrySize(record.bytes.size());
+    const std::size_t position = written % capacity_;
+    const std::size_t contiguous = capacity_ - position;
+    const std::size_t needed = size <= contiguous ? size : contiguous + size;
+    const std::uint64_t used =
+        written - ring.read.load(std::memory_order_acquire);
+    if (size > capacity_ || needed > capacity_ - used) {
+      ++dropped;
+      continue;
+    }
+    if (size > contiguous) {
+      putEntry(data + position, 0, WrapLevel);
+      written += contiguous;
+    }
+    std::byte *entry = data + written % capacity_;
+    putEntry(entry, static_cast<std::uint32_t>(record.bytes.size()),
+             static_cast<std::uint8_t>(record.level));
+    if (!record.bytes.empty()) {
+      std::memcpy(entry + sizeof(EntryHeader), record.bytes.data(),
+                  record.bytes.size());
+    }
+    written += size;
+  }
+  ring.written.store(written, std::memory_order_release);
+  if (dropped != 0) {
+    ring.dropped.fetch_add(dropped, std::memory_order_relaxed);
+  }
+}
+
+auto TapRing::dropped() const -> std::uint64_t {
+  return header(memory_).dropped.load(std::memory_order_relaxed);
+}
+
+TapReader::TapReader(int fd) {
+  struct ::stat status{};
+  if (::fstat(fd, &status) != 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "cannot inspect the tap ring");
+  }
+  const auto bytes = static_cast<std::size_t>(status.st_size);
+  if (bytes < DataOffset + MinCapacity) {
+    throw std::invalid_argument("not a tap ring");
+  }
+  memory_ = mapShared(fd, bytes);
+  mappedBytes_ = bytes;
+  RingHeader &ring = header(memory_);
+  capacity_ = static_cast<std::size_t>(ring.capacity);
+  if (std::atomic_ref{ring.magic}.load(std::memory_order_acquire) !=
+          RingMagic ||
+      capacity_ != bytes - DataOffset) {
+    ::munmap(memory_, mappedBytes_);
+    throw std::invalid_argument("not a tap ring");
+  }
+  read_ = ring.read.load(std::memory_order_relaxed);
+}
+
+TapReader::~TapReader() { ::munmap(memory_, mappedBytes_); }
+
+auto TapReader::next() -> std::optional<TapRecord> {
+  RingHeader &ring = header(memory_);
+  if (held_ != 0) {
+    read_ += held_;
+    held_ = 0;
+    ring.read.store(read_, std::memory_order_release);
+  }
+  const std::byte *data = memory_ + DataOffset;
+  for (;;) {
+    if (read_ == ring.written.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    const std::size_t position = read_ % capacity_;
+    EntryHeader entry{};
+    std::memcpy(&entry, data + position, sizeof(entry));
+    if (entry.level == WrapLevel) {
+      read_ += capacity_ - position;
+      continue;
+    }
+    held_ = entrySize(entry.size);
+    return TapRecord{.level = static_cast<Level>(entry.level),
+                     .bytes = {data + position + sizeof(EntryHeader),
+                               entry.size}};
+  }
+}
+
+auto TapReader::dropped() const -> std::uint64_t {
+  return header(memory_).dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace sample::logger
@@ -0,0 +1,206 @@
+#include <logger/DeferredFormat.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerRegistry.hpp>
+#include <logger/LoggerStats.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sample::logger {
+
+namespace {
+
+/// A logger of a `LoggerRegistry` (private).
+///
+/// Checks its own level, then passes every message to the registry's
+/// output as-is, which flushes after it if it is at or above the output's
+/// `flushLevel()`; flushing and statistics are the output's.
+class NamedLogger final : public ILogger {
+public:
+  explicit NamedLogger(ILogger &output) : output_{output} {}
+
+  void flush() override { output_.flush(); }
+
+  void flushThen(FlushCallback done) override {
+    output_.flushThen(std::move(done));
+  }
+
+  [[nodiscard]] auto droppedMessages() const -> std::uint64_t override {
+    return output_.droppedMessages();
+  }
+
+  [[nodiscard]] auto stats() const -> LoggerStats override {
+    return output_.stats();
+  }
+
+private:
+  void write(Level level, std::string_view message) override {
+    forward(output_, level, message);
+  }
+
+  void writeDeferred(Level level, const DeferredFormat &format,
+                     std::span<const std::byte> args) override {
+    forward(output_, level, format, args);
+  }
+
+  ILogger &output_;
+};
+
+/// Whether the logger `name` is `ancestor` or below it.
+auto isWithin(std::string_view name, std::string_view ancestor) -> bool {
+  return ancestor.empty() || name == ancestor ||
+         (name.starts_with(ancestor) && name[ancestor.size()] == '.');
+}
+
+/// `text` without leading and trailing spaces.
+auto trimmed(std::string_view text) -> std::string_view {
+  const std::size_t first = text.find_first_not_of(' ');
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return text.substr(first, text.find_last_not_of(' ') - first + 1);
+}
+
+} // anonymous namespace
+
+/// A named logger, in the registry's lock-free list of them.
+struct LoggerRegistry::Entry {
+  Entry(std::string_view entryName, ILogger &output, Entry *nextEntry)
+      : name{entryName}, logger{output}, next{nextEntry} {}
+
+  const std::string name;
+  NamedLogger logger;
+  Entry *const next;
+};
+
+LoggerRegistry::LoggerRegistry(std::shared_ptr<ILogger> output)
+    : output_{std::move(output)} {
+  if (!output_) {
+    throw std::invalid_argument("LoggerRegistry output must not be null");
+  }
+  levels_.emplace("", output_->level());
+}
+
+LoggerRegistry::~LoggerRegistry() = default;
+
+auto LoggerRegistry::get(std::string_view name) -> ILogger & {
+  if (Entry *entry = find(name)) {
+    return entry->logger;
+  }
+  const std::lock_guard lock{mutex_};
+  if (Entry *entry = find(name)) {
+    return entry->logger;
+  }
+  entries_.push_back(std::make_unique<Entry>(
+      name, *output_, first_.load(std::memory_order_relaxed)));
+  Entry &entry = *entries_.back();
+  entry.logger.setLevel(effectiveLevel(name));
+  first_.store(&entry, std::memory_order_release);
+  return entry.logger;
+}
+
+void LoggerRegistry::setLevel(std::string_view name, Level level) {
+  const std::lock_guard lock{mutex_};
+  levels_.insert_or_assign(std::string{name}, level);
+  refresh(name);
+}
+
+void LoggerRegistry::clearLevel(std::string_view name) {
+  if (name.empty()) {
+    return;
+  }
+  const std::lock_guard lock{mutex_};
+  if (const auto found = levels_.find(name); found != levels_.end()) {
+    levels_.erase(found);
+    refresh(name);
+  }
+}
+
+void LoggerRegistry::setLevels(std::string_view spec) {
+  std::vector<std::pair<std::string_view, Level>> settings;
+  while (!spec.empty()) {
+    const std::size_t comma = spec.find(',');
+    const std::string_view item = trimmed(spec.substr(0, comma));
+    spec = comma == std::string_view::npos ? std::string_view{}
+                                           : spec.substr(comma + 1);
+    if (item.empty()) {
+      continue;
+    }
+    const std::size_t equals = item.find('=');
+    const std::string_view name =
+        equals == std::string_view::npos ? std::string_view{}
+                                         : trimmed(item.substr(0, equals));
+    const std::optional<Level> level = parseLevel(
+        equals == std::string_view::npos ? item
+                                         : trimmed(item.substr(equals + 1)));
+    if (!level || (equals != std::string_view::npos && name.empty())) {
+      throw std::invalid_argument("malformed logger level setting '" +
+                                  std::string{item} + "'");
+    }
+    settings.emplace_back(name, *level);
+  }
+  const std::lock_guard lock{mutex_};
+  for (const auto &[name, level] : settings) {
+    levels_.insert_or_assign(std::string{name}, level);
+  }
+  refresh("");
+}
+
+auto LoggerRegistry::level(std::string_view name) const -> Level {
+  const std::lock_guard lock{mutex_};
+  return effectiveLevel(name);
+}
+
+auto LoggerRegistry::names() const -> std::vector<std::string> {
+  std::vector<std::string> result;
+  for (const Entry *entry = first_.load(std::memory_order_acquire);
+       entry != nullptr; entry = entry->next) {
+    result.push_back(entry->name);
+  }
+  return result;
+}
+
+auto LoggerRegistry::find(std::string_view name) const -> Entry * {
+  for (Entry *entry = first_.load(std::memory_order_acquire);
+       entry != nullptr; entry = entry->next) {
+    if (entry->name == name) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+auto LoggerRegistry::effectiveLevel(std::string_view name) const -> Level {
+  // The root is always set, and the longest setting that covers `name` is
+  // its nearest ancestor's.
+  std::size_t longest = 0;
+  Level result = levels_.find("")->second;
+  for (const auto &[ancestor, level] : levels_) {
+    if (ancestor.size() > longest && isWithin(name, ancestor)) {
+      longest = ancestor.size();
+      result = level;
+    }
+  }
+  return result;
+}
+
+void LoggerRegistry::refresh(std::string_view name) {
+  for (const auto &entry : entries_) {
+    if (isWithin(entry->name, name)) {
+      entry->logger.setLevel(effectiveLevel(entry->name));
+    }
+  }
+}
+
+} // namespace sample::logger
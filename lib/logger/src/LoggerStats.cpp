@@ -0,0 +1,61 @@
+#include "StatsCounters.hpp"
+
+#include <logger/ILogger.hpp>
+#include <logger/LoggerStats.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace sample::logger {
+
+namespace {
+
+/// Source of `threadStripe()` indices.
+std::atomic<std::size_t> nextStripe{0};
+
+} // anonymous namespace
+
+auto threadStripe() -> std::size_t {
+  thread_local const std::size_t stripe =
+      nextStripe.fetch_add(1, std::memory_order_relaxed);
+  return stripe;
+}
+
+StatsReporter::StatsReporter(const ILogger &logger,
+                             std::chrono::milliseconds interval,
+                             Callback callback)
+    : logger_{logger}, interval_{interval}, callback_{std::move(callback)} {
+  if (interval_ <= std::chrono::milliseconds::zero()) {
+    throw std::invalid_argument("StatsReporter interval must be positive");
+  }
+  if (!callback_) {
+    throw std::invalid_argument("StatsReporter callback must not be empty");
+  }
+  thread_ = std::thread{[this] { run(); }};
+}
+
+StatsReporter::~StatsReporter() {
+  {
+    const std::lock_guard lock{mutex_};
+    stopping_ = true;
+  }
+  stopCv_.notify_one();
+  thread_.join();
+}
+
+void StatsReporter::run() {
+  std::unique_lock lock{mutex_};
+  auto next = std::chrono::steady_clock::now() + interval_;
+  while (!stopCv_.wait_until(lock, next, [this] { return stopping_; })) {
+    lock.unlock();
+    callback_(logger_.stats());
+    lock.lock();
+    next += interval_;
+  }
+}
+
+} // namespace sample::logger
@@ -0,0 +1,183 @@
+#include <logger/Lz4Decoder.hpp>
+
+#include <fmt/format.h>
+#include <lz4frame.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace sample::logger {
+
+namespace {
+
+// liblz4 decodes the frames; the decoder only splits the stream into the
+// headers, blocks and end marks it hands over whole, which is what lets it
+// return the incomplete remainder and resume a frame left open by a crash:
+//
+// - Block: u32 size with `UncompressedBit` set for a block stored as is, the
+//   data, and a u32 checksum if the frame header asks for one.
+// - End mark: a u32 0, then a u32 checksum of the content if asked for.
+// - Skippable frame: u32 magic `SkippableMagic` to `SkippableMagic` + 15, a
+//   u32 size and that many bytes.
+//
+// Integers are little-endian.
+
+constexpr std::size_t Word = sizeof(std::uint32_t);
+constexpr std::uint32_t SkippableMask = 0xFFFFFFF0;
+constexpr std::uint32_t SkippableMagic = LZ4F_MAGIC_SKIPPABLE_START;
+constexpr std::uint32_t UncompressedBit = 0x80000000;
+
+[[noreturn]] void corrupt(std::uint64_t offset, std::string_view what) {
+  throw std::runtime_error(
+      fmt::format("LZ4 frame: {} at offset {}", what, offset));
+}
+
+/// Read a little-endian u32 at `at`.
+[[nodiscard]] auto loadLe32(std::span<const std::byte> bytes, std::size_t at)
+    -> std::uint32_t {
+  return std::to_integer<std::uint32_t>(bytes[at]) |
+         std::to_integer<std::uint32_t>(bytes[at + 1]) << 8U |
+         std::to_integer<std::uint32_t>(bytes[at + 2]) << 16U |
+         std::to_integer<std::uint32_t>(bytes[at + 3]) << 24U;
+}
+
+/// Largest block of a frame whose header gives `id`.
+[[nodiscard]] auto blockBytes(LZ4F_blockSizeID_t id) -> std::size_t {
+  const unsigned code = id == LZ4F_default ? LZ4F_max64KB : id;
+  return std::size_t{1} << (8 + 2 * code);
+}
+
+} // anonymous namespace
+
+void Lz4Decoder::FreeContext::operator()(LZ4F_dctx_s *context) const noexcept {
+  LZ4F_freeDecompressionContext(context);
+}
+
+Lz4Decoder::Lz4Decoder() {
+  LZ4F_dctx *context = nullptr;
+  if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION))) {
+    throw std::bad_alloc();
+  }
+  context_.reset(context);
+}
+
+auto Lz4Decoder::startsFrame(std::span<const std::byte> input) -> bool {
+  return input.size() >= Word && loadLe32(input, 0) == LZ4F_MAGICNUMBER;
+}
+
+auto Lz4Decoder::decode(std::span<const std::byte> input,
+                        fmt::memory_buffer &out) -> std::size_t {
+  std::size_t consumed = 0;
+  while (consumed < input.size()) {
+    const std::size_t used = decodeStep(input.subspan(consumed), out);
+    if (used == 0) {
+      break;
+    }
+    consumed += used;
+    offset_ += used;
+  }
+  return consumed;
+}
+
+auto Lz4Decoder::decodeStep(std::span<const std::byte> input,
+                            fmt::memory_buffer &out) -> std::size_t {
+  if (state_ == State::Skip) {
+    const std::size_t used = std::min<std::size_t>(skipping_, input.size());
+    skipping_ -= static_cast<std::uint32_t>(used);
+    if (skipping_ == 0) {
+      state_ = State::Header;
+    }
+    return used;
+  }
+  if (input.size() < Word) {
+    return 0;
+  }
+  const std::uint32_t word = loadLe32(input, 0);
+
+  if (state_ == State::Header) {
+    if ((word & SkippableMask) == SkippableMagic) {
+      if (input.size() < 2 * Word) {
+        return 0;
+      }
+      skipping_ = loadLe32(input, Word);
+      state_ = skipping_ == 0 ? State::Header : State::Skip;
+      return 2 * Word;
+    }
+    if (word != LZ4F_MAGICNUMBER) {
+      corrupt(offset_, "bad magic number (not LZ4 frames?)");
+    }
+    if (input.size() < LZ4F_MIN_SIZE_TO_KNOW_HEADER_LENGTH) {
+      return 0;
+    }
+    const std::size_t size = LZ4F_headerSize(input.data(), input.size());
+    if (LZ4F_isError(size)) {
+      corrupt(offset_, LZ4F_getErrorName(size));
+    }
+    if (input.size() < size) {
+      return 0;
+    }
+    LZ4F_frameInfo_t info{};
+    std::size_t used = size;
+    const std::size_t result =
+        LZ4F_getFrameInfo(context_.get(), &info, input.data(), &used);
+    if (LZ4F_isError(result)) {
+      LZ4F_resetDecompressionContext(context_.get());
+      corrupt(offset_, LZ4F_getErrorName(result));
+    }
+    maxBlock_ = blockBytes(info.blockSizeID);
+    blockChecksum_ =
+        info.blockChecksumFlag == LZ4F_blockChecksumEnabled ? Word : 0;
+    contentChecksum_ =
+        info.contentChecksumFlag == LZ4F_contentChecksumEnabled ? Word : 0;
+    state_ = State::Blocks;
+    return used;
+  }
+
+  if (word == LZ4F_MAGICNUMBER) {
+    // The writer died before closing its frame, and the next one starts.
+    LZ4F_resetDecompressionContext(context_.get());
+    state_ = State::Header;
+    return decodeStep(input, out);
+  }
+  const std::size_t size = word & ~UncompressedBit;
+  if (size > maxBlock_) {
+    corrupt(offset_, "block larger than the frame allows");
+  }
+  const std::size_t total =
+      word == 0 ? Word + contentChecksum_ : Word + size + blockChecksum_;
+  if (input.size() < total) {
+    return 0;
+  }
+  decompress(input.first(total), out);
+  if (word == 0) {
+    state_ = State::Header;
+  }
+  return total;
+}
+
+void Lz4Decoder::decompress(std::span<const std::byte> step,
+                            fmt::memory_buffer &out) {
+  while (!step.empty()) {
+    const std::size_t start = out.size();
+    out.resize(start + maxBlock_);
+    std::size_t produced = maxBlock_;
+    std::size_t used = step.size();
+    const std::size_t result =
+        LZ4F_decompress(context_.get(), out.data() + start, &produced,
+                        step.data(), &used, nullptr);
+    out.resize(start + produced);
+    if (LZ4F_isError(result) || (used == 0 && produced == 0)) {
+      LZ4F_resetDecompressionContext(context_.get());
+      corrupt(offset_, LZ4F_isError(result) ? LZ4F_getErrorName(result)
+                                            : "decoding made no progress");
+    }
+    step = step.subspan(used);
+  }
+}
+
+} // namespace sample::logger
@@ -0,0 +1,57 @@
+#include "Lz4Encoder.hpp"
+
+#include <fmt/format.h>
+#include <lz4frame.h>
+
+#include <cstddef>
+#include <new>
+#include <string_view>
+
+namespace sample::logger {
+
+namespace {
+
+/// The settings of every frame: independent 4 MiB blocks, each call flushed
+/// as whole blocks, no checksums or content size.
+constexpr LZ4F_preferences_t Preferences = [] {
+  LZ4F_preferences_t preferences{};
+  preferences.frameInfo.blockSizeID = LZ4F_max4MB;
+  preferences.frameInfo.blockMode = LZ4F_blockIndependent;
+  preferences.autoFlush = 1;
+  return preferences;
+}();
+
+} // anonymous namespace
+
+Lz4Encoder::Lz4Encoder() {
+  LZ4F_cctx *context = nullptr;
+  if (LZ4F_isError(LZ4F_createCompressionContext(&context, LZ4F_VERSION))) {
+    throw std::bad_alloc();
+  }
+  context_.reset(context);
+  header_.resize(LZ4F_HEADER_SIZE_MAX);
+  const std::size_t size = LZ4F_compressBegin(context_.get(), header_.data(),
+                                              header_.size(), &Preferences);
+  if (LZ4F_isError(size)) {
+    throw std::bad_alloc();
+  }
+  header_.resize(size);
+}
+
+auto Lz4Encoder::encode(std::string_view input) -> std::string_view {
+  blocks_.resize(LZ4F_compressBound(input.size(), &Preferences));
+  const std::size_t size =
+      LZ4F_compressUpdate(context_.get(), blocks_.data(), blocks_.size(),
+                          input.data(), input.size(), nullptr);
+  // Only a buffer below the bound fails; drop the batch as output errors.
+  return {blocks_.data(), LZ4F_isError(size) ? 0 : size};
+}
+
+auto Lz4Encoder::end() -> std::string_view {
+  blocks_.resize(LZ4F_compressBound(0, &Preferences));
+  const std::size_t size = LZ4F_compressEnd(context_.get(), blocks_.data(),
+                                            blocks_.size(), nullptr);
+  return {blocks_.data(), LZ4F_isError(size) ? 0 : size};
+}
+
+} // namespace sample::logger
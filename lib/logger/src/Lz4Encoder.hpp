@@ -0,0 +1,56 @@
+#pragma once
+
+#include <fmt/format.h>
+#include <lz4frame.h>
+
+#include <memory>
+#include <string_view>
+
+namespace sample::logger {
+
+/// Compresses batches into the blocks of an LZ4 frame with liblz4's frame
+/// API (private).
+///
+/// Every encoder begins a frame with the same settings: independent blocks
+/// of up to 4 MiB and no checksums. Each call's input is flushed as whole
+/// blocks, so every block decodes without the ones before it, a stream cut
+/// short loses only the block being written, and the blocks of several
+/// encoders (one per backend thread) interleave in one frame, which the
+/// sink opens with its own encoder's `header()` and closes with its
+/// `end()`. Not thread-safe: owned by one writer.
+class Lz4Encoder {
+public:
+  /// Begin a frame.
+  ///
+  /// ## Throws
+  /// `std::bad_alloc` if liblz4 cannot allocate its context.
+  Lz4Encoder();
+
+  /// The frame header, written before any block.
+  [[nodiscard]] auto header() const -> std::string_view {
+    return {header_.data(), header_.size()};
+  }
+
+  /// Compress `input` into the next blocks of the frame.
+  ///
+  /// ## Returns
+  /// The encoded blocks, valid until the next call.
+  auto encode(std::string_view input) -> std::string_view;
+
+  /// The end mark closing the frame; the encoder is done with it.
+  auto end() -> std::string_view;
+
+private:
+  /// Frees the liblz4 context.
+  struct FreeContext {
+    void operator()(LZ4F_cctx *context) const noexcept {
+      LZ4F_freeCompressionContext(context);
+    }
+  };
+
+  std::unique_ptr<LZ4F_cctx, FreeContext> context_;
+  fmt::memory_buffer header_;
+  fmt::memory_buffer blocks_;
+};
+
+} // namespace sample::logger
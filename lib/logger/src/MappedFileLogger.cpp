@@ -0,0 +1,390 @@
+#include "MpscRing.hpp"
+#include "StatsCounters.hpp"
+
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+#include <logger/MappedFileLoggerConfig.hpp>
+
+#include <fmt/format.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace sample::logger {
+
+namespace {
+
+/// Smallest accepted segment size.
+constexpr std::size_t MinSegmentSize = 4096;
+
+/// Permissions for a newly created segment file, before the umask.
+constexpr ::mode_t SegmentFileMode = 0644;
+
+/// Extension of every segment file.
+constexpr std::string_view SegmentExtension = ".log";
+
+/// Throw a `std::system_error` for the current `errno`.
+[[noreturn]] void throwErrno(int error, const std::string &what) {
+  throw std::system_error(error, std::generic_category(), what);
+}
+
+/// First segment index not yet used by `baseName` in `directory`.
+auto nextSegmentIndex(const std::filesystem::path &directory,
+                      std::string_view baseName) -> std::uint64_t {
+  std::uint64_t next = 0;
+  for (const auto &entry : std::filesystem::directory_iterator{directory}) {
+    const std::string name = entry.path().filename().string();
+    std::string_view rest = name;
+    if (!rest.starts_with(baseName) || !rest.ends_with(SegmentExtension)) {
+      continue;
+    }
+    rest.remove_prefix(baseName.size());
+    rest.remove_suffix(SegmentExtension.size());
+    if (!rest.starts_with('.')) {
+      continue;
+    }
+    rest.remove_prefix(1);
+    std::uint64_t index = 0;
+    const auto [end, error] =
+        std::from_chars(rest.data(), rest.data() + rest.size(), index);
+    if (error == std::errc{} && end == rest.data() + rest.size()) {
+      next = std::max(next, index + 1);
+    }
+  }
+  return next;
+}
+
+/// One preallocated, mapped segment file (private).
+///
+/// Producers reserve byte ranges with `offset.fetch_add()` and copy into
+/// `data`; `writers` counts producers that may still touch the mapping, so
+/// a retired segment is only unmapped once it drops to zero. The object
+/// itself is reused for later segments and never freed while the logger is
+/// alive, so a producer holding a stale pointer can always inspect it.
+struct Segment {
+  std::atomic<std::size_t> offset{0};
+  std::atomic<std::uint32_t> writers{0};
+  std::byte *data = nullptr;
+  std::size_t used = 0;
+  int fd = -1;
+  std::filesystem::path path;
+};
+
+/// Memory-mapped rotating file logger implementation (private).
+///
+/// A write reserves space in the current segment and copies the message into
+/// the mapping, so the hot path makes no system calls. The producer whose
+/// reservation crosses the end of a segment swaps in the next segment, which
+/// a background thread has already created, `fallocate`d and mapped; the
+/// background thread then trims and closes the old one once its last writer
+/// has finished. Other producers that overflow the segment wait only for
+/// that pointer swap.
+///
+/// When a segment cannot be prepared (e.g. the disk is full), messages are
+/// dropped and counted until a later attempt succeeds.
+///
+/// Writers count their records in `StripedCounters`; `stats()` reports each
+/// completed segment as a flush.
+///
+/// `flush()` keeps the default no-op: once `log()` returns the message is in
+/// the shared mapping, so in the page cache and safe from a process crash.
+class MappedFileLogger final : public ILogger {
+public:
+  explicit MappedFileLogger(const MappedFileLoggerConfig &config)
+      : ILogger{config.rateLimit}, directory_{config.directory},
+        baseName_{config.baseName}, segmentSize_{config.segmentSize},
+        nextIndex_{nextSegmentIndex(directory_, baseName_)} {
+    open(segments_[0]);
+    current_.store(&segments_[0], std::memory_order_seq_cst);
+    worker_ = std::thread{[this] { run(); }};
+  }
+
+  ~MappedFileLogger() override {
+    {
+      const std::lock_guard lock{mutex_};
+      stopping_ = true;
+    }
+    workCv_.notify_one();
+    worker_.join();
+    if (Segment *segment = current_.load(std::memory_order_relaxed)) {
+      segment->used = std::min(
+          segment->offset.load(std::memory_order_relaxed), segmentSize_);
+      retire(*segment);
+    }
+    if (next_ != nullptr) {
+      next_->used = 0;
+      retire(*next_);
+      std::filesystem::remove(next_->path);
+    }
+  }
+
+  MappedFileLogger(const MappedFileLogger &) = delete;
+  auto operator=(const MappedFileLogger &) -> MappedFileLogger & = delete;
+  MappedFileLogger(MappedFileLogger &&) = delete;
+  auto operator=(MappedFileLogger &&) -> MappedFileLogger & = delete;
+
+  [[nodiscard]] auto droppedMessages() const -> std::uint64_t override {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto stats() const -> LoggerStats override {
+    LoggerStats result{
+        .dropped = droppedMessages(),
+        .flushes = completedSegments_.load(std::memory_order_relaxed)};
+    counters_.addTo(result);
+    return result;
+  }
+
+private:
+  void write(Level /*level*/, std::string_view message) override {
+    message = message.substr(0, segmentSize_ - 1);
+    const std::size_t length = message.size() + 1;
+    for (;;) {
+      Segment *segment = acquire();
+      if (segment == nullptr) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        requestRetry();
+        return;
+      }
+      const std::size_t offset =
+          segment->offset.fetch_add(length, std::memory_order_relaxed);
+      if (offset + length <= segmentSize_) {
+        std::memcpy(segment->data + offset, message.data(), message.size());
+        segment->data[offset + message.size()] = std::byte{'\n'};
+        segment->writers.fetch_sub(1, std::memory_order_release);
+        counters_.countRecord(length);
+        return;
+      }
+      segment->writers.fetch_sub(1, std::memory_order_release);
+      if (offset <= segmentSize_) {
+        // This reservation is the one that crossed the end: rotate.
+        rotate(*segment, offset);
+      } else {
+        waitForRotation(*segment);
+      }
+    }
+  }
+
+  /// Wait until `full` is no longer the current, full segment.
+  ///
+  /// Checking the offset as well as the pointer matters: the segment object
+  /// may already have been retired and reused as a fresh current segment.
+  void waitForRotation(const Segment &full) const {
+    while (current_.load(std::memory_order_seq_cst) == &full &&
+           full.offset.load(std::memory_order_relaxed) > segmentSize_) {
+      std::this_thread::yield();
+    }
+  }
+
+  /// Register as a writer of the current segment (producer side).
+  ///
+  /// ## Returns
+  /// The current segment, or nullptr if none could be prepared.
+  auto acquire() -> Segment * {
+    for (;;) {
+      Segment *segment = current_.load(std::memory_order_seq_cst);
+      if (segment == nullptr) {
+        return nullptr;
+      }
+      // Both seq_cst: either `rotate()` sees this writer before retiring the
+      // segment, or this thread sees the segment is no longer current.
+      segment->writers.fetch_add(1, std::memory_order_seq_cst);
+      if (current_.load(std::memory_order_seq_cst) == segment) {
+        return segment;
+      }
+      segment->writers.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  /// Replace the full segment `full`, whose first unused byte is `used`.
+  void rotate(Segment &full, std::size_t used) {
+    {
+      std::unique_lock lock{mutex_};
+      // Only waits if the background thread has fallen a segment behind.
+      readyCv_.wait(lock,
+                    [this] { return next_ != nullptr || prepareFailed_; });
+      full.used = used;
+      current_.store(std::exchange(next_, nullptr), std::memory_order_seq_cst);
+      retiring_ = &full;
+    }
+    completedSegments_.fetch_add(1, std::memory_order_relaxed);
+    workCv_.notify_one();
+  }
+
+  /// Ask the background thread to try preparing a segment again.
+  void requestRetry() {
+    if (!retryRequested_.exchange(true, std::memory_order_relaxed)) {
+      {
+        // Serialise with the background thread's predicate check so the
+        // notification cannot be lost.
+        const std::lock_guard lock{mutex_};
+      }
+      workCv_.notify_one();
+    }
+  }
+
+  /// Background thread body: retire full segments and prepare the next one.
+  void run() {
+    std::unique_lock lock{mutex_};
+    for (;;) {
+      workCv_.wait(lock, [this] {
+        return stopping_ || retiring_ != nullptr || wantsSegment();
+      });
+      if (retiring_ != nullptr) {
+        Segment *segment = std::exchange(retiring_, nullptr);
+        lock.unlock();
+        retire(*segment);
+        lock.lock();
+      } else if (stopping_) {
+        return;
+      } else {
+        retryRequested_.store(false, std::memory_order_relaxed);
+        Segment &segment = freeSegment();
+        lock.unlock();
+        bool prepared = true;
+        try {
+          open(segment);
+        } catch (const std::exception &) {
+          prepared = false;
+        }
+        lock.lock();
+        prepareFailed_ = !prepared;
+        if (prepared) {
+          if (current_.load(std::memory_order_relaxed) == nullptr) {
+            current_.store(&segment, std::memory_order_seq_cst);
+          } else {
+            next_ = &segment;
+          }
+        }
+        readyCv_.notify_all();
+      }
+    }
+  }
+
+  /// Whether the background thread should prepare a segment (under mutex_).
+  [[nodiscard]] auto wantsSegment() const -> bool {
+    const bool missing =
+        next_ == nullptr || current_.load(std::memory_order_relaxed) == nullptr;
+    return missing && (!prepareFailed_ ||
+                       retryRequested_.load(std::memory_order_relaxed));
+  }
+
+  /// A segment object that is neither current nor prepared (under mutex_).
+  ///
+  /// Full segments are retired before the next one is prepared, so with
+  /// three objects one is always free.
+  auto freeSegment() -> Segment & {
+    const Segment *current = current_.load(std::memory_order_relaxed);
+    for (Segment &segment : segments_) {
+      if (&segment != current && &segment != next_ && segment.data == nullptr) {
+        return segment;
+      }
+    }
+    throw std::logic_error("MappedFileLogger: no free segment");
+  }
+
+  /// Create, preallocate and map the next segment file into `segment`.
+  void open(Segment &segment) {
+    std::filesystem::path path =
+        directory_ / fmt::format("{}.{:06}{}", baseName_, nextIndex_++,
+                                 SegmentExtension);
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                          SegmentFileMode);
+    if (fd < 0) {
+      throwErrno(errno, "cannot create log segment '" + path.string() + "'");
+    }
+    const auto size = static_cast<::off_t>(segmentSize_);
+    if (const int error = ::posix_fallocate(fd, 0, size); error != 0) {
+      ::close(fd);
+      std::filesystem::remove(path);
+      throwErrno(error, "cannot preallocate log segment '" + path.string() +
+                            "'");
+    }
+    void *data = ::mmap(nullptr, segmentSize_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      ::close(fd);
+      std::filesystem::remove(path);
+      throwErrno(error, "cannot map log segment '" + path.string() + "'");
+    }
+    segment.data = static_cast<std::byte *>(data);
+    segment.used = 0;
+    segment.fd = fd;
+    segment.path = std::move(path);
+    segment.offset.store(0, std::memory_order_relaxed);
+  }
+
+  /// Wait for the last writer, then unmap, trim and close `segment`.
+  void retire(Segment &segment) const {
+    // seq_cst pairs with `acquire()`: see the comment there.
+    while (segment.writers.load(std::memory_order_seq_cst) != 0) {
+      std::this_thread::yield();
+    }
+    ::munmap(segment.data, segmentSize_);
+    static_cast<void>(
+        ::ftruncate(segment.fd, static_cast<::off_t>(segment.used)));
+    ::close(segment.fd);
+    segment.data = nullptr;
+    segment.fd = -1;
+  }
+
+  const std::filesystem::path directory_;
+  const std::string baseName_;
+  const std::size_t segmentSize_;
+  std::uint64_t nextIndex_;
+  std::array<Segment, 3> segments_;
+  alignas(CacheLineSize) std::atomic<Segment *> current_{nullptr};
+  alignas(CacheLineSize) std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<bool> retryRequested_{false};
+  std::atomic<std::uint64_t> completedSegments_{0};
+  StripedCounters counters_;
+  std::mutex mutex_;
+  std::condition_variable workCv_;
+  std::condition_variable readyCv_;
+  Segment *next_ = nullptr;
+  Segment *retiring_ = nullptr;
+  bool prepareFailed_ = false;
+  bool stopping_ = false;
+  std::thread worker_;
+};
+
+} // anonymous namespace
+
+auto createMappedFileLogger(const MappedFileLoggerConfig &config)
+    -> std::unique_ptr<ILogger> {
+  if (config.segmentSize < MinSegmentSize) {
+    throw std::invalid_argument(
+        "MappedFileLoggerConfig::segmentSize must be >= 4096");
+  }
+  if (config.baseName.empty()) {
+    throw std::invalid_argument(
+        "MappedFileLoggerConfig::baseName must not be empty");
+  }
+  std::filesystem::create_directories(config.directory);
+  return std::make_unique<MappedFileLogger>(config);
+}
+
+} // namespace sample::logger
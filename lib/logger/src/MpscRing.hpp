@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace sample::logger {
+
+/// Size used to keep independently written atomics on separate cache lines.
+inline constexpr std::size_t CacheLineSize = 64;
+
+/// Bounded lock-free multi-producer/single-consumer ring (private).
+///
+/// Each cell carries a sequence number that tells producers and the consumer
+/// whose turn it is (Vyukov's bounded queue). Producers contend on a single
+/// claim counter; the consumer owns the head counter, which producers only
+/// touch when they evict under an overflow policy. Values are constructed once
+/// and then reused in place so that a `T` with retained capacity (e.g.
+/// `std::string`) stops allocating once the ring is warm.
+template <typename T> class MpscRing {
+public:
+  /// Create a ring with `capacity` cells, rounded up to a power of two.
+  explicit MpscRing(std::size_t capacity)
+      : mask_{std::bit_ceil(capacity) - 1},
+        cells_{std::make_unique<Cell[]>(mask_ + 1)} {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Claim a free cell, fill it and publish it (any thread).
+  ///
+  /// `fill` is invoked exactly once with a reference to the cell's value and
+  /// must not throw: a claimed cell is always published.
+  ///
+  /// ## Returns
+  /// `false` without invoking `fill` if the ring is full.
+  template <typename Fill> auto tryPush(Fill &&fill) noexcept -> bool {
+    std::size_t pos = claim_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells_[pos & mask_];
+      const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (claim_.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed)) {
+          std::forward<Fill>(fill)(cell.value);
+          // seq_cst so a producer's later seq_cst load (e.g. of a "consumer
+          // parked" flag) cannot be reordered before the publication.
+          cell.sequence.store(pos + 1, std::memory_order_seq_cst);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = claim_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Pass the oldest published value to `consume` and free its cell.
+  ///
+  /// Normally called by the consumer thread. Producers may also call it to
+  /// evict the oldest value when the ring is full; the head is claimed with a
+  /// CAS so an evicting producer and the consumer never take the same cell.
+  ///
+  /// ## Returns
+  /// `false` without invoking `consume` if no value is ready.
+  template <typename Consume> auto tryPop(Consume &&consume) -> bool {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells_[pos & mask_];
+      const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          std::forward<Consume>(consume)(cell.value);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Whether a published value is ready at the head of the ring.
+  ///
+  /// The load is seq_cst so it pairs with the publication in `tryPush()`.
+  [[nodiscard]] auto readable() const -> bool {
+    const std::size_t pos = head_.load(std::memory_order_relaxed);
+    return cells_[pos & mask_].sequence.load(std::memory_order_seq_cst) ==
+           pos + 1;
+  }
+
+  /// Number of cells in the ring.
+  [[nodiscard]] auto capacity() const -> std::size_t { return mask_ + 1; }
+
+  /// Position just past every value claimed so far: each value the calling
+  /// thread has pushed lies below it.
+  [[nodiscard]] auto claimed() const -> std::size_t {
+    return claim_.load(std::memory_order_seq_cst);
+  }
+
+  /// Position of the next value to pop: every value below it has been
+  /// popped.
+  [[nodiscard]] auto popped() const -> std::size_t {
+    return head_.load(std::memory_order_acquire);
+  }
+
+  /// Number of values pushed or being pushed and not yet popped; a snapshot
+  /// that may already be stale.
+  [[nodiscard]] auto size() const -> std::size_t {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t claimed = claim_.load(std::memory_order_relaxed);
+    return claimed > head ? claimed - head : 0;
+  }
+
+private:
+  struct alignas(CacheLineSize) Cell {
+    std::atomic<std::size_t> sequence{0};
+    T value{};
+  };
+
+  std::size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(CacheLineSize) std::atomic<std::size_t> claim_{0};
+  alignas(CacheLineSize) std::atomic<std::size_t> head_{0};
+};
+
+} // namespace sample::logger
@@ -0,0 +1,696 @@
+#include "PerThreadAsyncLogger.hpp"
+
+#include "AsyncRecord.hpp"
+#include "BackendSignals.hpp"
+#include "Backoff.hpp"
+#include "BatchTap.hpp"
+#include "BinaryEncoder.hpp"
+#include "BinaryLogFormat.hpp"
+#include "CpuTopology.hpp"
+#include "CrashDrain.hpp"
+#include "CycleClock.hpp"
+#include "FdSink.hpp"
+#include "FlushWorker.hpp"
+#include "LineFormatter.hpp"
+#include "Lz4Encoder.hpp"
+#include "MpscRing.hpp"
+#include "RecordArena.hpp"
+#include "SpscRing.hpp"
+#include "StatsCounters.hpp"
+#include "ThreadSlots.hpp"
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/DeferredFormat.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerStats.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sample::logger {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Empty sweeps a backend makes before it parks on the wakeup counter (the
+/// starting budget with `WaitStrategy::Adaptive`).
+constexpr std::size_t SpinsBeforeSleep = 64;
+
+/// Upper bound on the batch capacity each backend reserves up front.
+constexpr std::size_t MaxInitialReserve = 64 * 1024;
+
+/// `ProducerQueue::holder` value of a queue nobody is draining.
+constexpr std::uint32_t Unheld = 0;
+
+/// `ProducerQueue::holder` value of a producer evicting from its own queue.
+constexpr std::uint32_t EvictingProducer =
+    std::numeric_limits<std::uint32_t>::max();
+
+/// One producer thread's queue (private).
+///
+/// Only the owning thread pushes. Whoever pops (a backend, or the producer
+/// evicting under an overflow policy) first claims `holder`, whose
+/// acquire/release hand-over orders successive consumers of the ring.
+struct ProducerQueue {
+  ProducerQueue(std::size_t capacity, std::size_t arenaBytes,
+                unsigned numaNode, std::optional<unsigned> memoryNode,
+                std::size_t homeBackend)
+      : ring{capacity, memoryNode}, arena{arenaBytes, memoryNode},
+        node{numaNode}, home{homeBackend} {}
+
+  SpscRing<Record> ring;
+  /// Holds the records of the ring longer than `inlineRecordBytes`.
+  RecordArena arena;
+  /// NUMA node the registering thread was running on.
+  unsigned node;
+  /// Index of the backend that drains the queue first; the others only
+  /// steal from it.
+  std::size_t home;
+  alignas(CacheLineSize) std::atomic<std::uint32_t> holder{Unheld};
+  /// Set when the owning thread exits; the logger then hands the queue (and
+  /// anything still in it) to the next thread that registers.
+  std::atomic<bool> abandoned{false};
+  /// Ring position below which every record has been written to the output;
+  /// stored by the backend that held the queue as it lets go.
+  std::atomic<std::size_t> written{0};
+  /// The queue registered before this one, so the crash handler and
+  /// `stats()` can walk the queues without taking the logger's mutex.
+  ProducerQueue *next = nullptr;
+};
+
+thread_local ThreadSlots<ProducerQueue> threadQueues;
+
+/// Asynchronous logger with a queue per producer thread (private).
+///
+/// A thread's first message registers an `SpscRing` for it; after that a
+/// producer only writes its own ring. `backendThreads` backends drain the
+/// rings: each backend sweeps the rings it is home to, and steals from the
+/// other rings when its own share is empty. A backend
+/// claims each ring it takes records from and keeps the claim until the batch
+/// holding them is written, so one thread's messages are never reordered.
+/// Batching, lingering, parking and the `waitStrategy`, through a `Backoff`
+/// per backend, follow the shared-ring `AsyncLogger`;
+/// several backends serialise only their `write(2)` calls, not their calls
+/// to the `LogTap`. Each backend keeps its own `WriterStats`, summed by
+/// `stats()`. The backends start with the first queue.
+///
+/// A ring's home backend is picked round-robin at registration or, with
+/// `backendPerNode`, as the backend of the producer's NUMA node; with
+/// `nodeLocalQueues` its ring is allocated on that node too, like the
+/// queue's `RecordArena` for records longer than `inlineRecordBytes`, whose
+/// blocks the backends free once formatted.
+///
+/// Backends record in each queue how much of it they have written. While
+/// `flushWaiters_` is non-zero they stop lingering and bump `flushEpoch_`
+/// after every batch; `flush()` waits on it for its own queue, the crash
+/// handler for all of them, and `flushThen()` for the calling thread's
+/// queue from the library's background thread.
+class PerThreadAsyncLogger final : public ILogger, private CrashDrainable {
+public:
+  explicit PerThreadAsyncLogger(const AsyncLoggerConfig &config)
+      : ILogger{config.rateLimit}, capacity_{config.capacity},
+        maxBatchBytes_{config.maxBatchBytes}, maxLatency_{config.maxLatency},
+        timestamps_{config.timestamps}, latency_{config.latencyHistogram},
+        binary_{config.outputFormat == OutputFormat::Binary},
+        lineFormat_{config.lineFormat},
+        inlineRecordBytes_{config.inlineRecordBytes},
+        arenaBytes_{config.arenaBytes}, waitStrategy_{config.waitStrategy},
+        nodeLocalQueues_{config.nodeLocalQueues},
+        backendCpus_{config.backendCpus},
+        backendNodes_{config.backendPerNode ? numaNodes()
+                                            : std::vector<NumaNode>{}},
+        backendCount_{config.backendPerNode ? backendNodes_.size()
+                                            : config.backendThreads},
+        backendStats_{std::make_unique<WriterStats[]>(backendCount_)},
+        backendThreadIds_{
+            std::make_unique<std::atomic<int>[]>(backendCount_)},
+        tap_{config.tap}, sink_{config},
+        overflow_{config.overflowPolicy, config.sampleRate} {
+    if (binary_) {
+      sink_.write(binary::SessionMagic);
+      BatchTap{&tap_}.publish(Level::Off, binary::SessionMagic);
+    }
+    backends_.reserve(backendCount_);
+    registerCrashDrain(*this);
+  }
+
+  ~PerThreadAsyncLogger() override {
+    unregisterCrashDrain(*this);
+    stop();
+  }
+
+  PerThreadAsyncLogger(const PerThreadAsyncLogger &) = delete;
+  auto operator=(const PerThreadAsyncLogger &)
+      -> PerThreadAsyncLogger & = delete;
+  PerThreadAsyncLogger(PerThreadAsyncLogger &&) = delete;
+  auto operator=(PerThreadAsyncLogger &&) -> PerThreadAsyncLogger & = delete;
+
+  [[nodiscard]] auto droppedMessages() const -> std::uint64_t override {
+    return overflow_.dropped();
+  }
+
+  [[nodiscard]] auto stats() const -> LoggerStats override {
+    LoggerStats result{.dropped = droppedMessages()};
+    for (std::size_t index = 0; index < backendCount_; ++index) {
+      backendStats_[index].addTo(result);
+    }
+    for (const ProducerQueue *queue =
+             firstQueue_.load(std::memory_order_acquire);
+         queue != nullptr; queue = queue->next) {
+      queue->arena.addTo(result);
+    }
+    return result;
+  }
+
+  void flush() override {
+    const ProducerQueue *queue = threadQueues.find(id_);
+    if (queue == nullptr) {
+      return;
+    }
+    const std::size_t target = queue->ring.pushed();
+    if (queue->written.load(std::memory_order_acquire) >= target) {
+      return;
+    }
+    awaitWritten([queue, target] {
+      return queue->written.load(std::memory_order_seq_cst) >= target;
+    }, std::nullopt);
+  }
+
+  void flushThen(FlushCallback done) override {
+    const ProducerQueue *queue = threadQueues.find(id_);
+    const std::size_t target = queue != nullptr ? queue->ring.pushed() : 0;
+    if (queue == nullptr ||
+        queue->written.load(std::memory_order_acquire) >= target) {
+      done();
+      return;
+    }
+    // The target is this thread's; only the wait moves to the background.
+    runInBackground([this, queue, target, done = std::move(done)]() mutable {
+      awaitWritten([queue, target] {
+        return queue->written.load(std::memory_order_seq_cst) >= target;
+      }, std::nullopt);
+      done();
+    });
+  }
+
+  void drainForCrash(Clock::time_point deadline) noexcept override {
+    const int thread = currentThreadId();
+    for (std::size_t index = 0; index < backendCount_; ++index) {
+      if (backendThreadIds_[index].load(std::memory_order_relaxed) ==
+          thread) {
+        return;
+      }
+    }
+    // The queue list only grows at its head, so a snapshot of the targets
+    // covers every queue registered before the crash.
+    std::array<std::size_t, MaxCrashQueues> targets{};
+    const ProducerQueue *first = firstQueue_.load(std::memory_order_acquire);
+    std::size_t count = 0;
+    for (const ProducerQueue *queue = first;
+         queue != nullptr && count < MaxCrashQueues; queue = queue->next) {
+      targets[count++] = queue->ring.pushed();
+    }
+    awaitWritten([first, &targets, count] {
+      std::size_t index = 0;
+      for (const ProducerQueue *queue = first; index < count;
+           queue = queue->next) {
+        if (queue->written.load(std::memory_order_seq_cst) < targets[index++]) {
+          return false;
+        }
+      }
+      return true;
+    }, deadline);
+  }
+
+private:
+  /// Most producer queues the crash handler waits for.
+  static constexpr std::size_t MaxCrashQueues = 256;
+
+  /// A backend thread's private state.
+  struct Backend {
+    std::size_t index = 0;
+    std::uint32_t tag = Unheld;
+    std::vector<ProducerQueue *> queues;
+    std::uint64_t generation = 0;
+    std::vector<ProducerQueue *> held;
+    fmt::memory_buffer batch;
+    BatchTap tap;
+    Clock::time_point deadline;
+    std::optional<LineFormatter> lines;
+    std::optional<BinaryEncoder> encoder;
+    WriterStats *stats = nullptr;
+    std::optional<Backoff> backoff;
+    std::optional<Lz4Encoder> compressor;
+    std::uint64_t records = 0;
+    std::vector<std::uint64_t> stamps;
+    CycleClock clock;
+  };
+
+  void write(Level level, std::string_view message) override {
+    enqueue(message.size(), [level, message, cycles = stamp()](
+                                Record &slot, RecordArena *arena) noexcept {
+      slot.assign(level, cycles, nullptr, message.data(), message.size(),
+                  arena);
+    });
+  }
+
+  void writeDeferred(Level level, const DeferredFormat &format,
+                     std::span<const std::byte> args) override {
+    enqueue(args.size(), [level, &format, args, cycles = stamp()](
+                             Record &slot, RecordArena *arena) noexcept {
+      slot.assign(level, cycles, &format,
+                  reinterpret_cast<const char *>(args.data()), args.size(),
+                  arena);
+    });
+  }
+
+  /// The timestamp for a record logged now, or 0 if neither timestamps nor
+  /// latencies are recorded.
+  [[nodiscard]] auto stamp() const -> std::uint64_t {
+    return timestamps_ || latency_ ? readCycleCounter() : 0;
+  }
+
+  /// Publish a record of `size` bytes filled by `fill`, applying the
+  /// overflow policy.
+  ///
+  /// `fill` is given the queue's arena if the record is too long for its
+  /// slot.
+  template <typename Fill> void enqueue(std::size_t size, const Fill &fill) {
+    ProducerQueue &queue = localQueue();
+    RecordArena *arena =
+        size > inlineRecordBytes_ ? queue.arena.ready() : nullptr;
+    const auto fillSlot = [&fill, arena](Record &slot) noexcept {
+      fill(slot, arena);
+    };
+    if (!queue.ring.tryPush(fillSlot)) {
+      handleOverflow(queue, fillSlot);
+    }
+    // `SpscRing::tryPush()` publishes seq_cst, as `wakeParked()` requires.
+    wakeup_.wakeParked();
+  }
+
+  /// The calling thread's queue, registering one on first use.
+  ///
+  /// ## Throws
+  /// `std::system_error` if the backends are not all running and one cannot
+  /// be started; nothing is registered then.
+  auto localQueue() -> ProducerQueue & {
+    if (ProducerQueue *queue = threadQueues.find(id_)) {
+      return *queue;
+    }
+    const bool nodeAware = nodeLocalQueues_ || !backendNodes_.empty();
+    const unsigned node = nodeAware ? currentNumaNode() : 0;
+    std::shared_ptr<ProducerQueue> queue;
+    {
+      const std::lock_guard lock{queuesMutex_};
+      startBackends();
+      for (const auto &candidate : queues_) {
+        if (candidate->node == node &&
+            candidate->abandoned.load(std::memory_order_acquire)) {
+          candidate->abandoned.store(false, std::memory_order_relaxed);
+          queue = candidate;
+          break;
+        }
+      }
+      if (!queue) {
+        queue = std::make_shared<ProducerQueue>(
+            capacity_, arenaBytes_, node,
+            nodeLocalQueues_ ? std::optional{node} : std::nullopt,
+            homeBackend(node));
+        queue->next = firstQueue_.load(std::memory_order_relaxed);
+        firstQueue_.store(queue.get(), std::memory_order_release);
+        queues_.push_back(queue);
+        // seq_cst: pairs with the load in `anyReadable()`, so a parking
+        // backend either sees the new queue or is seen by `wakeParked()`.
+        generation_.fetch_add(1, std::memory_order_seq_cst);
+      }
+    }
+    ProducerQueue &result = *queue;
+    threadQueues.add(id_, std::move(queue));
+    return result;
+  }
+
+  /// The home backend of a queue registered now on NUMA node `node` (under
+  /// `queuesMutex_`).
+  [[nodiscard]] auto homeBackend(unsigned node) const -> std::size_t {
+    const auto local = std::ranges::find(backendNodes_, node, &NumaNode::id);
+    if (local != backendNodes_.end()) {
+      return static_cast<std::size_t>(local - backendNodes_.begin());
+    }
+    return queues_.size() % backendCount_;
+  }
+
+  /// Apply the overflow policy to a message that did not fit (producer side).
+  ///
+  /// If a backend holds the queue the producer cannot evict without waiting
+  /// for it, so the new record is discarded instead.
+  template <typename Fill>
+  void handleOverflow(ProducerQueue &queue, const Fill &fill) {
+    const auto tryPush = [&queue, &fill] { return queue.ring.tryPush(fill); };
+    const auto evictOldest = [&queue] {
+      std::uint32_t expected = Unheld;
+      if (!queue.holder.compare_exchange_strong(expected, EvictingProducer,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+        return Eviction::Refused;
+      }
+      const bool evicted =
+          queue.ring.tryPop([](const Record &record) { record.release(); });
+      queue.holder.store(Unheld, std::memory_order_release);
+      return evicted ? Eviction::Evicted : Eviction::Empty;
+    };
+    wakeup_.wakeLingering();
+    overflow_.handle(tryPush, evictOldest, [this] { wakeup_.wakeParked(); });
+  }
+
+  /// Have the backends write their batches at once until `written()` holds
+  /// or `deadline` passes.
+  template <typename Written>
+  void awaitWritten(const Written &written,
+                    std::optional<Clock::time_point> deadline) {
+    // seq_cst pairs with `publishWritten()`: either the backend sees a
+    // waiter, or this thread sees what it wrote.
+    flushWaiters_.fetch_add(1, std::memory_order_seq_cst);
+    wakeup_.wakeAll();
+    static_cast<void>(flushEpoch_.await(written, deadline));
+    flushWaiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Whether a `flush()` or the crash handler is waiting for the backends.
+  [[nodiscard]] auto flushRequested() const -> bool {
+    return flushWaiters_.load(std::memory_order_relaxed) != 0;
+  }
+
+  /// Start the backends not yet running (under `queuesMutex_`).
+  ///
+  /// Called as each queue is registered, so a logger nobody logs to starts
+  /// no thread, and backends that failed to start are retried. A backend
+  /// missing meanwhile only leaves its share of the queues to be stolen.
+  void startBackends() {
+    while (backends_.size() < backendCount_) {
+      const std::size_t index = backends_.size();
+      backends_.emplace_back([this, index] { run(index); });
+    }
+  }
+
+  /// Stop and join the backends; they drain every queue first.
+  void stop() {
+    stopping_.store(true, std::memory_order_release);
+    wakeup_.wakeAll();
+    for (std::thread &backend : backends_) {
+      backend.join();
+    }
+  }
+
+  /// Backend thread body.
+  void run(std::size_t index) {
+    Backend self;
+    self.index = index;
+    self.tag = static_cast<std::uint32_t>(index + 1);
+    self.stats = &backendStats_[index];
+    self.backoff.emplace(waitStrategy_, SpinsBeforeSleep, maxBatchBytes_,
+                         *self.stats);
+    self.tap = BatchTap{&tap_};
+    if (!backendNodes_.empty()) {
+      pinCurrentThread(backendNodes_[index].cpus);
+    } else if (!backendCpus_.empty()) {
+      pinCurrentThread({&backendCpus_[index % backendCpus_.size()], 1});
+    }
+    backendThreadIds_[index].store(currentThreadId(),
+                                   std::memory_order_relaxed);
+    self.batch.reserve(std::min(maxBatchBytes_, MaxInitialReserve));
+    if (binary_) {
+      self.encoder.emplace(formatIds_, timestamps_);
+    } else {
+      self.lines.emplace(lineFormat_, timestamps_);
+    }
+    if (sink_.compression() == Compression::Lz4) {
+      self.compressor.emplace();
+    }
+    for (;;) {
+      const bool stopping = stopping_.load(std::memory_order_acquire);
+      refreshQueues(self);
+      std::size_t count = sweep(self, true);
+      if (count == 0) {
+        count = sweep(self, false);
+      }
+      if (self.batch.size() != 0) {
+        if (stopping || flushRequested() ||
+            maxLatency_ == Clock::duration::zero() ||
+            Clock::now() >= self.deadline) {
+          flush(self);
+        } else {
+          lingerUntil(self);
+        }
+        continue;
+      }
+      if (count == 0) {
+        if (stopping) {
+          self.backoff->noteCpuTime();
+          return;
+        }
+        waitForRecords(self);
+      }
+    }
+  }
+
+  /// Pick up queues registered since the backend last looked.
+  void refreshQueues(Backend &self) {
+    const std::uint64_t generation =
+        generation_.load(std::memory_order_acquire);
+    if (generation == self.generation) {
+      return;
+    }
+    const std::lock_guard lock{queuesMutex_};
+    self.queues.clear();
+    for (const auto &queue : queues_) {
+      self.queues.push_back(queue.get());
+    }
+    self.generation = generation;
+  }
+
+  /// Drain the backend's own share of the queues (`home`) or the others.
+  ///
+  /// ## Returns
+  /// Number of records consumed.
+  auto sweep(Backend &self, bool home) -> std::size_t {
+    std::size_t count = 0;
+    for (ProducerQueue *queue : self.queues) {
+      if ((queue->home == self.index) == home) {
+        count += drain(self, *queue);
+      }
+    }
+    return count;
+  }
+
+  /// Format up to one ring's worth of `queue`'s records into the batch.
+  ///
+  /// ## Returns
+  /// Number of records consumed.
+  auto drain(Backend &self, ProducerQueue &queue) -> std::size_t {
+    if (!hold(self, queue)) {
+      return 0;
+    }
+    const std::size_t depth = queue.ring.size();
+    self.stats->noteQueueDepth(depth);
+    self.backoff->noteDepth(depth);
+    const std::size_t quota = queue.ring.capacity();
+    std::size_t count = 0;
+    while (count < quota &&
+           queue.ring.tryPop([this, &self](const Record &record) {
+             append(self, record);
+             record.release();
+           })) {
+      ++count;
+      if (self.batch.size() >= self.backoff->batchBytes()) {
+        flush(self);
+        if (!hold(self, queue)) {
+          break;
+        }
+      }
+    }
+    return count;
+  }
+
+  /// Claim `queue` for the backend unless it is idle or held elsewhere.
+  auto hold(Backend &self, ProducerQueue &queue) -> bool {
+    std::uint32_t holder = queue.holder.load(std::memory_order_relaxed);
+    if (holder == self.tag) {
+      return true;
+    }
+    if (holder != Unheld || !queue.ring.readable() ||
+        !queue.holder.compare_exchange_strong(holder, self.tag,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+      return false;
+    }
+    self.held.push_back(&queue);
+    return true;
+  }
+
+  /// Append `record` and its line terminator to the backend's batch.
+  void append(Backend &self, const Record &record) {
+    if (self.batch.size() == 0 && maxLatency_ != Clock::duration::zero()) {
+      self.deadline = Clock::now() + maxLatency_;
+    }
+    if (self.encoder) {
+      self.encoder->append(record, self.batch);
+    } else {
+      self.lines->append(record, self.batch);
+    }
+    self.tap.endRecord(record.level, self.batch.size());
+    ++self.records;
+    if (latency_) {
+      self.stamps.push_back(record.cycles);
+    }
+  }
+
+  /// Write the batch, then release the queues its records came from,
+  /// publishing how far each has been written.
+  void flush(Backend &self) {
+    if (self.batch.size() != 0) {
+      self.tap.publish(self.batch);
+      std::string_view bytes{self.batch.data(), self.batch.size()};
+      if (self.compressor) {
+        bytes = self.compressor->encode(bytes);
+      }
+      {
+        const std::lock_guard lock{outputMutex_};
+        sink_.writeEncoded(bytes);
+      }
+      self.stats->countFlush(self.records, self.batch.size());
+      countLatencies(self);
+    }
+    self.records = 0;
+    self.batch.clear();
+    for (ProducerQueue *queue : self.held) {
+      queue->written.store(queue->ring.popped(), std::memory_order_seq_cst);
+      queue->holder.store(Unheld, std::memory_order_release);
+    }
+    self.held.clear();
+    publishWritten();
+    self.backoff->noteCpuTime();
+  }
+
+  /// Wake the `flush()` calls waiting for the positions just written.
+  void publishWritten() {
+    if (flushWaiters_.load(std::memory_order_seq_cst) != 0) {
+      flushEpoch_.advance();
+    }
+  }
+
+  /// Count the latency of each record of the batch just written.
+  void countLatencies(Backend &self) const {
+    if (!latency_) {
+      return;
+    }
+    const std::uint64_t now = readCycleCounter();
+    for (const std::uint64_t cycles : self.stamps) {
+      self.stats->countLatency(self.clock.elapsed(cycles, now));
+    }
+    self.stamps.clear();
+  }
+
+  /// Wait for more records until the batch deadline, holding a partial
+  /// batch.
+  ///
+  /// Polling stops for records in the queues the backend holds, too: their
+  /// producers may be blocked on a full ring, with nothing else to wake it.
+  void lingerUntil(Backend &self) {
+    const auto ready = [this, &self] {
+      return anyReadable(self) ||
+             std::ranges::any_of(self.held,
+                                 [](const ProducerQueue *queue) {
+                                   return queue->ring.readable();
+                                 }) ||
+             stopping_.load(std::memory_order_relaxed) || flushRequested();
+    };
+    wakeup_.linger(
+        *self.backoff, ready,
+        [this] {
+          return stopping_.load(std::memory_order_relaxed) || flushRequested();
+        },
+        self.deadline);
+  }
+
+  /// Whether a sweep could make progress: a new queue was registered, or an
+  /// unclaimed queue has records.
+  [[nodiscard]] auto anyReadable(const Backend &self) const -> bool {
+    if (generation_.load(std::memory_order_seq_cst) != self.generation) {
+      return true;
+    }
+    return std::ranges::any_of(self.queues, [](const ProducerQueue *queue) {
+      return queue->holder.load(std::memory_order_relaxed) == Unheld &&
+             queue->ring.readable();
+    });
+  }
+
+  /// Poll as the wait strategy says, then park until a producer or the
+  /// destructor wakes us.
+  ///
+  /// Queues claimed by another backend do not count as work: that backend
+  /// sweeps them again before it parks itself.
+  void waitForRecords(Backend &self) {
+    const auto ready = [this, &self] {
+      return anyReadable(self) || stopping_.load(std::memory_order_relaxed);
+    };
+    wakeup_.park(*self.backoff, ready);
+  }
+
+  const std::uint64_t id_ = nextThreadSlotsOwner();
+  const std::size_t capacity_;
+  const std::size_t maxBatchBytes_;
+  const Clock::duration maxLatency_;
+  const bool timestamps_;
+  const bool latency_;
+  const bool binary_;
+  const LineFormat lineFormat_;
+  const std::size_t inlineRecordBytes_;
+  const std::size_t arenaBytes_;
+  const WaitStrategy waitStrategy_;
+  const bool nodeLocalQueues_;
+  const std::vector<unsigned> backendCpus_;
+  const std::vector<NumaNode> backendNodes_;
+  const std::size_t backendCount_;
+  const std::unique_ptr<WriterStats[]> backendStats_;
+  const std::unique_ptr<std::atomic<int>[]> backendThreadIds_;
+  const LogTap tap_;
+  FdSink sink_;
+  FormatIds formatIds_;
+  std::mutex outputMutex_;
+  std::mutex queuesMutex_;
+  std::vector<std::shared_ptr<ProducerQueue>> queues_;
+  std::atomic<ProducerQueue *> firstQueue_{nullptr};
+  std::atomic<bool> stopping_{false};
+  alignas(CacheLineSize) OverflowHandler overflow_;
+  alignas(CacheLineSize) std::atomic<std::uint64_t> generation_{0};
+  BackendWakeup wakeup_;
+  alignas(CacheLineSize) std::atomic<std::uint32_t> flushWaiters_{0};
+  FlushEpoch flushEpoch_;
+  std::vector<std::thread> backends_;
+};
+
+} // anonymous namespace
+
+auto createPerThreadAsyncLogger(const AsyncLoggerConfig &config)
+    -> std::unique_ptr<ILogger> {
+  return std::make_unique<PerThreadAsyncLogger>(config);
+}
+
+} // namespace sample::logger
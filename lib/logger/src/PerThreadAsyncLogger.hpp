@@ -0,0 +1,19 @@
+#pragma once
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+
+#include <memory>
+
+namespace sample::logger {
+
+/// Create the `QueueMode::PerThread` asynchronous logger (private).
+///
+/// Called by `createAsyncLogger()`, which validates `config` first.
+///
+/// ## Throws
+/// `std::system_error` if the output file cannot be opened.
+auto createPerThreadAsyncLogger(const AsyncLoggerConfig &config)
+    -> std::unique_ptr<ILogger>;
+
+} // namespace sample::logger
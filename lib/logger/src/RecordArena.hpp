@@ -0,0 +1,175 @@
+#pragma once
+
+#include "CpuTopology.hpp"
+#include "StatsCounters.hpp"
+
+#include <logger/LoggerStats.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <string_view>
+
+namespace sample::logger {
+
+/// Bump allocator for the text of oversize records, owned by one producer
+/// thread (private).
+///
+/// Blocks are carved in allocation order from a ring of memory allocated
+/// with the first block. Whoever is done with a block (the backend once the
+/// record is formatted, or a producer evicting it) frees it with
+/// `release()`, from any thread and in any order; the owning thread reclaims
+/// free blocks from the oldest end as it allocates, so a block's memory is
+/// reused only once every older block is free too. A record that does not
+/// fit is left to the heap and counted as a fallback.
+class RecordArena {
+public:
+  /// Header of an allocated block; its text follows.
+  struct Block {
+    /// Chunks the block occupies, header and padding included.
+    std::uint32_t chunks;
+    /// Length of the text.
+    std::uint32_t size;
+    /// Cleared by `release()`.
+    std::atomic<bool> live;
+  };
+
+  /// An arena of `bytes` bytes (rounded up to the block alignment), placed
+  /// on NUMA node `node` if one is given.
+  RecordArena(std::size_t bytes, std::optional<unsigned> node)
+      : chunkCount_{(bytes + sizeof(Chunk) - 1) / sizeof(Chunk)},
+        node_{node} {}
+
+  /// Allocate the memory, unless already done (owning thread).
+  ///
+  /// ## Returns
+  /// `this`, or null if the arena has no memory (is configured empty).
+  ///
+  /// ## Throws
+  /// `std::bad_alloc` if the memory cannot be allocated.
+  auto ready() -> RecordArena * {
+    if (!chunks_ && chunkCount_ != 0) {
+      chunks_.emplace(chunkCount_, node_);
+    }
+    return chunks_ ? this : nullptr;
+  }
+
+  /// Copy `text` into a new block (owning thread, after `ready()`).
+  ///
+  /// ## Returns
+  /// The block, or null if there is no room for it; that counts as a
+  /// fallback.
+  auto allocate(std::string_view text) noexcept -> const Block * {
+    const std::size_t need = chunksFor(text.size());
+    if (need > chunkCount_ || text.size() > UINT32_MAX) {
+      bump(fallbacks_, 1);
+      return nullptr;
+    }
+    reclaim();
+    if (used_ == 0) {
+      head_ = 0;
+      tail_ = 0;
+    }
+    if (!makeRoom(need)) {
+      bump(fallbacks_, 1);
+      return nullptr;
+    }
+    Block *block = place(need, static_cast<std::uint32_t>(text.size()), true);
+    std::memcpy(static_cast<void *>(block + 1), text.data(), text.size());
+    bump(records_, 1);
+    return block;
+  }
+
+  /// The text of `block`.
+  [[nodiscard]] static auto text(const Block &block) -> std::string_view {
+    return {reinterpret_cast<const char *>(&block + 1), block.size};
+  }
+
+  /// Free `block` (any thread); its text must no longer be read.
+  static void release(const Block &block) noexcept {
+    // The const_cast only reaches the atomic flag, which the owning thread
+    // reads to reclaim the block.
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    const_cast<Block &>(block).live.store(false, std::memory_order_release);
+  }
+
+  /// Add the arena's counts to `stats`.
+  void addTo(LoggerStats &stats) const {
+    stats.arenaRecords += records_.load(std::memory_order_relaxed);
+    stats.arenaFallbacks += fallbacks_.load(std::memory_order_relaxed);
+  }
+
+private:
+  /// Unit of allocation; keeps every block header aligned.
+  struct alignas(alignof(Block)) Chunk {
+    std::array<std::byte, 16> bytes;
+  };
+
+  static_assert(sizeof(Block) <= sizeof(Chunk));
+
+  /// Chunks a block holding `size` bytes of text occupies.
+  [[nodiscard]] static auto chunksFor(std::size_t size) -> std::size_t {
+    return (sizeof(Block) + size + sizeof(Chunk) - 1) / sizeof(Chunk);
+  }
+
+  [[nodiscard]] auto blockAt(std::size_t chunk) -> Block * {
+    return reinterpret_cast<Block *>(&(*chunks_)[chunk]);
+  }
+
+  /// Write a block header of `chunks` chunks at the tail and advance it.
+  auto place(std::size_t chunks, std::uint32_t size, bool live) -> Block * {
+    auto *block = new (&(*chunks_)[tail_])
+        Block{.chunks = static_cast<std::uint32_t>(chunks),
+              .size = size,
+              .live = live};
+    tail_ = (tail_ + chunks) % chunkCount_;
+    used_ += chunks;
+    return block;
+  }
+
+  /// Make `need` contiguous chunks free at the tail, wrapping around to the
+  /// start if they do not fit before the end.
+  auto makeRoom(std::size_t need) -> bool {
+    if (used_ != 0 && tail_ == head_) {
+      return false;
+    }
+    if (tail_ < head_) {
+      return head_ - tail_ >= need;
+    }
+    if (chunkCount_ - tail_ >= need) {
+      return true;
+    }
+    if (head_ < need) {
+      return false;
+    }
+    place(chunkCount_ - tail_, 0, false);
+    return true;
+  }
+
+  /// Advance the head past every released block.
+  void reclaim() {
+    while (used_ != 0) {
+      const Block *block = blockAt(head_);
+      if (block->live.load(std::memory_order_acquire)) {
+        return;
+      }
+      head_ = (head_ + block->chunks) % chunkCount_;
+      used_ -= block->chunks;
+    }
+  }
+
+  const std::size_t chunkCount_;
+  const std::optional<unsigned> node_;
+  std::optional<NodeLocalArray<Chunk>> chunks_;
+  std::size_t head_ = 0;
+  std::size_t tail_ = 0;
+  std::size_t used_ = 0;
+  std::atomic<std::uint64_t> records_{0};
+  std::atomic<std::uint64_t> fallbacks_{0};
+};
+
+} // namespace sample::logger
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CpuTopology.hpp"
+#include "MpscRing.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace sample::logger {
+
+/// Bounded lock-free single-producer/single-consumer ring (private).
+///
+/// The producer owns the tail counter and the consumer the head counter; each
+/// side keeps a private copy of the other's counter and only reloads it when
+/// the ring looks full (or empty), so in steady state neither side reads a
+/// cache line the other writes. Values are reused in place, as in `MpscRing`.
+///
+/// "Single consumer" means one at a time: callers that hand the consumer role
+/// between threads must order the hand-over themselves (e.g. with an
+/// acquire/release flag).
+template <typename T> class SpscRing {
+public:
+  /// Create a ring with `capacity` cells, rounded up to a power of two,
+  /// in memory on NUMA node `node` if one is given.
+  explicit SpscRing(std::size_t capacity,
+                    std::optional<unsigned> node = std::nullopt)
+      : mask_{std::bit_ceil(capacity) - 1}, cells_{mask_ + 1, node} {}
+
+  /// Fill the next free cell and publish it (producer side).
+  ///
+  /// `fill` is invoked at most once and must not throw.
+  ///
+  /// ## Returns
+  /// `false` without invoking `fill` if the ring is full.
+  template <typename Fill> auto tryPush(Fill &&fill) noexcept -> bool {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ > mask_) {
+      cachedHead_ = head_.load(std::memory_order_acquire);
+      if (tail - cachedHead_ > mask_) {
+        return false;
+      }
+    }
+    std::forward<Fill>(fill)(cells_[tail & mask_]);
+    // seq_cst for the same reason as in `MpscRing::tryPush()`.
+    tail_.store(tail + 1, std::memory_order_seq_cst);
+    return true;
+  }
+
+  /// Pass the oldest published value to `consume` and free its cell
+  /// (consumer side).
+  ///
+  /// ## Returns
+  /// `false` without invoking `consume` if the ring is empty.
+  template <typename Consume> auto tryPop(Consume &&consume) -> bool {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cachedTail_) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      if (head == cachedTail_) {
+        return false;
+      }
+    }
+    std::forward<Consume>(consume)(cells_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Whether a published value is waiting (any thread).
+  ///
+  /// The tail load is seq_cst so it pairs with the publication in
+  /// `tryPush()`.
+  [[nodiscard]] auto readable() const -> bool {
+    return head_.load(std::memory_order_acquire) !=
+           tail_.load(std::memory_order_seq_cst);
+  }
+
+  /// Number of cells in the ring.
+  [[nodiscard]] auto capacity() const -> std::size_t { return mask_ + 1; }
+
+  /// Position just past every value pushed so far.
+  [[nodiscard]] auto pushed() const -> std::size_t {
+    return tail_.load(std::memory_order_acquire);
+  }
+
+  /// Position of the next value to pop: every value below it has been
+  /// popped.
+  [[nodiscard]] auto popped() const -> std::size_t {
+    return head_.load(std::memory_order_acquire);
+  }
+
+  /// Number of values pushed and not yet popped; a snapshot that may
+  /// already be stale.
+  [[nodiscard]] auto size() const -> std::size_t {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+private:
+  std::size_t mask_;
+  NodeLocalArray<T> cells_;
+  alignas(CacheLineSize) std::atomic<std::size_t> tail_{0};
+  std::size_t cachedHead_ = 0;
+  alignas(CacheLineSize) std::atomic<std::size_t> head_{0};
+  std::size_t cachedTail_ = 0;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,59 @@
+#include <logger/StagingBuffer.hpp>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+namespace sample::logger {
+
+namespace {
+
+/// Buffers per thread; bounds how deeply leases can nest without allocating.
+constexpr std::size_t PoolSize = 4;
+
+/// Slot index marking a lease that fell back to its own buffer.
+constexpr std::size_t NoSlot = PoolSize;
+
+/// Capacity above which a returned buffer is released rather than kept, so
+/// that one huge message does not pin memory for the life of the thread.
+constexpr std::size_t MaxRetainedCapacity = 1024 * 1024;
+
+/// Per-thread pool of staging buffers (private).
+struct StagingPool {
+  std::array<fmt::memory_buffer, PoolSize> buffers;
+  std::array<bool, PoolSize> leased{};
+};
+
+thread_local StagingPool threadPool;
+
+} // anonymous namespace
+
+StagingBuffer::StagingBuffer() : buffer_{nullptr}, slot_{NoSlot} {
+  StagingPool &pool = threadPool;
+  for (std::size_t slot = 0; slot < PoolSize; ++slot) {
+    if (!pool.leased[slot]) {
+      pool.leased[slot] = true;
+      slot_ = slot;
+      buffer_ = &pool.buffers[slot];
+      buffer_->clear();
+      return;
+    }
+  }
+  fallback_ = std::make_unique<fmt::memory_buffer>();
+  buffer_ = fallback_.get();
+}
+
+StagingBuffer::~StagingBuffer() {
+  if (slot_ == NoSlot) {
+    return;
+  }
+  StagingPool &pool = threadPool;
+  if (buffer_->capacity() > MaxRetainedCapacity) {
+    pool.buffers[slot_] = fmt::memory_buffer{};
+  }
+  pool.leased[slot_] = false;
+}
+
+} // namespace sample::logger
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "MpscRing.hpp"
+
+#include <logger/LoggerStats.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace sample::logger {
+
+/// Add `amount` to a counter only the calling thread modifies (private).
+///
+/// A relaxed load and store rather than a locked read-modify-write: readers
+/// on other threads see a recent, never-torn value.
+inline void bump(std::atomic<std::uint64_t> &counter, std::uint64_t amount) {
+  counter.store(counter.load(std::memory_order_relaxed) + amount,
+                std::memory_order_relaxed);
+}
+
+/// The statistics of one writer thread: an async logger's consumer or one
+/// of its backends (private).
+///
+/// Only the owning thread updates the counters, with `bump()`; `stats()`
+/// sums the cells of every writer. Aligned so that no two writers' cells
+/// share a cache line.
+struct alignas(CacheLineSize) WriterStats {
+  /// Count a batch of `batchRecords` records and `batchBytes` bytes written
+  /// by one output operation.
+  void countFlush(std::uint64_t batchRecords, std::uint64_t batchBytes) {
+    bump(records, batchRecords);
+    bump(bytes, batchBytes);
+    bump(flushes, 1);
+  }
+
+  /// Note that `depth` records were seen waiting in a queue.
+  void noteQueueDepth(std::uint64_t depth) {
+    if (depth > queueHighWater.load(std::memory_order_relaxed)) {
+      queueHighWater.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  /// Count one record delivered `elapsed` after it was enqueued.
+  void countLatency(std::chrono::nanoseconds elapsed) {
+    const auto nanos = static_cast<std::uint64_t>(
+        std::max(elapsed, std::chrono::nanoseconds::zero()).count());
+    bump(latency[LatencyHistogram::bucketOf(nanos)], 1);
+  }
+
+  /// Note that the writer thread has used `total` CPU time so far.
+  void noteCpuTime(std::chrono::nanoseconds total) {
+    cpuNanos.store(static_cast<std::uint64_t>(total.count()),
+                   std::memory_order_relaxed);
+  }
+
+  /// Count one sleep waiting for records.
+  void countSleep() { bump(sleeps, 1); }
+
+  /// Add this writer's counts to `stats`.
+  void addTo(LoggerStats &stats) const {
+    stats.records += records.load(std::memory_order_relaxed);
+    stats.bytes += bytes.load(std::memory_order_relaxed);
+    stats.flushes += flushes.load(std::memory_order_relaxed);
+    stats.queueHighWater =
+        std::max(stats.queueHighWater,
+                 queueHighWater.load(std::memory_order_relaxed));
+    stats.backendCpuTime += std::chrono::nanoseconds{
+        static_cast<std::int64_t>(cpuNanos.load(std::memory_order_relaxed))};
+    stats.backendSleeps += sleeps.load(std::memory_order_relaxed);
+    for (std::size_t bucket = 0; bucket < latency.size(); ++bucket) {
+      const std::uint64_t count =
+          latency[bucket].load(std::memory_order_relaxed);
+      if (count != 0) {
+        stats.latency.addToBucket(bucket, count);
+      }
+    }
+  }
+
+  std::atomic<std::uint64_t> records{0};
+  std::atomic<std::uint64_t> bytes{0};
+  std::atomic<std::uint64_t> flushes{0};
+  std::atomic<std::uint64_t> queueHighWater{0};
+  std::atomic<std::uint64_t> cpuNanos{0};
+  std::atomic<std::uint64_t> sleeps{0};
+  std::array<std::atomic<std::uint64_t>, LatencyHistogram::BucketCount>
+      latency{};
+};
+
+/// Index of the calling thread's stripe of every `StripedCounters`; assigned
+/// round-robin on first use (private).
+[[nodiscard]] auto threadStripe() -> std::size_t;
+
+/// Record and byte counts of a logger that writes on its callers' threads
+/// (private).
+///
+/// The counts are spread over cache-line-sized stripes picked per thread,
+/// so threads only share a stripe once there are more of them than
+/// `Stripes`.
+class StripedCounters {
+public:
+  static constexpr std::size_t Stripes = 16;
+
+  /// Count one record of `recordBytes` bytes.
+  void countRecord(std::uint64_t recordBytes) {
+    Stripe &stripe = stripes_[threadStripe() % Stripes];
+    stripe.records.fetch_add(1, std::memory_order_relaxed);
+    stripe.bytes.fetch_add(recordBytes, std::memory_order_relaxed);
+  }
+
+  /// Add the counts of every stripe to `stats`.
+  void addTo(LoggerStats &stats) const {
+    for (const Stripe &stripe : stripes_) {
+      stats.records += stripe.records.load(std::memory_order_relaxed);
+      stats.bytes += stripe.bytes.load(std::memory_order_relaxed);
+    }
+  }
+
+private:
+  struct alignas(CacheLineSize) Stripe {
+    std::atomic<std::uint64_t> records{0};
+    std::atomic<std::uint64_t> bytes{0};
+  };
+
+  std::array<Stripe, Stripes> stripes_{};
+};
+
+} // namespace sample::logger
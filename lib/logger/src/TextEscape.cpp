@@ -0,0 +1,278 @@
+#include <logger/Fields.hpp>
+
+#include <fmt/format.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+namespace sample::logger {
+
+namespace {
+
+/// Which bytes a text scan stops at.
+enum class TextScan {
+  /// Bytes a JSON string literal must escape (`"`, `\` and control
+  /// characters), and every non-ASCII byte.
+  Json,
+  /// As `Json`, plus the space and `=`, which force a logfmt value to be
+  /// quoted.
+  Logfmt,
+};
+
+/// Length of the longest prefix of `data` that a `TextScan` does not stop
+/// at.
+using ScanKernel = std::size_t (*)(const char *data, std::size_t size);
+
+/// Smallest byte a `Scan` does not stop at.
+template <TextScan Scan> constexpr unsigned char LowestPlain =
+    Scan == TextScan::Json ? 0x20 : 0x21;
+
+/// Whether a `Scan` does not stop at `character`.
+template <TextScan Scan> [[nodiscard]] constexpr auto isPlain(char character)
+    -> bool {
+  const auto byte = static_cast<unsigned char>(character);
+  return byte >= LowestPlain<Scan> && byte < 0x80 && character != '"' &&
+         character != '\\' && (Scan == TextScan::Json || character != '=');
+}
+
+/// Byte-at-a-time kernel, also finishing the tail of the vector kernels.
+template <TextScan Scan>
+auto scanScalar(const char *data, std::size_t size, std::size_t from)
+    -> std::size_t {
+  for (std::size_t index = from; index < size; ++index) {
+    if (!isPlain<Scan>(data[index])) {
+      return index;
+    }
+  }
+  return size;
+}
+
+/// Kernel for CPUs with no vector kernel.
+template <TextScan Scan>
+auto scanBytes(const char *data, std::size_t size) -> std::size_t {
+  return scanScalar<Scan>(data, size, 0);
+}
+
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+/// 16 bytes as a GCC/Clang generic vector: the same code compiles to SSE2 on
+/// x86-64 and to NEON on arm64.
+using ByteVector = std::int8_t __attribute__((vector_size(16)));
+
+// The signed compare against `LowestPlain` also catches every byte >= 0x80,
+// which is negative as a signed char; so one compare and an equality test
+// per special character classify 16 bytes. With no portable movemask, the
+// first match is the lowest set byte of the two 64-bit halves.
+template <TextScan Scan>
+auto scanVector(const char *data, std::size_t size) -> std::size_t {
+  std::size_t index = 0;
+  for (; index + sizeof(ByteVector) <= size; index += sizeof(ByteVector)) {
+    ByteVector bytes;
+    std::memcpy(&bytes, data + index, sizeof(bytes));
+    ByteVector special =
+        (bytes < static_cast<std::int8_t>(LowestPlain<Scan>)) | (bytes == '"') |
+        (bytes == '\\');
+    if constexpr (Scan == TextScan::Logfmt) {
+      special |= bytes == '=';
+    }
+    const auto halves = std::bit_cast<std::array<std::uint64_t, 2>>(special);
+    if ((halves[0] | halves[1]) != 0) {
+      const std::size_t half = halves[0] != 0 ? 0 : 1;
+      return index + half * sizeof(std::uint64_t) +
+             static_cast<std::size_t>(std::countr_zero(halves[half])) / 8;
+    }
+  }
+  return scanScalar<Scan>(data, size, index);
+}
+
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+
+/// As `scanVector()`, 32 bytes at a time, locating the match by `movemask`.
+template <TextScan Scan>
+__attribute__((target("avx2"))) auto scanAvx2(const char *data,
+                                              std::size_t size)
+    -> std::size_t {
+  const __m256i lowest = _mm256_set1_epi8(LowestPlain<Scan>);
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i equals = _mm256_set1_epi8('=');
+  std::size_t index = 0;
+  for (; index + sizeof(__m256i) <= size; index += sizeof(__m256i)) {
+    const __m256i bytes = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(data + index));
+    __m256i special = _mm256_or_si256(
+        _mm256_cmpgt_epi8(lowest, bytes),
+        _mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote),
+                        _mm256_cmpeq_epi8(bytes, backslash)));
+    if constexpr (Scan == TextScan::Logfmt) {
+      special = _mm256_or_si256(special, _mm256_cmpeq_epi8(bytes, equals));
+    }
+    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(special));
+    if (mask != 0) {
+      return index + static_cast<std::size_t>(std::countr_zero(mask));
+    }
+  }
+  return scanScalar<Scan>(data, size, index);
+}
+
+#endif
+
+/// The kernels for each `TextScan`.
+struct ScanKernels {
+  ScanKernel json;
+  ScanKernel logfmt;
+};
+
+/// The fastest kernels the running CPU supports: AVX2 if the x86 CPU has
+/// it, else the generic vector kernel (SSE2 on x86-64, NEON on arm64); a
+/// byte loop where the compiler has no vector extensions.
+auto selectKernels() -> ScanKernels {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  if (__builtin_cpu_supports("avx2")) {
+    return {&scanAvx2<TextScan::Json>, &scanAvx2<TextScan::Logfmt>};
+  }
+#endif
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return {&scanVector<TextScan::Json>, &scanVector<TextScan::Logfmt>};
+#else
+  return {&scanBytes<TextScan::Json>, &scanBytes<TextScan::Logfmt>};
+#endif
+}
+
+/// The kernels picked on first use.
+auto kernels() -> const ScanKernels & {
+  static const ScanKernels selected = selectKernels();
+  return selected;
+}
+
+/// Length of the well-formed UTF-8 sequence at the start of `text`, or 0 if
+/// it does not start with one.
+///
+/// Rejects overlong forms, surrogates and code points above U+10FFFF.
+auto utf8SequenceLength(std::string_view text) -> std::size_t {
+  const auto byteAt = [text](std::size_t index) {
+    return static_cast<unsigned char>(text[index]);
+  };
+  const unsigned lead = byteAt(0);
+  std::size_t length = 0;
+  unsigned low = 0x80;
+  unsigned high = 0xBF;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    length = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+    low = lead == 0xE0 ? 0xA0 : low;
+    high = lead == 0xED ? 0x9F : high;
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    length = 4;
+    low = lead == 0xF0 ? 0x90 : low;
+    high = lead == 0xF4 ? 0x8F : high;
+  } else {
+    return 0;
+  }
+  if (text.size() < length || byteAt(1) < low || byteAt(1) > high) {
+    return 0;
+  }
+  for (std::size_t index = 2; index < length; ++index) {
+    if ((byteAt(index) & 0xC0U) != 0x80) {
+      return 0;
+    }
+  }
+  return length;
+}
+
+/// Append the character at the start of `text`, which a `TextScan::Json`
+/// stopped at, to a JSON string literal in `out`.
+///
+/// A byte that does not start a well-formed UTF-8 sequence is replaced by
+/// U+FFFD, so the output is valid UTF-8 whatever the input.
+///
+/// ## Returns
+/// Number of bytes of `text` consumed.
+auto appendJsonSpecial(std::string_view text, fmt::memory_buffer &out)
+    -> std::size_t {
+  const char character = text.front();
+  switch (character) {
+  case '"':
+    out.append(std::string_view{"\\\""});
+    return 1;
+  case '\\':
+    out.append(std::string_view{"\\\\"});
+    return 1;
+  case '\n':
+    out.append(std::string_view{"\\n"});
+    return 1;
+  case '\r':
+    out.append(std::string_view{"\\r"});
+    return 1;
+  case '\t':
+    out.append(std::string_view{"\\t"});
+    return 1;
+  default:
+    break;
+  }
+  if (static_cast<unsigned char>(character) < 0x20) {
+    fmt::format_to(std::back_inserter(out), "\\u{:04x}",
+                   static_cast<unsigned>(character));
+    return 1;
+  }
+  const std::size_t length = utf8SequenceLength(text);
+  if (length == 0) {
+    out.append(std::string_view{"\\ufffd"});
+    return 1;
+  }
+  out.append(text.substr(0, length));
+  return length;
+}
+
+} // anonymous namespace
+
+namespace detail {
+
+void appendJsonString(std::string_view text, fmt::memory_buffer &out) {
+  out.reserve(out.size() + text.size() + 2);
+  out.push_back('"');
+  const ScanKernel scan = kernels().json;
+  while (!text.empty()) {
+    const std::size_t plain = scan(text.data(), text.size());
+    out.append(text.substr(0, plain));
+    text.remove_prefix(plain);
+    if (!text.empty()) {
+      text.remove_prefix(appendJsonSpecial(text, out));
+    }
+  }
+  out.push_back('"');
+}
+
+void appendLogfmtString(std::string_view text, fmt::memory_buffer &out) {
+  const ScanKernel scan = kernels().logfmt;
+  bool bare = !text.empty();
+  for (std::size_t offset = 0; bare && offset < text.size();) {
+    offset += scan(text.data() + offset, text.size() - offset);
+    if (offset < text.size()) {
+      const std::size_t length = utf8SequenceLength(text.substr(offset));
+      bare = static_cast<unsigned char>(text[offset]) >= 0x80 && length != 0;
+      offset += length;
+    }
+  }
+  if (bare) {
+    out.append(text);
+  } else {
+    appendJsonString(text, out);
+  }
+}
+
+} // namespace detail
+
+} // namespace sample::logger
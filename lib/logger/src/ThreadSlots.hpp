@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sample::logger {
+
+/// A fresh identity for a logger with per-thread state in `ThreadSlots`;
+/// never reused, so a thread's cached slot can not be mistaken for one of a
+/// later logger at the same address (private).
+inline auto nextThreadSlotsOwner() -> std::uint64_t {
+  static std::atomic<std::uint64_t> next{1};
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// The calling thread's slots, one per logger it logged to (private).
+///
+/// Meant to be `thread_local`. Holds a reference to each slot so the memory
+/// stays valid whichever of the thread and the logger goes first; on thread
+/// exit every slot's `abandoned` flag is set so its logger can hand it to
+/// the next thread that registers.
+template <typename Slot> class ThreadSlots {
+public:
+  ThreadSlots() = default;
+
+  ~ThreadSlots() {
+    for (const Entry &entry : entries_) {
+      entry.slot->abandoned.store(true, std::memory_order_release);
+    }
+  }
+
+  ThreadSlots(const ThreadSlots &) = delete;
+  auto operator=(const ThreadSlots &) -> ThreadSlots & = delete;
+  ThreadSlots(ThreadSlots &&) = delete;
+  auto operator=(ThreadSlots &&) -> ThreadSlots & = delete;
+
+  /// The slot registered for logger `owner`, or null.
+  [[nodiscard]] auto find(std::uint64_t owner) -> Slot * {
+    if (owner == lastOwner_) {
+      return last_;
+    }
+    for (const Entry &entry : entries_) {
+      if (entry.owner == owner) {
+        remember(entry);
+        return last_;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Record `slot` as this thread's slot for logger `owner`.
+  void add(std::uint64_t owner, std::shared_ptr<Slot> slot) {
+    // Forget slots whose logger has been destroyed.
+    std::erase_if(entries_, [](const Entry &entry) {
+      return entry.slot.use_count() == 1;
+    });
+    entries_.push_back({owner, std::move(slot)});
+    remember(entries_.back());
+  }
+
+private:
+  struct Entry {
+    std::uint64_t owner;
+    std::shared_ptr<Slot> slot;
+  };
+
+  void remember(const Entry &entry) {
+    lastOwner_ = entry.owner;
+    last_ = entry.slot.get();
+  }
+
+  std::vector<Entry> entries_;
+  std::uint64_t lastOwner_ = 0;
+  Slot *last_ = nullptr;
+};
+
+} // namespace sample::logger
@@ -0,0 +1,463 @@
+#include "UringSink.hpp"
+
+#include <logger/UringLoggerConfig.hpp>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace sample::logger {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Permissions for a newly created log file, before the umask.
+constexpr ::mode_t LogFileMode = 0644;
+
+/// Upper bound on the batch capacity reserved up front without a ring.
+constexpr std::size_t MaxInitialReserve = 64 * 1024;
+
+/// Upper bound on the part of each registered buffer sized by
+/// `maxBatchBytes`, as registered memory counts against `RLIMIT_MEMLOCK`.
+constexpr std::size_t MaxRegisteredBatch = 256 * 1024;
+
+/// Room past `maxBatchBytes` in a registered buffer for the record that
+/// fills the batch; a batch that outgrows its buffer is written unregistered.
+constexpr std::size_t BatchSlack = 16 * 1024;
+
+/// Most bytes requested by one write; the rest follows as for a short write.
+constexpr std::size_t MaxWriteBytes = std::size_t{1} << 30;
+
+/// `user_data` of a sync request; writes carry their slot index.
+constexpr std::uint64_t SyncTag = ~std::uint64_t{0};
+
+/// Pause before submitting again to a ring that took nothing.
+constexpr std::chrono::microseconds BusyBackoff{100};
+
+/// Outcome of submitting to a ring.
+enum class EnterResult : std::uint8_t {
+  /// Submitted, and waited as asked.
+  Entered,
+  /// Nothing taken for now: the kernel is short of memory or has
+  /// completions to reap first.
+  Busy,
+  /// The ring failed.
+  Failed
+};
+
+auto ioUringSetup(unsigned entries, ::io_uring_params &params) -> int {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+auto ioUringEnter(int fd, unsigned submit, unsigned wait) -> int {
+  const unsigned flags = wait != 0 ? IORING_ENTER_GETEVENTS : 0U;
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_enter, fd, submit, wait, flags, nullptr, 0));
+}
+
+auto ioUringRegister(int fd, unsigned opcode, const void *arg,
+                     unsigned count) -> int {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+/// Map `size` bytes of the ring `fd` at `offset`, or return null.
+auto mapRing(int fd, std::size_t size, std::uint64_t offset) -> std::byte * {
+  void *address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd,
+                         static_cast<::off_t>(offset));
+  return address == MAP_FAILED ? nullptr : static_cast<std::byte *>(address);
+}
+
+} // anonymous namespace
+
+/// An `io_uring` instance driven with raw system calls.
+///
+/// The submission and completion queues are shared with the kernel; their
+/// indices are exchanged with acquire/release accesses. Only one thread
+/// uses a ring, and submitted requests are consumed by `enter()`, so the
+/// submission queue never fills up while the caller keeps no more than
+/// `entries` requests in flight.
+class UringSink::Ring {
+  /// Restricts construction to `create()`, while letting it use
+  /// `std::make_unique`.
+  struct PrivateTag {
+    explicit PrivateTag() = default;
+  };
+
+public:
+  /// Set up a ring for `entries` requests in flight.
+  ///
+  /// ## Returns
+  /// The ring, or null if the kernel lacks or refuses `io_uring`.
+  static auto create(unsigned entries) -> std::unique_ptr<Ring> {
+    ::io_uring_params params{};
+    const int fd = ioUringSetup(entries, params);
+    if (fd < 0) {
+      return nullptr;
+    }
+    auto ring = std::make_unique<Ring>(PrivateTag{}, fd);
+    if (!ring->map(params)) {
+      return nullptr;
+    }
+    return ring;
+  }
+
+  Ring(PrivateTag /*tag*/, int fd) : fd_{fd} {}
+
+  ~Ring() {
+    if (sqes_ != nullptr) {
+      ::munmap(sqes_, sqesBytes_);
+    }
+    if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+      ::munmap(cqRing_, cqBytes_);
+    }
+    if (sqRing_ != nullptr) {
+      ::munmap(sqRing_, sqBytes_);
+    }
+    ::close(fd_);
+  }
+
+  Ring(const Ring &) = delete;
+  auto operator=(const Ring &) -> Ring & = delete;
+  Ring(Ring &&) = delete;
+  auto operator=(Ring &&) -> Ring & = delete;
+
+  /// Register `buffers` for fixed-buffer writes, indexed in order.
+  ///
+  /// ## Returns
+  /// Whether the kernel accepted them (it may not, e.g. over
+  /// `RLIMIT_MEMLOCK`).
+  auto registerBuffers(std::span<const ::iovec> buffers) -> bool {
+    return ioUringRegister(fd_, IORING_REGISTER_BUFFERS, buffers.data(),
+                           static_cast<unsigned>(buffers.size())) == 0;
+  }
+
+  /// A cleared submission queue entry, queued for the next `enter()`.
+  auto prepare() -> ::io_uring_sqe & {
+    const unsigned index = sqLocalTail_++ & sqMask_;
+    sqArray_[index] = index;
+    sqes_[index] = {};
+    return sqes_[index];
+  }
+
+  /// Submit the queued entries and wait for `wait` completions.
+  ///
+  /// ## Returns
+  /// `EnterResult::Failed` if the ring failed: callers should stop using
+  /// it. Entries not taken stay queued for the next call.
+  auto enter(unsigned wait) -> EnterResult {
+    std::atomic_ref{*sqTail_}.store(sqLocalTail_, std::memory_order_release);
+    for (;;) {
+      const int result = ioUringEnter(fd_, pending(), wait);
+      if (result >= 0) {
+        return EnterResult::Entered;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno == EAGAIN || errno == EBUSY ? EnterResult::Busy
+                                               : EnterResult::Failed;
+    }
+  }
+
+  /// Pass the result and `user_data` of every ready completion to `handle`.
+  template <typename Handle> void reap(const Handle &handle) {
+    unsigned head = *cqHead_;
+    const unsigned tail =
+        std::atomic_ref{*cqTail_}.load(std::memory_order_acquire);
+    while (head != tail) {
+      const ::io_uring_cqe &completion = cqes_[head & cqMask_];
+      handle(completion.user_data, completion.res);
+      ++head;
+    }
+    std::atomic_ref{*cqHead_}.store(head, std::memory_order_release);
+  }
+
+private:
+  /// Map the queues of a ring set up with `params`.
+  auto map(const ::io_uring_params &params) -> bool {
+    sqBytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqBytes_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+    const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+      sqBytes_ = cqBytes_ = std::max(sqBytes_, cqBytes_);
+    }
+    sqRing_ = mapRing(fd_, sqBytes_, IORING_OFF_SQ_RING);
+    if (sqRing_ == nullptr) {
+      return false;
+    }
+    cqRing_ = single ? sqRing_ : mapRing(fd_, cqBytes_, IORING_OFF_CQ_RING);
+    sqesBytes_ = params.sq_entries * sizeof(::io_uring_sqe);
+    // Kept as soon as mapped, for the destructor to unmap on failure.
+    sqes_ = reinterpret_cast<::io_uring_sqe *>(
+        mapRing(fd_, sqesBytes_, IORING_OFF_SQES));
+    if (cqRing_ == nullptr || sqes_ == nullptr) {
+      return false;
+    }
+    sqHead_ = at<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = at<unsigned>(sqRing_, params.sq_off.tail);
+    sqMask_ = *at<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqArray_ = at<unsigned>(sqRing_, params.sq_off.array);
+    sqLocalTail_ = *sqTail_;
+    cqHead_ = at<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = at<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = *at<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqes_ = at<::io_uring_cqe>(cqRing_, params.cq_off.cqes);
+    return true;
+  }
+
+  template <typename T>
+  static auto at(std::byte *base, std::uint32_t offset) -> T * {
+    return reinterpret_cast<T *>(base + offset);
+  }
+
+  /// Entries queued but not yet consumed by the kernel.
+  [[nodiscard]] auto pending() const -> unsigned {
+    return sqLocalTail_ -
+           std::atomic_ref{*sqHead_}.load(std::memory_order_acquire);
+  }
+
+  int fd_;
+  std::byte *sqRing_ = nullptr;
+  std::size_t sqBytes_ = 0;
+  std::byte *cqRing_ = nullptr;
+  std::size_t cqBytes_ = 0;
+  ::io_uring_sqe *sqes_ = nullptr;
+  std::size_t sqesBytes_ = 0;
+  unsigned *sqHead_ = nullptr;
+  unsigned *sqTail_ = nullptr;
+  unsigned *sqArray_ = nullptr;
+  unsigned sqMask_ = 0;
+  unsigned sqLocalTail_ = 0;
+  unsigned *cqHead_ = nullptr;
+  unsigned *cqTail_ = nullptr;
+  unsigned cqMask_ = 0;
+  ::io_uring_cqe *cqes_ = nullptr;
+};
+
+UringSink::UringSink(const UringLoggerConfig &config)
+    : fd_{::open(config.filePath.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC,
+                 LogFileMode)},
+      maxBatchBytes_{config.queue.maxBatchBytes},
+      syncInterval_{config.syncInterval}, useUring_{config.useUring},
+      slots_(config.queueDepth) {
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "cannot open log file '" +
+                                config.filePath.string() + "'");
+  }
+  const ::off_t end = ::lseek(fd_, 0, SEEK_END);
+  offset_ = end < 0 ? 0 : static_cast<std::uint64_t>(end);
+}
+
+UringSink::~UringSink() {
+  while (ring_ &&
+         (syncsInFlight_ != 0 ||
+          std::ranges::any_of(slots_, &Slot::inFlight))) {
+    awaitCompletion();
+  }
+  ring_.reset();
+  if (started_) {
+    ::fdatasync(fd_);
+  }
+  ::close(fd_);
+}
+
+void UringSink::start() {
+  if (started_) {
+    return;
+  }
+  lastSync_ = Clock::now();
+  if (useUring_ && !ring_) {
+    ring_ = Ring::create(static_cast<unsigned>(2 * slots_.size()));
+  }
+  if (!ring_) {
+    slots_.front().text.reserve(std::min(maxBatchBytes_, MaxInitialReserve));
+    started_ = true;
+    return;
+  }
+  std::vector<::iovec> buffers;
+  buffers.reserve(slots_.size());
+  for (Slot &slot : slots_) {
+    slot.text.reserve(std::min(maxBatchBytes_, MaxRegisteredBatch) +
+                      BatchSlack);
+    buffers.push_back({slot.text.data(), slot.text.capacity()});
+  }
+  if (ring_->registerBuffers(buffers)) {
+    for (Slot &slot : slots_) {
+      slot.registered = slot.text.data();
+    }
+  }
+  started_ = true;
+}
+
+void UringSink::flush() {
+  Slot &slot = slots_[current_];
+  if (slot.text.size() == 0) {
+    return;
+  }
+  slot.offset = offset_;
+  slot.written = 0;
+  offset_ += slot.text.size();
+  if (!ring_) {
+    writeRest(slot);
+    slot.text.clear();
+    const Clock::time_point now = Clock::now();
+    if (now - lastSync_ >= syncInterval_) {
+      ::fdatasync(fd_);
+      lastSync_ = now;
+    }
+    return;
+  }
+  slot.inFlight = true;
+  submitWrite(current_);
+  submitSyncIfDue();
+  if (!enterRing(0)) {
+    return;
+  }
+  reapCompletions();
+  current_ = (current_ + 1) % slots_.size();
+  while (ring_ && slots_[current_].inFlight) {
+    awaitCompletion();
+  }
+  slots_[current_].text.clear();
+}
+
+void UringSink::write(std::string_view text) {
+  flush();
+  buffer().append(text.data(), text.data() + text.size());
+  flush();
+}
+
+void UringSink::sync() {
+  while (ring_ && std::ranges::any_of(slots_, &Slot::inFlight)) {
+    awaitCompletion();
+  }
+}
+
+void UringSink::submitWrite(std::size_t index) {
+  const Slot &slot = slots_[index];
+  const bool fixed = slot.registered == slot.text.data();
+  ::io_uring_sqe &entry = ring_->prepare();
+  entry.opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  entry.fd = fd_;
+  entry.off = slot.offset + slot.written;
+  entry.addr = reinterpret_cast<std::uintptr_t>(slot.text.data() +
+                                                slot.written);
+  entry.len = static_cast<std::uint32_t>(
+      std::min(slot.text.size() - slot.written, MaxWriteBytes));
+  entry.buf_index = fixed ? static_cast<std::uint16_t>(index) : 0;
+  entry.user_data = index;
+}
+
+void UringSink::submitSyncIfDue() {
+  const Clock::time_point now = Clock::now();
+  if (now - lastSync_ < syncInterval_ || syncsInFlight_ == slots_.size()) {
+    return;
+  }
+  ::io_uring_sqe &entry = ring_->prepare();
+  entry.opcode = IORING_OP_FSYNC;
+  // Drain: the sync starts once every write queued before it is done.
+  entry.flags = IOSQE_IO_DRAIN;
+  entry.fd = fd_;
+  entry.fsync_flags = IORING_FSYNC_DATASYNC;
+  entry.user_data = SyncTag;
+  ++syncsInFlight_;
+  lastSync_ = now;
+}
+
+void UringSink::awaitCompletion() {
+  if (enterRing(1)) {
+    reapCompletions();
+  }
+}
+
+auto UringSink::enterRing(unsigned wait) -> bool {
+  switch (ring_->enter(wait)) {
+  case EnterResult::Entered:
+    return true;
+  case EnterResult::Busy:
+    // Make room for completions, and give the kernel time to recover
+    // rather than polling it; the caller submits again.
+    reapCompletions();
+    std::this_thread::sleep_for(BusyBackoff);
+    return true;
+  case EnterResult::Failed:
+    break;
+  }
+  abandonRing();
+  return false;
+}
+
+void UringSink::reapCompletions() {
+  ring_->reap([this](std::uint64_t tag, int result) {
+    if (tag == SyncTag) {
+      --syncsInFlight_;
+      return;
+    }
+    Slot &slot = slots_[tag];
+    if (result > 0) {
+      slot.written += static_cast<std::size_t>(result);
+    }
+    if (slot.written < slot.text.size()) {
+      if (result > 0 || result == -EINTR || result == -EAGAIN) {
+        submitWrite(tag);
+        return;
+      }
+      writeRest(slot);
+    }
+    slot.inFlight = false;
+  });
+}
+
+void UringSink::abandonRing() {
+  // Every batch has its own offset, so rewriting one the kernel may have
+  // written already is harmless.
+  for (Slot &slot : slots_) {
+    if (slot.inFlight) {
+      writeRest(slot);
+      slot.inFlight = false;
+    }
+  }
+  syncsInFlight_ = 0;
+  ring_.reset();
+  slots_[current_].text.clear();
+}
+
+void UringSink::writeRest(Slot &slot) const {
+  while (slot.written < slot.text.size()) {
+    const ::ssize_t written =
+        ::pwrite(fd_, slot.text.data() + slot.written,
+                 slot.text.size() - slot.written,
+                 static_cast<::off_t>(slot.offset + slot.written));
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return;
+    }
+    slot.written += static_cast<std::size_t>(written);
+  }
+}
+
+} // namespace sample::logger
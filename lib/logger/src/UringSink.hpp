@@ -0,0 +1,146 @@
+#pragma once
+
+#include <logger/LogLevel.hpp>
+#include <logger/UringLoggerConfig.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace sample::logger {
+
+/// Most batches a `UringSink` may have in flight (private).
+constexpr std::size_t MaxUringQueueDepth = 4096;
+
+/// Batching writer that submits each batch to `io_uring` (private).
+///
+/// Offers the interface `AsyncLogger` expects of `FdSink`. The consumer
+/// thread formats into one of `queueDepth` buffers registered with the
+/// kernel; `flush()` queues a fixed-buffer write of it at the next file
+/// offset and moves on to the next buffer, waiting only when every buffer is
+/// still in flight. As every batch has an offset of its own, completions may
+/// arrive in any order. A `fdatasync` is queued, drained behind the writes
+/// before it, at most once per `syncInterval`.
+///
+/// If the kernel refuses `io_uring`, or `useUring` is off, the sink writes
+/// with `pwrite(2)` and syncs with `fdatasync(2)` itself, like `FdSink`.
+/// Not thread-safe: every call comes from the consumer thread (or the
+/// logger's destructor, after it has stopped).
+class UringSink {
+public:
+  /// Open `config.filePath` for writing at its end.
+  ///
+  /// ## Throws
+  /// `std::system_error` if the file cannot be opened.
+  explicit UringSink(const UringLoggerConfig &config);
+
+  /// Wait for every batch in flight, sync the file and close it. The
+  /// unflushed batch is discarded.
+  ~UringSink();
+
+  UringSink(const UringSink &) = delete;
+  auto operator=(const UringSink &) -> UringSink & = delete;
+  UringSink(UringSink &&) = delete;
+  auto operator=(UringSink &&) -> UringSink & = delete;
+
+  /// Set up the ring and reserve and register the buffers, before the first
+  /// record. Falls back to plain writes if the ring cannot be set up.
+  /// Idempotent.
+  void start();
+
+  /// The pending batch; append records here.
+  [[nodiscard]] auto buffer() -> fmt::memory_buffer & {
+    return slots_[current_].text;
+  }
+
+  /// Whether nothing is pending.
+  [[nodiscard]] auto empty() const -> bool {
+    return slots_[current_].text.size() == 0;
+  }
+
+  /// Whether the pending batch has reached the configured size.
+  [[nodiscard]] auto full() const -> bool {
+    return slots_[current_].text.size() >= maxBatchBytes_;
+  }
+
+  /// Note the end of a record of `level` in the batch; every record is
+  /// written, so there is nothing to track.
+  void endRecord(Level /*level*/) {}
+
+  /// Queue the pending batch for writing and start the next one.
+  ///
+  /// Errors other than a short write fall back to `pwrite(2)`; if that fails
+  /// too the batch is dropped, and reads back as zeros.
+  void flush();
+
+  /// Flush `text` as a batch of its own, after the pending one.
+  void write(std::string_view text);
+
+  /// Whether `flush()` has written the batch by the time it returns: only
+  /// without `io_uring`.
+  [[nodiscard]] auto synchronous() const -> bool { return !ring_; }
+
+  /// Wait until every flushed batch has been written.
+  void sync();
+
+private:
+  class Ring;
+
+  /// One batch buffer and the write it is in.
+  struct Slot {
+    fmt::memory_buffer text;
+    /// Start of the buffer as registered, or null if it is not.
+    const char *registered = nullptr;
+    /// File offset of the batch and bytes of it written so far.
+    std::uint64_t offset = 0;
+    std::size_t written = 0;
+    bool inFlight = false;
+  };
+
+  /// Queue a write of whatever of `slots_[index]` is not written yet.
+  void submitWrite(std::size_t index);
+
+  /// Queue a `fdatasync` if `syncInterval` has passed since the last one.
+  void submitSyncIfDue();
+
+  /// Submit queued requests, wait for at least one completion and handle
+  /// every completion ready.
+  void awaitCompletion();
+
+  /// Submit queued requests and wait for `wait` completions, backing off
+  /// after handling the ready ones if the ring is busy.
+  ///
+  /// ## Returns
+  /// False if the ring failed and was abandoned.
+  auto enterRing(unsigned wait) -> bool;
+
+  /// Handle every completion ready: finish the slot, or resubmit the rest
+  /// of a short write.
+  void reapCompletions();
+
+  /// Give up on a failed ring: write what is in flight with `pwrite(2)`
+  /// and carry on without the ring.
+  void abandonRing();
+
+  /// `pwrite(2)` the unwritten rest of `slot`, retrying short writes.
+  void writeRest(Slot &slot) const;
+
+  int fd_;
+  std::size_t maxBatchBytes_;
+  std::chrono::steady_clock::duration syncInterval_;
+  bool useUring_;
+  bool started_ = false;
+  std::uint64_t offset_ = 0;
+  std::vector<Slot> slots_;
+  std::size_t current_ = 0;
+  std::unique_ptr<Ring> ring_;
+  std::size_t syncsInFlight_ = 0;
+  std::chrono::steady_clock::time_point lastSync_{};
+};
+
+} // namespace sample::logger
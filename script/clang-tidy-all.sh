@@ -3,8 +3,8 @@
 # Enable strict mode (exit on error, exit on unset variable, error on pipeline)
 set -euo pipefail
 
-# Run clang-tidy on all .h and .cpp files in the app, lib, and test directories with specified build path and header filter
-for dir in app lib test; do
+# Run clang-tidy on all .h and .cpp files in the app, bench, lib, and test directories with specified build path and header filter
+for dir in app bench lib test; do
     if [ -d "${dir}" ]; then
         find "${dir}" \( -iname "*.h" -o -iname "*.cpp" -o -iname "*.hpp" \) -print0 | xargs -0 /usr/bin/clang-tidy -p build/debug -header-filter='.*'
     fi
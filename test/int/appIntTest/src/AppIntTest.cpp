@@ -4,7 +4,9 @@
 /// multiple components working together as they would in production.
 
 #include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
 #include <logger/LoggerFactory.hpp>
+#include <logger/LoggerRegistry.hpp>
 
 #include <gtest/gtest.h>
 
@@ -76,10 +78,10 @@ TEST_F(AppLoggingIntSuite, ErrorConditionLogging) {
   ASSERT_TRUE(hasLogger()) << "Logger must be available for errors";
 
   EXPECT_NO_THROW({
-    logger().log("ERROR: Failed to open configuration file");
-    logger().log("WARNING: Using default configuration");
-    logger().log("INFO: Retrying operation...");
-    logger().log("INFO: Operation succeeded on retry");
+    logger().log(logger::Level::Error, "Failed to open configuration file");
+    logger().log(logger::Level::Warning, "Using default configuration");
+    logger().log(logger::Level::Info, "Retrying operation...");
+    logger().log(logger::Level::Info, "Operation succeeded on retry");
   }) << "Error logging should work correctly";
 }
 
@@ -147,6 +149,30 @@ TEST_F(AppLifecycleSuite, MultiComponentLoggingScenario) {
   }) << "Multiple components should log independently";
 }
 
+// Test case: Scenario - Components log through named loggers of one
+// registry, and one of them is switched to debug logging at runtime
+TEST_F(AppLifecycleSuite, NamedComponentLoggingScenario) {
+  logger::LoggerRegistry loggers{logger::createDefaultLogger()};
+  loggers.setLevels("info");
+  logger::ILogger &database = loggers.get("service.database");
+  logger::ILogger &cache = loggers.get("service.cache");
+
+  ::testing::internal::CaptureStdout();
+  database.log(logger::Level::Debug, "Database: query plan");
+  loggers.setLevel("service.database", logger::Level::Debug);
+  database.log(logger::Level::Debug, "Database: slow query");
+  cache.log(logger::Level::Debug, "Cache: lookup");
+  cache.log("Cache: warmed");
+  const std::string output = ::testing::internal::GetCapturedStdout();
+
+  if constexpr (logger::isCompiledIn(logger::Level::Debug)) {
+    EXPECT_EQ(output, "Database: slow query\nCache: warmed\n")
+        << "Only the database logger should have switched to debug";
+  } else {
+    EXPECT_EQ(output, "Cache: warmed\n") << "Debug is compiled out";
+  }
+}
+
 // Value-parameterised test: Various application scenarios
 class AppScenarioTest
     : public ::testing::TestWithParam<std::vector<std::string>> {
@@ -0,0 +1,497 @@
+/// Integration tests for logging from many threads at once.
+///
+/// This test suite runs from one to twice as many producer threads as there
+/// are CPUs against every logger the factory creates, and a registry of
+/// named loggers, with bursts, records longer than a ring slot, and loggers
+/// destroyed while records are still queued. Each output must hold every
+/// record, none interleaved with another, and each thread's in the order it
+/// logged them. A scaling test records the throughput at each thread count.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerRegistry.hpp>
+#include <logger/MappedFileLoggerConfig.hpp>
+#include <logger/UringLoggerConfig.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <latch>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace sample::inttest {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// The loggers under test.
+enum class Kind {
+  Console,
+  Async,
+  PerThreadAsync,
+  SpinningPerThreadAsync,
+  FanOut,
+  UringFile,
+  MappedFile,
+  Registry,
+};
+
+constexpr std::array AllKinds{Kind::Console,
+                              Kind::Async,
+                              Kind::PerThreadAsync,
+                              Kind::SpinningPerThreadAsync,
+                              Kind::FanOut,
+                              Kind::UringFile,
+                              Kind::MappedFile,
+                              Kind::Registry};
+
+[[nodiscard]] auto toString(Kind kind) -> std::string_view {
+  switch (kind) {
+  case Kind::Console:
+    return "Console";
+  case Kind::Async:
+    return "Async";
+  case Kind::PerThreadAsync:
+    return "PerThreadAsync";
+  case Kind::SpinningPerThreadAsync:
+    return "SpinningPerThreadAsync";
+  case Kind::FanOut:
+    return "FanOut";
+  case Kind::UringFile:
+    return "UringFile";
+  case Kind::MappedFile:
+    return "MappedFile";
+  case Kind::Registry:
+    return "Registry";
+  }
+  return "Unknown";
+}
+
+/// Whether the tests run under the thread sanitiser, which slows every
+/// atomic operation down by an order of magnitude.
+#if defined(__SANITIZE_THREAD__)
+constexpr bool UnderThreadSanitizer = true;
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+constexpr bool UnderThreadSanitizer = true;
+#else
+constexpr bool UnderThreadSanitizer = false;
+#endif
+#else
+constexpr bool UnderThreadSanitizer = false;
+#endif
+
+/// Records each producer thread logs in the correctness tests.
+constexpr unsigned RecordsPerThread = UnderThreadSanitizer ? 300 : 3000;
+
+/// Records logged in each run of the scaling test, split between threads.
+constexpr unsigned ScalingRecords = UnderThreadSanitizer ? 4000 : 200'000;
+
+/// Records a producer logs back to back before it pauses.
+constexpr unsigned BurstLength = 64;
+
+/// Producer thread counts: one, as many as there are CPUs, and twice that.
+[[nodiscard]] auto threadCounts() -> std::vector<unsigned> {
+  const unsigned cpus = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts{1, cpus, 2 * cpus};
+  const auto [first, last] = std::ranges::unique(counts);
+  counts.erase(first, last);
+  return counts;
+}
+
+/// Producer thread counts for the scaling curve: powers of two up to twice
+/// the number of CPUs, and that.
+[[nodiscard]] auto scalingThreadCounts() -> std::vector<unsigned> {
+  const unsigned most = 2 * std::max(1U, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned count = 1; count < most; count *= 2) {
+    counts.push_back(count);
+  }
+  counts.push_back(most);
+  return counts;
+}
+
+/// The text record `sequence` of thread `thread` carries after its header.
+///
+/// A run of one letter, so that bytes of another record inside it show.
+/// Most are short; every sixteenth is longer than a ring slot holds, so it
+/// goes through the producer's record arena.
+[[nodiscard]] auto payload(unsigned thread, unsigned sequence) -> std::string {
+  const std::size_t length = sequence % 16 == 0
+                                 ? 1024 + (sequence * 37) % 4096
+                                 : 8 + sequence % 32;
+  return std::string(length,
+                     static_cast<char>('a' + (thread * 7 + sequence) % 26));
+}
+
+/// Log record `sequence` of thread `thread`, alternately formatted by the
+/// caller and deferred to the backend.
+void logRecord(logger::ILogger &logger, unsigned thread, unsigned sequence) {
+  const std::string text = payload(thread, sequence);
+  if (sequence % 2 == 0) {
+    logger.log(fmt::format("t{} s{} {}", thread, sequence, text));
+  } else {
+    logger.logf<"t{} s{} {}">(thread, sequence, text);
+  }
+}
+
+/// Check that `output` holds exactly records 0 to `records[i]` - 1 of each
+/// thread `i`, each intact and every thread's in order.
+auto holdsEveryRecord(std::string_view output,
+                      const std::vector<unsigned> &records)
+    -> ::testing::AssertionResult {
+  const auto threads = static_cast<unsigned>(records.size());
+  std::vector<unsigned> next(threads, 0);
+  std::size_t lineNumber = 0;
+  while (!output.empty()) {
+    ++lineNumber;
+    const std::size_t end = output.find('\n');
+    if (end == std::string_view::npos) {
+      return ::testing::AssertionFailure()
+             << "Line " << lineNumber << " is not terminated";
+    }
+    const std::string_view line = output.substr(0, end);
+    output.remove_prefix(end + 1);
+    unsigned thread = 0;
+    unsigned sequence = 0;
+    const char *cursor = line.data();
+    const char *const last = line.data() + line.size();
+    const auto number = [&cursor, last](char tag, unsigned &value) {
+      if (cursor == last || *cursor++ != tag) {
+        return false;
+      }
+      const auto [rest, error] = std::from_chars(cursor, last, value);
+      cursor = rest;
+      return error == std::errc{} && cursor != last && *cursor++ == ' ';
+    };
+    if (!number('t', thread) || !number('s', sequence) || thread >= threads) {
+      return ::testing::AssertionFailure()
+             << "Line " << lineNumber << " has no valid header: "
+             << line.substr(0, 64);
+    }
+    if (std::string_view{cursor, last} != payload(thread, sequence)) {
+      return ::testing::AssertionFailure()
+             << "Record " << sequence << " of thread " << thread
+             << " is torn (line " << lineNumber << ")";
+    }
+    if (sequence != next[thread]) {
+      return ::testing::AssertionFailure()
+             << "Thread " << thread << " record " << sequence
+             << " follows record " << next[thread] - 1 << " (expected "
+             << next[thread] << ", line " << lineNumber << ")";
+    }
+    ++next[thread];
+  }
+  for (unsigned thread = 0; thread < threads; ++thread) {
+    if (next[thread] != records[thread]) {
+      return ::testing::AssertionFailure()
+             << "Thread " << thread << " has " << next[thread] << " of "
+             << records[thread] << " records";
+    }
+  }
+  return ::testing::AssertionSuccess();
+}
+
+/// Check that `output` holds records 0 to `records` - 1 of each of `threads`
+/// threads; see above.
+auto holdsEveryRecord(std::string_view output, unsigned threads,
+                      unsigned records) -> ::testing::AssertionResult {
+  return holdsEveryRecord(output, std::vector<unsigned>(threads, records));
+}
+
+/// One logger under test and the outputs it writes.
+///
+/// File-backed loggers write below a directory of the test's own; the
+/// console logger's standard output is captured while it lives.
+class LoggerUnderTest {
+public:
+  /// Create a logger of `kind`; `lingering` holds partial batches for an
+  /// hour, so that only a flush or destruction writes them.
+  LoggerUnderTest(Kind kind, bool lingering) : kind_{kind} {
+    const std::filesystem::path &directory = directory_.path();
+
+    const logger::AsyncLoggerConfig queue{
+        .target = logger::LogTarget::File,
+        .filePath = directory / "out.log",
+        .maxLatency = lingering ? std::chrono::microseconds{1h}
+                                : std::chrono::microseconds{0}};
+    logger::AsyncLoggerConfig perThread = queue;
+    perThread.capacity = 1024;
+    perThread.queueMode = logger::QueueMode::PerThread;
+    perThread.backendThreads = 2;
+    switch (kind) {
+    case Kind::Console:
+      ::testing::internal::CaptureStdout();
+      capturing_ = true;
+      logger_ = logger::createDefaultLogger();
+      break;
+    case Kind::Async:
+      logger_ = logger::createAsyncLogger(queue);
+      break;
+    case Kind::PerThreadAsync:
+      logger_ = logger::createAsyncLogger(perThread);
+      break;
+    case Kind::SpinningPerThreadAsync:
+      perThread.waitStrategy = logger::WaitStrategy::SpinYield;
+      logger_ = logger::createAsyncLogger(perThread);
+      break;
+    case Kind::FanOut:
+      logger_ = logger::createFanOutLogger(
+          {.queue = {.capacity = 256,
+                     .maxLatency = queue.maxLatency},
+           .targets = {{.target = logger::LogTarget::File,
+                        .filePath = directory / "out.log"},
+                       {.target = logger::LogTarget::File,
+                        .filePath = directory / "second.log",
+                        .ownThread = true}},
+           .maxPendingBatches = 4});
+      break;
+    case Kind::UringFile:
+      logger_ = logger::createUringFileLogger(
+          {.queue = queue, .filePath = directory / "out.log"});
+      break;
+    case Kind::MappedFile:
+      logger_ = logger::createMappedFileLogger(
+          {.directory = directory, .segmentSize = 256 * 1024});
+      break;
+    case Kind::Registry:
+      registry_ = std::make_unique<logger::LoggerRegistry>(
+          std::shared_ptr<logger::ILogger>{logger::createAsyncLogger(queue)});
+      registry_->setLevels("info,stress=debug");
+      break;
+    }
+  }
+
+  ~LoggerUnderTest() {
+    if (capturing_) {
+      static_cast<void>(::testing::internal::GetCapturedStdout());
+    }
+  }
+
+  LoggerUnderTest(const LoggerUnderTest &) = delete;
+  auto operator=(const LoggerUnderTest &) -> LoggerUnderTest & = delete;
+  LoggerUnderTest(LoggerUnderTest &&) = delete;
+  auto operator=(LoggerUnderTest &&) -> LoggerUnderTest & = delete;
+
+  /// The logger producer thread `thread` logs to: its own named logger for
+  /// `Kind::Registry`, otherwise the one logger.
+  [[nodiscard]] auto forThread(unsigned thread) -> logger::ILogger & {
+    if (registry_) {
+      return registry_->get(fmt::format("stress.worker{}", thread));
+    }
+    return *logger_;
+  }
+
+  /// Destroy the logger; the text of each of its outputs.
+  [[nodiscard]] auto finish() -> std::vector<std::string> {
+    logger_.reset();
+    registry_.reset();
+    if (capturing_) {
+      capturing_ = false;
+      return {::testing::internal::GetCapturedStdout()};
+    }
+    if (kind_ == Kind::MappedFile) {
+      std::vector<std::filesystem::path> segments;
+      for (const auto &entry :
+           std::filesystem::directory_iterator{directory_.path()}) {
+        segments.push_back(entry.path());
+      }
+      std::ranges::sort(segments);
+      std::string text;
+      for (const auto &segment : segments) {
+        text += testsupport::readFile(segment);
+      }
+      return {text};
+    }
+    if (kind_ == Kind::FanOut) {
+      return {testsupport::readFile(directory_.path() / "out.log"),
+              testsupport::readFile(directory_.path() / "second.log")};
+    }
+    return {testsupport::readFile(directory_.path() / "out.log")};
+  }
+
+private:
+  Kind kind_;
+  const testsupport::TempLogDirectory directory_;
+  bool capturing_ = false;
+  std::unique_ptr<logger::ILogger> logger_;
+  std::unique_ptr<logger::LoggerRegistry> registry_;
+};
+
+/// Run `threads` producers at once, each logging `records` records to its
+/// logger in bursts; producer `i` is given `i` and the logger.
+template <typename Producer>
+void runProducers(LoggerUnderTest &output, unsigned threads,
+                  const Producer &producer) {
+  std::latch start{static_cast<std::ptrdiff_t>(threads)};
+  std::vector<std::thread> producers;
+  producers.reserve(threads);
+  for (unsigned thread = 0; thread < threads; ++thread) {
+    producers.emplace_back([&output, &start, &producer, thread] {
+      logger::ILogger &logger = output.forThread(thread);
+      start.arrive_and_wait();
+      producer(thread, logger);
+    });
+  }
+  for (std::thread &thread : producers) {
+    thread.join();
+  }
+}
+
+/// Log records 0 to `records` - 1 of `thread`, pausing after each burst.
+void logBursts(logger::ILogger &logger, unsigned thread, unsigned records) {
+  for (unsigned sequence = 0; sequence < records; ++sequence) {
+    logRecord(logger, thread, sequence);
+    if (sequence % BurstLength == BurstLength - 1) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+} // namespace
+
+/// Test suite for each logger at each producer thread count.
+class StressIntTest
+    : public ::testing::TestWithParam<std::tuple<Kind, unsigned>> {
+protected:
+  /// Get the logger under test.
+  [[nodiscard]] static auto kind() -> Kind { return std::get<0>(GetParam()); }
+
+  /// Get the number of producer threads.
+  [[nodiscard]] static auto threads() -> unsigned {
+    return std::get<1>(GetParam());
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    LoggersAndThreads, StressIntTest,
+    ::testing::Combine(::testing::ValuesIn(AllKinds),
+                       ::testing::ValuesIn(threadCounts())),
+    [](const ::testing::TestParamInfo<StressIntTest::ParamType> &info) {
+      return fmt::format("{}_{}threads", toString(std::get<0>(info.param)),
+                         std::get<1>(info.param));
+    });
+
+// Test case: Scenario - Bursts of short and long records from every thread
+// all arrive intact and in each thread's order
+TEST_P(StressIntTest, NoRecordLostTornOrReordered) {
+  LoggerUnderTest output{kind(), false};
+  runProducers(output, threads(),
+               [](unsigned thread, logger::ILogger &logger) {
+                 logBursts(logger, thread, RecordsPerThread);
+               });
+  for (const std::string &text : output.finish()) {
+    EXPECT_TRUE(holdsEveryRecord(text, threads(), RecordsPerThread));
+  }
+}
+
+// Test case: Scenario - A thread flushes and reads statistics while the
+// others log, and half of them exit early
+TEST_P(StressIntTest, FlushesAndThreadExitsWhileLogging) {
+  LoggerUnderTest output{kind(), true};
+  const unsigned observer = threads();
+  // Odd producers leave early, abandoning their queues with records still
+  // in them; the observer logs nothing.
+  std::vector<unsigned> records(threads() + 1, 0);
+  for (unsigned thread = 0; thread < observer; ++thread) {
+    records[thread] =
+        thread % 2 == 0 ? RecordsPerThread : RecordsPerThread / 4;
+  }
+  std::atomic<unsigned> running{threads()};
+  runProducers(output, threads() + 1,
+               [&running, &records, observer](unsigned thread,
+                                              logger::ILogger &logger) {
+                 if (thread == observer) {
+                   while (running.load() != 0) {
+                     logger.flush();
+                     static_cast<void>(logger.stats());
+                     std::this_thread::sleep_for(100us);
+                   }
+                   return;
+                 }
+                 logBursts(logger, thread, records[thread]);
+                 if (thread % 2 == 0) {
+                   logger.flush();
+                 }
+                 running.fetch_sub(1);
+               });
+  for (const std::string &text : output.finish()) {
+    EXPECT_TRUE(holdsEveryRecord(text, records));
+  }
+}
+
+// Test case: Scenario - A logger destroyed straight after a burst, with
+// partial batches held back and queues full, writes every record first
+TEST_P(StressIntTest, ShutdownWritesRecordsStillQueued) {
+  LoggerUnderTest output{kind(), true};
+  runProducers(output, threads(),
+               [](unsigned thread, logger::ILogger &logger) {
+                 for (unsigned sequence = 0; sequence < RecordsPerThread;
+                      ++sequence) {
+                   logRecord(logger, thread, sequence);
+                 }
+               });
+  for (const std::string &text : output.finish()) {
+    EXPECT_TRUE(holdsEveryRecord(text, threads(), RecordsPerThread));
+  }
+}
+
+/// Test suite for the throughput of each logger as producers are added.
+class StressScalingTest : public ::testing::TestWithParam<Kind> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    Loggers, StressScalingTest, ::testing::ValuesIn(AllKinds),
+    [](const ::testing::TestParamInfo<Kind> &info) {
+      return std::string{toString(info.param)};
+    });
+
+// Test case: Scenario - Throughput from one to twice as many producers as
+// CPUs, recorded as test properties (`throughput_<threads>`, in records per
+// second) for the XML report
+TEST_P(StressScalingTest, RecordsThroughputCurve) {
+  std::vector<std::pair<unsigned, double>> curve;
+  for (const unsigned threads : scalingThreadCounts()) {
+    const unsigned records = ScalingRecords / threads;
+    LoggerUnderTest output{GetParam(), false};
+    const auto start = std::chrono::steady_clock::now();
+    runProducers(output, threads,
+                 [records](unsigned thread, logger::ILogger &logger) {
+                   logBursts(logger, thread, records);
+                 });
+    const std::vector<std::string> texts = output.finish();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    for (const std::string &text : texts) {
+      ASSERT_TRUE(holdsEveryRecord(text, threads, records));
+    }
+    curve.emplace_back(threads,
+                       static_cast<double>(records * threads) /
+                           elapsed.count());
+  }
+  for (const auto &[threads, rate] : curve) {
+    RecordProperty(fmt::format("throughput_{}", threads),
+                   fmt::format("{:.0f}", rate));
+  }
+}
+
+} // namespace sample::inttest
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace sample::testsupport {
+
+/// Read the whole of `path`, or return an empty string if it cannot be read.
+inline auto readFile(const std::filesystem::path &path) -> std::string {
+  std::ifstream file{path, std::ios::binary};
+  return {std::istreambuf_iterator<char>{file},
+          std::istreambuf_iterator<char>{}};
+}
+
+/// Read the whole of `path` as raw bytes, or return none if it cannot be
+/// read.
+inline auto readBytes(const std::filesystem::path &path)
+    -> std::vector<std::byte> {
+  const std::string raw = readFile(path);
+  const auto *data = reinterpret_cast<const std::byte *>(raw.data());
+  return {data, data + raw.size()};
+}
+
+/// A path in `::testing::TempDir()` named after the running test, that does
+/// not exist when created and is removed, with anything made beneath it,
+/// when this goes out of scope.
+class TempPath {
+public:
+  ~TempPath() {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+  }
+
+  TempPath(const TempPath &) = delete;
+  auto operator=(const TempPath &) -> TempPath & = delete;
+  TempPath(TempPath &&) = delete;
+  auto operator=(TempPath &&) -> TempPath & = delete;
+
+  /// The path.
+  [[nodiscard]] auto path() const -> const std::filesystem::path & {
+    return path_;
+  }
+
+protected:
+  /// `<suite>_<test><suffix>`, without the slashes of parameterised names.
+  explicit TempPath(std::string_view suffix) : path_{pathFor(suffix)} {
+    std::filesystem::remove_all(path_);
+  }
+
+private:
+  static auto pathFor(std::string_view suffix) -> std::filesystem::path {
+    const auto *info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = std::string{info->test_suite_name()} + "_" +
+                       info->name() + std::string{suffix};
+    std::erase(name, '/');
+    return std::filesystem::path{::testing::TempDir()} / name;
+  }
+
+  std::filesystem::path path_;
+};
+
+/// A log file for the running test, named after the test and `suffix`.
+///
+/// ```cpp
+/// const testsupport::TempLogFile file;
+/// config.filePath = file.path();
+/// ```
+class TempLogFile : public TempPath {
+public:
+  explicit TempLogFile(std::string_view suffix = "")
+      : TempPath{std::string{suffix} + ".log"} {}
+};
+
+/// An empty directory for the running test's log files, named after the
+/// test and `suffix`.
+///
+/// ```cpp
+/// const testsupport::TempLogDirectory directory;
+/// config.directory = directory.path();
+/// ```
+class TempLogDirectory : public TempPath {
+public:
+  explicit TempLogDirectory(std::string_view suffix = "")
+      : TempPath{suffix} {
+    std::filesystem::create_directories(path());
+  }
+};
+
+} // namespace sample::testsupport
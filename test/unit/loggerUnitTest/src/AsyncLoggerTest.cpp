@@ -0,0 +1,649 @@
+/// Unit tests for the asynchronous logger.
+///
+/// This test suite validates `createAsyncLogger()` and the delivery
+/// guarantees of the logger it returns.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/Fields.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sched.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// Test suite for the asynchronous logger.
+///
+/// Captures stdout so queued output can be checked once the logger has been
+/// destroyed (which drains the queue).
+class AsyncLoggerTest : public ::testing::Test {
+protected:
+  /// Start capturing stdout.
+  void SetUp() override { ::testing::internal::CaptureStdout(); }
+
+  /// Stop capturing if a test did not collect the output itself.
+  void TearDown() override {
+    if (!collected_) {
+      static_cast<void>(::testing::internal::GetCapturedStdout());
+    }
+  }
+
+  /// Stop capturing and return the captured lines.
+  [[nodiscard]] auto capturedLines() -> std::vector<std::string> {
+    collected_ = true;
+    std::istringstream stream{::testing::internal::GetCapturedStdout()};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(stream, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+private:
+  bool collected_ = false;
+};
+
+/// Number of threads in this process.
+auto threadCount() -> std::ptrdiff_t {
+  return std::distance(std::filesystem::directory_iterator{"/proc/self/task"},
+                       std::filesystem::directory_iterator{});
+}
+
+/// The lowest-numbered CPU this process may run on.
+auto firstAllowedCpu() -> unsigned {
+  ::cpu_set_t set;
+  CPU_ZERO(&set);
+  static_cast<void>(::sched_getaffinity(0, sizeof(set), &set));
+  unsigned cpu = 0;
+  while (cpu + 1 < CPU_SETSIZE && !CPU_ISSET(cpu, &set)) {
+    ++cpu;
+  }
+  return cpu;
+}
+
+/// Number of threads in this process allowed to run only on `cpu`.
+auto threadsPinnedTo(unsigned cpu) -> int {
+  const std::string expected = "Cpus_allowed_list:\t" + std::to_string(cpu);
+  int count = 0;
+  for (const auto &task :
+       std::filesystem::directory_iterator{"/proc/self/task"}) {
+    std::ifstream status{task.path() / "status"};
+    for (std::string line; std::getline(status, line);) {
+      if (line == expected) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+} // namespace
+
+// Test case: Factory creates a non-null logger instance
+TEST_F(AsyncLoggerTest, CreateAsyncLoggerReturnsNonNull) {
+  auto logger = createAsyncLogger();
+  ASSERT_NE(logger, nullptr) << "Factory should return a valid logger instance";
+}
+
+// Test case: Factory rejects a ring that cannot hold a record
+TEST_F(AsyncLoggerTest, CreateAsyncLoggerRejectsTinyCapacity) {
+  EXPECT_THROW(static_cast<void>(createAsyncLogger({.capacity = 1})),
+               std::invalid_argument)
+      << "Capacity below 2 should be rejected";
+}
+
+// Test case: Destruction writes every queued message in order
+TEST_F(AsyncLoggerTest, DestructionDrainsMessagesInOrder) {
+  {
+    auto logger = createAsyncLogger();
+    logger->log("first");
+    logger->log("");
+    logger->log("third");
+  }
+
+  const std::vector<std::string> expected{"first", "", "third"};
+  EXPECT_EQ(capturedLines(), expected)
+      << "All messages should be written, in order, by destruction";
+}
+
+// Test case: A full ring blocks producers instead of losing messages
+TEST_F(AsyncLoggerTest, SmallRingDeliversEveryMessage) {
+  constexpr int MessageCount = 1000;
+  {
+    auto logger = createAsyncLogger({.capacity = 2});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->log(std::to_string(i));
+    }
+  }
+
+  const auto lines = capturedLines();
+  ASSERT_EQ(lines.size(), static_cast<std::size_t>(MessageCount));
+  for (int i = 0; i < MessageCount; ++i) {
+    EXPECT_EQ(lines[static_cast<std::size_t>(i)], std::to_string(i));
+  }
+}
+
+// Test case: Concurrent producers lose no messages and keep their own order
+TEST_F(AsyncLoggerTest, ConcurrentProducersPreservePerThreadOrder) {
+  constexpr int ThreadCount = 4;
+  constexpr int MessagesPerThread = 500;
+  {
+    auto logger = createAsyncLogger({.capacity = 64});
+    std::vector<std::thread> producers;
+    for (int t = 0; t < ThreadCount; ++t) {
+      producers.emplace_back([&logger, t] {
+        for (int i = 0; i < MessagesPerThread; ++i) {
+          logger->log(std::to_string(t) + ":" + std::to_string(i));
+        }
+      });
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+  }
+
+  std::vector<int> next(ThreadCount, 0);
+  for (const auto &line : capturedLines()) {
+    const auto colon = line.find(':');
+    ASSERT_NE(colon, std::string::npos) << "Torn line: " << line;
+    const auto thread =
+        static_cast<std::size_t>(std::stoi(line.substr(0, colon)));
+    ASSERT_LT(thread, next.size());
+    EXPECT_EQ(std::stoi(line.substr(colon + 1)), next[thread]++)
+        << "Messages from one thread must stay in order";
+  }
+  for (const int count : next) {
+    EXPECT_EQ(count, MessagesPerThread) << "No message may be lost";
+  }
+}
+
+// Test case: The blocking policy never reports drops
+TEST_F(AsyncLoggerTest, BlockPolicyDropsNothing) {
+  auto logger = createAsyncLogger(
+      {.capacity = 2, .overflowPolicy = OverflowPolicy::Block});
+  for (int i = 0; i < 100; ++i) {
+    logger->log("message");
+  }
+  EXPECT_EQ(logger->droppedMessages(), 0U);
+}
+
+// Test case: Factory rejects a zero sampling interval
+TEST_F(AsyncLoggerTest, CreateAsyncLoggerRejectsZeroSampleRate) {
+  EXPECT_THROW(static_cast<void>(createAsyncLogger(
+                   {.overflowPolicy = OverflowPolicy::Sample,
+                    .sampleRate = 0})),
+               std::invalid_argument)
+      << "Sample rate of 0 should be rejected";
+}
+
+// Test case: Factory rejects an empty batch size
+TEST_F(AsyncLoggerTest, CreateAsyncLoggerRejectsZeroBatchBytes) {
+  EXPECT_THROW(static_cast<void>(createAsyncLogger({.maxBatchBytes = 0})),
+               std::invalid_argument)
+      << "A batch must be allowed to hold at least one byte";
+}
+
+// Test case: The stderr target writes to standard error, not stdout
+TEST_F(AsyncLoggerTest, StderrTargetWritesToStderr) {
+  ::testing::internal::CaptureStderr();
+  {
+    auto logger = createAsyncLogger({.target = LogTarget::Stderr});
+    logger->log("to stderr");
+  }
+  EXPECT_EQ(::testing::internal::GetCapturedStderr(), "to stderr\n");
+  EXPECT_TRUE(capturedLines().empty());
+}
+
+// Test case: The file target appends to the file across loggers
+TEST_F(AsyncLoggerTest, FileTargetAppendsToFile) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  const AsyncLoggerConfig config{.target = LogTarget::File, .filePath = path};
+  {
+    auto logger = createAsyncLogger(config);
+    logger->log("first");
+    logger->log("second");
+  }
+  {
+    auto logger = createAsyncLogger(config);
+    logger->log("third");
+  }
+  EXPECT_EQ(testsupport::readFile(path), "first\nsecond\nthird\n");
+}
+
+// Test case: A log file that cannot be opened is reported
+TEST_F(AsyncLoggerTest, UnopenableFileThrowsSystemError) {
+  const testsupport::TempLogFile file;
+  const auto path = file.path() / "missing-directory" / "log.txt";
+  EXPECT_THROW(static_cast<void>(createAsyncLogger(
+                   {.target = LogTarget::File, .filePath = path})),
+               std::system_error);
+}
+
+// Test case: A tiny batch size still delivers every message in order
+TEST_F(AsyncLoggerTest, SmallBatchDeliversEveryMessage) {
+  constexpr int MessageCount = 1000;
+  {
+    auto logger = createAsyncLogger({.maxBatchBytes = 1});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->log(std::to_string(i));
+    }
+  }
+
+  const auto lines = capturedLines();
+  ASSERT_EQ(lines.size(), static_cast<std::size_t>(MessageCount));
+  for (int i = 0; i < MessageCount; ++i) {
+    EXPECT_EQ(lines[static_cast<std::size_t>(i)], std::to_string(i));
+  }
+}
+
+// Test case: A lingering batch is written once its latency bound expires
+TEST_F(AsyncLoggerTest, MaxLatencyWritesPartialBatch) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto logger = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = path,
+                                   .maxLatency = std::chrono::milliseconds{5}});
+  logger->log("lingered");
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds{10};
+  while (testsupport::readFile(path).empty() &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(testsupport::readFile(path), "lingered\n")
+      << "The batch should be written without waiting for destruction";
+  logger.reset();
+}
+
+// Test case: Factory rejects zero backend threads
+TEST_F(AsyncLoggerTest, CreateAsyncLoggerRejectsZeroBackends) {
+  EXPECT_THROW(static_cast<void>(createAsyncLogger(
+                   {.queueMode = QueueMode::PerThread, .backendThreads = 0})),
+               std::invalid_argument);
+}
+
+// Test case: The shared ring has exactly one consumer
+TEST_F(AsyncLoggerTest, SharedQueueRejectsSeveralBackends) {
+  EXPECT_THROW(static_cast<void>(createAsyncLogger({.backendThreads = 2})),
+               std::invalid_argument);
+}
+
+// Test case: Factory rejects placements it cannot honour
+TEST_F(AsyncLoggerTest, CreateAsyncLoggerRejectsInvalidPlacement) {
+  EXPECT_THROW(
+      static_cast<void>(createAsyncLogger({.backendCpus = {1U << 20}})),
+      std::invalid_argument)
+      << "No such CPU";
+  EXPECT_THROW(
+      static_cast<void>(createAsyncLogger({.backendPerNode = true})),
+      std::invalid_argument)
+      << "A shared ring has a single backend";
+  EXPECT_THROW(
+      static_cast<void>(createAsyncLogger({.nodeLocalQueues = true})),
+      std::invalid_argument)
+      << "A shared ring has no producer node";
+  EXPECT_THROW(static_cast<void>(createAsyncLogger(
+                   {.queueMode = QueueMode::PerThread,
+                    .backendCpus = {firstAllowedCpu()},
+                    .backendPerNode = true})),
+               std::invalid_argument)
+      << "Conflicting placements";
+}
+
+// Test case: Pinned and node-local backends deliver every message and run
+// on the CPUs they were given
+TEST_F(AsyncLoggerTest, PlacedBackendsDeliverEveryMessage) {
+  constexpr int ThreadCount = 4;
+  constexpr int MessagesPerThread = 500;
+  const unsigned cpu = firstAllowedCpu();
+  const std::vector<AsyncLoggerConfig> configs{
+      {.backendCpus = {cpu}},
+      {.queueMode = QueueMode::PerThread,
+       .backendThreads = 2,
+       .backendCpus = {cpu}},
+      {.queueMode = QueueMode::PerThread,
+       .backendPerNode = true,
+       .nodeLocalQueues = true}};
+  for (const AsyncLoggerConfig &config : configs) {
+    auto logger = createAsyncLogger(config);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < ThreadCount; ++t) {
+      producers.emplace_back([&logger, t] {
+        for (int i = 0; i < MessagesPerThread; ++i) {
+          logger->logf<"{}:{}">(t, i);
+        }
+      });
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    if (!config.backendCpus.empty()) {
+      EXPECT_GE(threadsPinnedTo(cpu), 1) << "A backend runs on its CPU";
+    }
+  }
+
+  EXPECT_EQ(capturedLines().size(),
+            std::size_t{ThreadCount * MessagesPerThread * 3});
+}
+
+// Test case: Per-thread queues drained by several backends lose nothing and
+// keep each thread's order
+TEST_F(AsyncLoggerTest, PerThreadQueuesPreservePerThreadOrder) {
+  constexpr int ThreadCount = 8;
+  constexpr int MessagesPerThread = 1000;
+  {
+    auto logger = createAsyncLogger({.capacity = 16,
+                                     .maxBatchBytes = 256,
+                                     .queueMode = QueueMode::PerThread,
+                                     .backendThreads = 3});
+    std::vector<std::thread> producers;
+    for (int t = 0; t < ThreadCount; ++t) {
+      producers.emplace_back([&logger, t] {
+        for (int i = 0; i < MessagesPerThread; ++i) {
+          logger->logf<"{}:{}">(t, i);
+        }
+      });
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+    EXPECT_EQ(logger->droppedMessages(), 0U);
+  }
+
+  std::vector<int> next(ThreadCount, 0);
+  for (const auto &line : capturedLines()) {
+    const auto colon = line.find(':');
+    ASSERT_NE(colon, std::string::npos) << "Torn line: " << line;
+    const auto thread =
+        static_cast<std::size_t>(std::stoi(line.substr(0, colon)));
+    ASSERT_LT(thread, next.size());
+    EXPECT_EQ(std::stoi(line.substr(colon + 1)), next[thread]++)
+        << "Messages from one thread must stay in order";
+  }
+  for (const int count : next) {
+    EXPECT_EQ(count, MessagesPerThread) << "No message may be lost";
+  }
+}
+
+// Test case: Queues of exited threads are reused without losing messages
+TEST_F(AsyncLoggerTest, PerThreadQueuesSurviveThreadTurnover) {
+  constexpr int Generations = 50;
+  constexpr int MessagesPerThread = 20;
+  {
+    auto logger = createAsyncLogger(
+        {.capacity = 4, .queueMode = QueueMode::PerThread});
+    for (int g = 0; g < Generations; ++g) {
+      std::thread{[&logger] {
+        for (int i = 0; i < MessagesPerThread; ++i) {
+          logger->log("message");
+        }
+      }}.join();
+    }
+  }
+  EXPECT_EQ(capturedLines().size(),
+            static_cast<std::size_t>(Generations * MessagesPerThread));
+}
+
+// Test case: Per-thread queues account for every message under a lossy policy
+TEST_F(AsyncLoggerTest, PerThreadLossyPolicyAccountsForEveryMessage) {
+  constexpr int MessageCount = 20000;
+  std::uint64_t dropped = 0;
+  {
+    auto logger =
+        createAsyncLogger({.capacity = 4,
+                           .overflowPolicy = OverflowPolicy::DropOldest,
+                           .queueMode = QueueMode::PerThread,
+                           .backendThreads = 2});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->log(std::to_string(i));
+    }
+    dropped = logger->droppedMessages();
+  }
+
+  const auto lines = capturedLines();
+  EXPECT_EQ(lines.size() + dropped, static_cast<std::uint64_t>(MessageCount));
+  int previous = -1;
+  for (const auto &line : lines) {
+    const int value = std::stoi(line);
+    EXPECT_GT(value, previous) << "Surviving messages must stay in order";
+    previous = value;
+  }
+}
+
+// Test case: Oversize records come through intact as their arena wraps, is
+// evicted from and overflows to the heap
+TEST_F(AsyncLoggerTest, ArenaRecordsSurviveReuseAndEviction) {
+  constexpr int MessageCount = 2000;
+  const auto message = [](int i) {
+    return std::to_string(i) + ' ' +
+           std::string(300 + static_cast<std::size_t>(i * 37 % 3000),
+                       static_cast<char>('a' + i % 26));
+  };
+  std::uint64_t logged = 0;
+  std::uint64_t dropped = 0;
+  LoggerStats stats;
+  for (const QueueMode mode : {QueueMode::Shared, QueueMode::PerThread}) {
+    auto logger =
+        createAsyncLogger({.capacity = 64,
+                           .overflowPolicy = OverflowPolicy::DropOldest,
+                           .queueMode = mode,
+                           .arenaBytes = 16 * 1024});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->log(message(i));
+    }
+    logger->log(std::string(100000, 'z'));
+    logger->flush();
+    logged += MessageCount + 1;
+    dropped += logger->droppedMessages();
+    const LoggerStats modeStats = logger->stats();
+    stats.arenaRecords += modeStats.arenaRecords;
+    stats.arenaFallbacks += modeStats.arenaFallbacks;
+  }
+
+  const auto lines = capturedLines();
+  EXPECT_EQ(lines.size() + dropped, logged);
+  EXPECT_EQ(stats.arenaRecords + stats.arenaFallbacks, logged)
+      << "Every record is oversize";
+  EXPECT_GE(stats.arenaFallbacks, 2U) << "The last record fits no arena";
+  EXPECT_GT(stats.arenaRecords, 0U);
+  for (const std::string &line : lines) {
+    if (line.starts_with('z')) {
+      EXPECT_EQ(line, std::string(100000, 'z'));
+    } else {
+      EXPECT_EQ(line, message(std::stoi(line)));
+    }
+  }
+}
+
+// Test case: Timestamps are UTC wall-clock times of the log call
+TEST_F(AsyncLoggerTest, TimestampsPrefixEveryLine) {
+  const auto before = std::chrono::system_clock::now();
+  for (const QueueMode mode : {QueueMode::Shared, QueueMode::PerThread}) {
+    auto logger = createAsyncLogger({.timestamps = true, .queueMode = mode});
+    logger->log("first");
+    logger->logf<"second {}">(2);
+  }
+  const auto after = std::chrono::system_clock::now();
+
+  const std::regex pattern{
+      R"(^(\d{4})-(\d{2})-(\d{2})T(\d{2}):(\d{2}):(\d{2})\.(\d{9})Z (.*)$)"};
+  const std::vector<std::string> messages{"first", "second 2", "first",
+                                          "second 2"};
+  const auto lines = capturedLines();
+  ASSERT_EQ(lines.size(), messages.size());
+  for (std::size_t i = 0; i < lines.size(); ++i) {
+    std::smatch match;
+    ASSERT_TRUE(std::regex_match(lines[i], match, pattern)) << lines[i];
+    EXPECT_EQ(match[8], messages[i]);
+    using namespace std::chrono;
+    const year_month_day date{year{std::stoi(match[1])},
+                              month{static_cast<unsigned>(std::stoi(match[2]))},
+                              day{static_cast<unsigned>(std::stoi(match[3]))}};
+    const auto stamp = sys_days{date} + hours{std::stoi(match[4])} +
+                       minutes{std::stoi(match[5])} +
+                       seconds{std::stoi(match[6])} +
+                       nanoseconds{std::stoll(match[7])};
+    // Calibration error is far below this tolerance.
+    EXPECT_GE(stamp, before - milliseconds{50}) << lines[i];
+    EXPECT_LE(stamp, after + milliseconds{50}) << lines[i];
+  }
+}
+
+// Value-parameterised test: Lossy policies account for every message
+class AsyncLoggerOverflowPolicyTest
+    : public AsyncLoggerTest,
+      public ::testing::WithParamInterface<OverflowPolicy> {};
+
+TEST_P(AsyncLoggerOverflowPolicyTest, WrittenPlusDroppedEqualsLogged) {
+  constexpr int MessageCount = 20000;
+  std::uint64_t dropped = 0;
+  {
+    auto logger = createAsyncLogger(
+        {.capacity = 4, .overflowPolicy = GetParam(), .sampleRate = 4});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->log(std::to_string(i));
+    }
+    // Drops are only counted by producers, so the count is final here.
+    dropped = logger->droppedMessages();
+  }
+
+  const auto lines = capturedLines();
+  EXPECT_EQ(lines.size() + dropped, static_cast<std::uint64_t>(MessageCount))
+      << "Every message must be either written or counted as dropped";
+  int previous = -1;
+  for (const auto &line : lines) {
+    const int value = std::stoi(line);
+    EXPECT_GT(value, previous) << "Surviving messages must stay in order";
+    previous = value;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(LossyPolicies, AsyncLoggerOverflowPolicyTest,
+                         ::testing::Values(OverflowPolicy::DropNewest,
+                                           OverflowPolicy::DropOldest,
+                                           OverflowPolicy::Sample));
+
+// Value-parameterised test: Logger handles various message lengths
+class AsyncLoggerMessageLengthTest
+    : public AsyncLoggerTest,
+      public ::testing::WithParamInterface<std::size_t> {};
+
+TEST_P(AsyncLoggerMessageLengthTest, WritesMessageUnchanged) {
+  const std::size_t length = GetParam();
+  const std::string message(length, 'x');
+  {
+    auto logger = createAsyncLogger();
+    logger->log(message);
+  }
+
+  const auto lines = capturedLines();
+  ASSERT_EQ(lines.size(), 1U);
+  EXPECT_EQ(lines.front(), message)
+      << "Message of length " << length << " should round-trip";
+}
+
+// Test with messages of different lengths, including above the batch size
+INSTANTIATE_TEST_SUITE_P(MessageLengths, AsyncLoggerMessageLengthTest,
+                         ::testing::Values(0, 1, 100, 10000, 100000));
+
+// Test case: JSON lines carry the level, the message and each field
+TEST_F(AsyncLoggerTest, JsonLinesCarryFields) {
+  for (const QueueMode mode : {QueueMode::Shared, QueueMode::PerThread}) {
+    auto logger = createAsyncLogger(
+        {.lineFormat = LineFormat::Json, .queueMode = mode});
+    logger->log(Level::Warning, R"(say "hi")", field("n", 3),
+                field("ratio", 0.5), field("name", "x"));
+    logger->logf<"value {}">(1);
+    logger->log("plain");
+  }
+
+  const std::string fields =
+      R"({"level":"WARNING","message":"say \"hi\"","n":3,"ratio":0.5,)"
+      R"("name":"x"})";
+  const std::vector<std::string> expected{
+      fields, R"({"level":"INFO","message":"value 1"})",
+      R"({"level":"INFO","message":"plain"})"};
+  const auto lines = capturedLines();
+  ASSERT_EQ(lines.size(), 2 * expected.size());
+  for (std::size_t i = 0; i < lines.size(); ++i) {
+    EXPECT_EQ(lines[i], expected[i % expected.size()]);
+  }
+}
+
+// Test case: Logfmt lines quote only the values that need it
+TEST_F(AsyncLoggerTest, LogfmtLinesQuoteWhereNeeded) {
+  {
+    auto logger = createAsyncLogger({.lineFormat = LineFormat::Logfmt});
+    logger->log(Level::Error, "disk full", field("free", 0U),
+                field("path", "/var/log"), field("note", "a \"b\""));
+    logger->logf<"value {}">(1);
+    logger->log("plain");
+  }
+
+  const std::vector<std::string> expected{
+      R"(level=ERROR msg="disk full" free=0 path=/var/log note="a \"b\"")",
+      R"(level=INFO msg="value 1")", "level=INFO msg=plain"};
+  EXPECT_EQ(capturedLines(), expected);
+}
+
+// Test case: Timestamped JSON lines start with the time
+TEST_F(AsyncLoggerTest, JsonLinesStartWithTime) {
+  {
+    auto logger = createAsyncLogger(
+        {.timestamps = true, .lineFormat = LineFormat::Json});
+    logger->log("first", field("n", 1));
+  }
+
+  const std::regex pattern{
+      R"(^\{"time":"\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{9}Z",)"
+      R"("level":"INFO","message":"first","n":1\}$)"};
+  const auto lines = capturedLines();
+  ASSERT_EQ(lines.size(), 1U);
+  EXPECT_TRUE(std::regex_match(lines.front(), pattern)) << lines.front();
+}
+
+// Test case: Threads start with the first message, not with the logger
+TEST_F(AsyncLoggerTest, BackgroundThreadsStartOnFirstMessage) {
+  // Sanitizer runtimes start a helper thread with the first thread.
+  std::thread{[] {}}.join();
+  const std::ptrdiff_t before = threadCount();
+  for (const QueueMode mode : {QueueMode::Shared, QueueMode::PerThread}) {
+    auto logger = createAsyncLogger(
+        {.queueMode = mode,
+         .backendThreads = mode == QueueMode::PerThread ? 2U : 1U});
+    EXPECT_EQ(threadCount(), before) << "Unused logger starts no thread";
+    logger->flush();
+    EXPECT_EQ(threadCount(), before) << "Nor does flushing nothing";
+    logger->log("first");
+    EXPECT_EQ(threadCount(),
+              before + (mode == QueueMode::PerThread ? 2 : 1));
+  }
+  EXPECT_EQ(capturedLines(), (std::vector<std::string>{"first", "first"}));
+}
+
+} // namespace sample::logger::test
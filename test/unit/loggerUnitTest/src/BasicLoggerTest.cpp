@@ -0,0 +1,230 @@
+/// Unit tests for BasicLogger and LoggerAdapter.
+///
+/// This test suite validates the statically typed logger front-end, its
+/// adapter to `ILogger`, and the `Logger`/`LogSink` concepts.
+
+#include <logger/BasicLogger.hpp>
+#include <logger/ConsoleSink.hpp>
+#include <logger/DeferredFormat.hpp>
+#include <logger/Fields.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LogMacros.hpp>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+using Messages = std::vector<std::pair<Level, std::string>>;
+
+/// Sink that records every message it is asked to write.
+struct RecordingSink {
+  void write(Level level, std::string_view message) {
+    messages.emplace_back(level, message);
+  }
+
+  Messages messages;
+};
+
+/// Sink that also records which `logf()` call sites reach it unformatted.
+struct DeferredRecordingSink {
+  void write(Level level, std::string_view message) {
+    messages.emplace_back(level, message);
+  }
+
+  void writeDeferred(Level level, const DeferredFormat &format,
+                     std::span<const std::byte> args) {
+    patterns.emplace_back(format.pattern);
+    fmt::memory_buffer text;
+    format.format(args, text);
+    messages.emplace_back(level, fmt::to_string(text));
+  }
+
+  Messages messages;
+  std::vector<std::string_view> patterns;
+};
+
+/// Sink that counts the flushes it is asked for.
+struct FlushCountingSink {
+  void write(Level level, std::string_view message) {
+    messages.emplace_back(level, message);
+  }
+
+  void flush() { ++flushes; }
+
+  Messages messages;
+  int flushes = 0;
+};
+
+static_assert(LogSink<RecordingSink>);
+static_assert(!FlushableLogSink<RecordingSink>);
+static_assert(FlushableLogSink<FlushCountingSink>);
+static_assert(!FlushableLogSink<ConsoleSink>);
+static_assert(!DeferredLogSink<RecordingSink>);
+static_assert(DeferredLogSink<DeferredRecordingSink>);
+static_assert(LogSink<ConsoleSink>);
+static_assert(Logger<BasicLogger<RecordingSink>>);
+static_assert(Logger<LoggerAdapter<RecordingSink>>);
+static_assert(!Logger<RecordingSink>);
+
+/// Log through any `Logger`, to check the concept is usable generically.
+template <Logger L> void logThroughConcept(L &logger) {
+  logger.log(Level::Warning, "generic");
+  logger.template logf<"generic {}">(Level::Error, 2);
+}
+
+} // namespace
+
+// Test case: Messages reach the sink with their level, filtered at runtime
+TEST(BasicLoggerTest, RuntimeThresholdFiltersMessages) {
+  BasicLogger<RecordingSink> logger;
+  logger.setLevel(Level::Warning);
+  logger.log(Level::Info, "info");
+  logger.log(Level::Warning, "warning");
+  logger.log("default is info");
+  logger.logf<"error {}">(Level::Error, 1);
+  logger.logf<"debug {}">(Level::Debug, 2);
+
+  const Messages expected{{Level::Warning, "warning"},
+                          {Level::Error, "error 1"}};
+  EXPECT_EQ(logger.sink().messages, expected);
+}
+
+// Test case: Messages at or above the flush level flush the sink
+TEST(BasicLoggerTest, FlushLevelFlushesSevereMessages) {
+  BasicLogger<FlushCountingSink> logger;
+  logger.log(Level::Error, "unflushed");
+  EXPECT_EQ(logger.sink().flushes, 0) << "Nothing flushes by default";
+
+  logger.setFlushLevel(Level::Error);
+  EXPECT_EQ(logger.flushLevel(), Level::Error);
+  logger.log(Level::Warning, "buffered");
+  logger.logf<"failed {}">(Level::Error, 1);
+  logger.log(Level::Critical, "gave up", field("code", 2));
+  EXPECT_EQ(logger.sink().flushes, 2);
+  logger.flush();
+  EXPECT_EQ(logger.sink().flushes, 3);
+
+  BasicLogger<RecordingSink> plain;
+  plain.setFlushLevel(Level::Trace);
+  plain.log("no flush to forward");
+  plain.flush();
+  EXPECT_EQ(plain.sink().messages.size(), 1U);
+}
+
+// Test case: The adapter forwards flush() to the sink
+TEST(BasicLoggerTest, AdapterForwardsFlush) {
+  LoggerAdapter<FlushCountingSink> adapter;
+  ILogger &logger = adapter;
+  logger.flush();
+  logger.setFlushLevel(Level::Warning);
+  logger.log(Level::Warning, "flushed");
+  EXPECT_EQ(adapter.sink().flushes, 2);
+}
+
+// Test case: logf() formats strings and scalars like fmt
+TEST(BasicLoggerTest, LogfFormatsArguments) {
+  BasicLogger<RecordingSink> logger;
+  const std::string owned{"owned"};
+  logger.logf<"{} {} {:.1f} {}">(owned, "literal", 2.25, 'c');
+
+  ASSERT_EQ(logger.sink().messages.size(), 1U);
+  EXPECT_EQ(logger.sink().messages.front().second, "owned literal 2.2 c");
+}
+
+// Test case: A deferred sink receives logf() records unformatted
+TEST(BasicLoggerTest, DeferredSinkReceivesRecords) {
+  BasicLogger<DeferredRecordingSink> logger;
+  logger.logf<"took {}us">(Level::Warning, 42);
+  logger.log("plain");
+
+  const std::vector<std::string_view> patterns{"took {}us"};
+  EXPECT_EQ(logger.sink().patterns, patterns);
+  const Messages expected{{Level::Warning, "took 42us"},
+                          {Level::Info, "plain"}};
+  EXPECT_EQ(logger.sink().messages, expected);
+}
+
+// Test case: Structured messages render their fields as logfmt pairs
+TEST(BasicLoggerTest, StructuredMessagesRenderFields) {
+  BasicLogger<RecordingSink> direct;
+  BasicLogger<DeferredRecordingSink> deferred;
+  const std::string user{"a b"};
+  direct.log(Level::Warning, "done", field("id", 7), field("user", user),
+             field("ok", true), field("ratio", 0.5));
+  deferred.log(Level::Warning, "done", field("id", 7), field("user", user),
+               field("ok", true), field("ratio", 0.5));
+  direct.log("quoted", field("empty", ""), field("eq", "a=b"));
+
+  const Messages expected{
+      {Level::Warning, R"(done id=7 user="a b" ok=true ratio=0.5)"},
+      {Level::Info, R"(quoted empty="" eq="a=b")"}};
+  EXPECT_EQ(direct.sink().messages, expected);
+  ASSERT_EQ(deferred.sink().messages.size(), 1U);
+  EXPECT_EQ(deferred.sink().messages.front(), expected.front());
+}
+
+// Test case: The adapter exposes a sink through the virtual interface
+TEST(BasicLoggerTest, AdapterForwardsToSink) {
+  LoggerAdapter<DeferredRecordingSink> adapter;
+  ILogger &logger = adapter;
+  logger.setLevel(Level::Info);
+  logger.log(Level::Debug, "filtered");
+  logger.log("plain");
+  logger.logf<"value {}">(7);
+
+  const std::vector<std::string_view> patterns{"value {}"};
+  EXPECT_EQ(adapter.sink().patterns, patterns);
+  const Messages expected{{Level::Info, "plain"}, {Level::Info, "value 7"}};
+  EXPECT_EQ(adapter.sink().messages, expected);
+}
+
+// Test case: Code written against the Logger concept accepts both kinds
+TEST(BasicLoggerTest, LoggerConceptAcceptsStaticAndVirtual) {
+  BasicLogger<RecordingSink> staticLogger;
+  LoggerAdapter<RecordingSink> adapter;
+  logThroughConcept(staticLogger);
+  logThroughConcept(static_cast<ILogger &>(adapter));
+
+  const Messages expected{{Level::Warning, "generic"},
+                          {Level::Error, "generic 2"}};
+  EXPECT_EQ(staticLogger.sink().messages, expected);
+  EXPECT_EQ(adapter.sink().messages, expected);
+}
+
+// Test case: The LOGGER_* macros work with a BasicLogger
+TEST(BasicLoggerTest, MacrosAcceptBasicLogger) {
+  BasicLogger<RecordingSink> logger;
+  logger.setLevel(Level::Warning);
+  LOGGER_INFO(logger, "filtered");
+  LOGGER_WARNING(logger, "kept");
+  LOGGER_ERRORF(logger, "kept {}", 2);
+  LOGGER_ERROR(logger, "kept", field("n", 3));
+  LOGGER_DEBUG(logger, "filtered", field("n", 4));
+
+  const Messages expected{{Level::Warning, "kept"},
+                          {Level::Error, "kept 2"},
+                          {Level::Error, "kept n=3"}};
+  EXPECT_EQ(logger.sink().messages, expected);
+}
+
+// Test case: ConsoleSink writes one line per message to stdout
+TEST(BasicLoggerTest, ConsoleSinkWritesLines) {
+  ::testing::internal::CaptureStdout();
+  BasicLogger<ConsoleSink> logger;
+  logger.log("first");
+  logger.logf<"second {}">(2);
+  EXPECT_EQ(::testing::internal::GetCapturedStdout(), "first\nsecond 2\n");
+}
+
+} // namespace sample::logger::test
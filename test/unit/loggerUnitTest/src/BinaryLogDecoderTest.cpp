@@ -0,0 +1,223 @@
+/// Unit tests for the binary log format.
+///
+/// This test suite writes binary logs with the asynchronous logger and checks
+/// that `BinaryLogDecoder` turns them back into the text the logger would
+/// have written, or into JSON.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/BinaryLogDecoder.hpp>
+#include <logger/Fields.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// Test suite for binary logs; each test gets a fresh log file, removed when
+/// it ends.
+class BinaryLogDecoderTest : public ::testing::Test {
+protected:
+  /// A binary logger appending to the test's file.
+  [[nodiscard]] auto createLogger(AsyncLoggerConfig config = {})
+      -> std::unique_ptr<ILogger> {
+    config.target = LogTarget::File;
+    config.filePath = file_.path();
+    config.outputFormat = OutputFormat::Binary;
+    return createAsyncLogger(config);
+  }
+
+  /// The raw contents of the test's file.
+  [[nodiscard]] auto bytes() const -> std::vector<std::byte> {
+    return testsupport::readBytes(file_.path());
+  }
+
+  /// Decode the whole file with `format`.
+  [[nodiscard]] auto decoded(DecodeFormat format = DecodeFormat::Text) const
+      -> std::string {
+    const auto input = bytes();
+    BinaryLogDecoder decoder{format};
+    fmt::memory_buffer out;
+    EXPECT_EQ(decoder.decode(input, out), input.size());
+    return fmt::to_string(out);
+  }
+
+private:
+  const testsupport::TempLogFile file_;
+};
+
+} // namespace
+
+// Test case: Decoding reproduces the logger's text output
+TEST_F(BinaryLogDecoderTest, DecodesToLoggerText) {
+  {
+    auto logger = createLogger();
+    logger->log("plain");
+    logger->logf<"{} took {}us ({:.1f}%)">(std::string_view{"request"}, 840,
+                                             12.25);
+    logger->logf<"{} {} {} {}">('c', true, std::uint8_t{7}, -3L);
+    logger->logf<"{} took {}us ({:.1f}%)">(std::string_view{"again"}, 1, 0.5);
+  }
+  EXPECT_EQ(decoded(), "plain\n"
+                       "request took 840us (12.2%)\n"
+                       "c true 7 -3\n"
+                       "again took 1us (0.5%)\n");
+}
+
+// Test case: Each format string is stored once
+TEST_F(BinaryLogDecoderTest, StoresEachPatternOnce) {
+  constexpr std::string_view Pattern = "a rather long pattern for id {}";
+  {
+    auto logger = createLogger();
+    for (int i = 0; i < 100; ++i) {
+      logger->logf<"a rather long pattern for id {}">(i);
+    }
+  }
+  const auto input = bytes();
+  const std::string_view raw{reinterpret_cast<const char *>(input.data()),
+                             input.size()};
+  EXPECT_NE(raw.find(Pattern), std::string_view::npos);
+  EXPECT_EQ(raw.find(Pattern), raw.rfind(Pattern));
+  EXPECT_LT(input.size(), 100 * (Pattern.size() + 1));
+}
+
+// Test case: JSON output carries level, message, pattern and typed arguments
+TEST_F(BinaryLogDecoderTest, DecodesToJson) {
+  {
+    auto logger = createLogger();
+    logger->log(Level::Warning, "say \"hi\"\n");
+    logger->logf<"{}={}">(Level::Error, std::string_view{"x"}, 2.5);
+  }
+  EXPECT_EQ(decoded(DecodeFormat::Json),
+            "{\"level\":\"WARNING\",\"message\":\"say \\\"hi\\\"\\n\"}\n"
+            "{\"level\":\"ERROR\",\"message\":\"x=2.5\",\"pattern\":\"{}={}\","
+            "\"args\":[\"x\",2.5]}\n");
+}
+
+// Test case: Timestamps survive the round trip
+TEST_F(BinaryLogDecoderTest, DecodesTimestamps) {
+  {
+    auto logger = createLogger({.timestamps = true});
+    logger->log("stamped");
+  }
+  const std::string text = decoded();
+  ASSERT_EQ(text.size(), std::string_view{"YYYY-MM-DDTHH:MM:SS.nnnnnnnnnZ "}
+                                 .size() +
+                             std::string_view{"stamped\n"}.size());
+  EXPECT_TRUE(text.ends_with("Z stamped\n")) << text;
+  EXPECT_NE(decoded(DecodeFormat::Json).find("\"time\":\""),
+            std::string::npos);
+}
+
+// Test case: Input split at every byte decodes the same as in one piece
+TEST_F(BinaryLogDecoderTest, DecodesByteByByte) {
+  {
+    auto logger = createLogger();
+    logger->log("first");
+    logger->logf<"second {}">(2);
+  }
+  const auto input = bytes();
+  BinaryLogDecoder decoder;
+  fmt::memory_buffer out;
+  std::vector<std::byte> pending;
+  for (const std::byte byte : input) {
+    pending.push_back(byte);
+    const std::size_t used = decoder.decode(pending, out);
+    pending.erase(pending.begin(),
+                  pending.begin() + static_cast<std::ptrdiff_t>(used));
+  }
+  EXPECT_TRUE(pending.empty());
+  EXPECT_EQ(fmt::to_string(out), "first\nsecond 2\n");
+}
+
+// Test case: Sessions appended to one file decode in sequence
+TEST_F(BinaryLogDecoderTest, DecodesAppendedSessions) {
+  for (int session = 0; session < 2; ++session) {
+    auto logger = createLogger();
+    logger->logf<"session {}">(session);
+  }
+  EXPECT_EQ(decoded(), "session 0\nsession 1\n");
+}
+
+// Test case: Several per-thread backends write one decodable stream
+TEST_F(BinaryLogDecoderTest, DecodesPerThreadBackends) {
+  constexpr int ThreadCount = 4;
+  constexpr int MessagesPerThread = 500;
+  {
+    auto logger = createLogger({.capacity = 8,
+                                .maxBatchBytes = 128,
+                                .queueMode = QueueMode::PerThread,
+                                .backendThreads = 2});
+    std::vector<std::thread> producers;
+    for (int t = 0; t < ThreadCount; ++t) {
+      producers.emplace_back([&logger, t] {
+        for (int i = 0; i < MessagesPerThread; ++i) {
+          logger->logf<"{}:{}">(t, i);
+        }
+      });
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+  }
+  std::vector<int> next(ThreadCount, 0);
+  const std::string text = decoded();
+  for (std::size_t start = 0; start < text.size();) {
+    const std::size_t end = text.find('\n', start);
+    const std::string line = text.substr(start, end - start);
+    const auto colon = line.find(':');
+    ASSERT_NE(colon, std::string::npos) << line;
+    const auto thread = static_cast<std::size_t>(std::stoi(line));
+    ASSERT_LT(thread, next.size());
+    EXPECT_EQ(std::stoi(line.substr(colon + 1)), next[thread]++);
+    start = end + 1;
+  }
+  for (const int count : next) {
+    EXPECT_EQ(count, MessagesPerThread);
+  }
+}
+
+// Test case: Input that is not a binary log is rejected
+TEST_F(BinaryLogDecoderTest, RejectsNonBinaryInput) {
+  const std::string_view text = "plain text log\n";
+  const std::span input{reinterpret_cast<const std::byte *>(text.data()),
+                        text.size()};
+  BinaryLogDecoder decoder;
+  fmt::memory_buffer out;
+  EXPECT_THROW(static_cast<void>(decoder.decode(input, out)),
+               std::runtime_error);
+}
+
+// Test case: Structured messages decode to logfmt text or JSON members
+TEST_F(BinaryLogDecoderTest, DecodesStructuredMessages) {
+  {
+    auto logger = createLogger();
+    logger->log(Level::Warning, "done", field("id", 7),
+                field("user", std::string_view{"a b"}), field("ok", true));
+    logger->log("again", field("id", 8));
+  }
+  EXPECT_EQ(decoded(), "done id=7 user=\"a b\" ok=true\nagain id=8\n");
+  EXPECT_EQ(decoded(DecodeFormat::Json),
+            R"({"level":"WARNING","message":"done","id":7,"user":"a b",)"
+            R"("ok":true})"
+            "\n"
+            R"({"level":"INFO","message":"again","id":8})"
+            "\n");
+}
+
+} // namespace sample::logger::test
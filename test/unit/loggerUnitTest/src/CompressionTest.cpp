@@ -0,0 +1,297 @@
+/// Unit tests for compressed log output.
+///
+/// This test suite writes logs with `Compression::Lz4` and checks that
+/// `Lz4Decoder` and `BinaryLogDecoder` restore them, in whole, in chunks and
+/// after the output was cut short, and that `Lz4Decoder` reads frames
+/// written by the reference `lz4` tool and rejects corrupt ones.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/BinaryLogDecoder.hpp>
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/Lz4Decoder.hpp>
+#include <logger/UringLoggerConfig.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// `lz4 -BX --content-size` of "hello hello hello hello hello\n": block and
+/// content checksums and the content size, with 64 KiB blocks.
+constexpr std::array<std::uint8_t, 47> ReferenceFrame{
+    0x04, 0x22, 0x4d, 0x18, 0x7c, 0x40, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x7b, 0x10, 0x00, 0x00, 0x00, 0x6f, 0x68, 0x65, 0x6c, 0x6c,
+    0x6f, 0x20, 0x06, 0x00, 0x00, 0x50, 0x65, 0x6c, 0x6c, 0x6f, 0x0a, 0x8f,
+    0xf1, 0x2d, 0x4f, 0x00, 0x00, 0x00, 0x00, 0x2d, 0x82, 0x03, 0x39};
+
+/// Decompress all of `input`, expecting every byte to be consumed.
+auto decompress(std::span<const std::byte> input) -> std::string {
+  Lz4Decoder decoder;
+  fmt::memory_buffer out;
+  EXPECT_EQ(decoder.decode(input, out), input.size());
+  return fmt::to_string(out);
+}
+
+/// `bytes` as `std::byte`s.
+template <std::size_t Size>
+auto asBytes(const std::array<std::uint8_t, Size> &bytes)
+    -> std::vector<std::byte> {
+  std::vector<std::byte> result;
+  for (const std::uint8_t byte : bytes) {
+    result.push_back(static_cast<std::byte>(byte));
+  }
+  return result;
+}
+
+/// A log line for record `index`, alike enough to its neighbours to
+/// compress the way real logs do.
+auto requestLine(int index) -> std::string {
+  return fmt::format("GET /api/v1/items/{} user=user{} status=200 took={}us",
+                     index, index % 7, 100 + index % 13);
+}
+
+} // namespace
+
+/// Test suite for compressed files; each test gets a fresh log file,
+/// removed when it ends.
+class CompressionTest : public ::testing::TestWithParam<QueueMode> {
+protected:
+  /// A compressing logger appending to the test's file in the queue mode
+  /// under test.
+  [[nodiscard]] auto createLogger(AsyncLoggerConfig config = {}) const
+      -> std::unique_ptr<ILogger> {
+    config.target = LogTarget::File;
+    config.filePath = file_.path();
+    config.queueMode = GetParam();
+    config.backendThreads = GetParam() == QueueMode::PerThread ? 2U : 1U;
+    config.compression = Compression::Lz4;
+    return createAsyncLogger(config);
+  }
+
+  /// The raw contents of the test's file.
+  [[nodiscard]] auto bytes() const -> std::vector<std::byte> {
+    return testsupport::readBytes(file_.path());
+  }
+
+  /// Path of the test's file.
+  [[nodiscard]] auto path() const -> const std::filesystem::path & {
+    return file_.path();
+  }
+
+private:
+  const testsupport::TempLogFile file_;
+};
+
+INSTANTIATE_TEST_SUITE_P(QueueModes, CompressionTest,
+                         ::testing::Values(QueueMode::Shared,
+                                           QueueMode::PerThread));
+
+// Test case: A compressed text log decompresses to the records in order, in
+// a fraction of their size
+TEST_P(CompressionTest, RestoresTextAndShrinksIt) {
+  constexpr int Records = 4000;
+  std::string expected;
+  {
+    // Batches end only at the flushes, however fast the backend keeps up.
+    AsyncLoggerConfig config;
+    config.maxLatency = std::chrono::seconds{10};
+    auto logger = createLogger(config);
+    for (int i = 0; i < Records; ++i) {
+      logger->log(requestLine(i));
+      expected += requestLine(i) + "\n";
+      if (i % 500 == 0) {
+        logger->flush();
+      }
+    }
+  }
+  const auto input = bytes();
+  EXPECT_EQ(decompress(input), expected);
+  EXPECT_LT(input.size() * 4, expected.size())
+      << "Compressed to " << input.size() << " bytes";
+}
+
+// Test case: A compressed binary log decodes with `BinaryLogDecoder`, fed
+// whole or a byte at a time
+TEST_P(CompressionTest, BinaryLogDecodesDirectly) {
+  {
+    AsyncLoggerConfig config;
+    config.outputFormat = OutputFormat::Binary;
+    auto logger = createLogger(config);
+    logger->log("first");
+    logger->logf<"second {} {}">(2, std::string_view{"two"});
+  }
+  const auto input = bytes();
+  {
+    BinaryLogDecoder decoder;
+    fmt::memory_buffer out;
+    EXPECT_EQ(decoder.decode(input, out), input.size());
+    EXPECT_EQ(fmt::to_string(out), "first\nsecond 2 two\n");
+    EXPECT_EQ(decoder.buffered(), 0U);
+  }
+
+  BinaryLogDecoder decoder;
+  fmt::memory_buffer out;
+  std::vector<std::byte> pending;
+  for (const std::byte byte : input) {
+    pending.push_back(byte);
+    const std::size_t used = decoder.decode(pending, out);
+    pending.erase(pending.begin(),
+                  pending.begin() + static_cast<std::ptrdiff_t>(used));
+  }
+  EXPECT_TRUE(pending.empty());
+  EXPECT_EQ(fmt::to_string(out), "first\nsecond 2 two\n");
+}
+
+// Test case: A file cut off inside a block decodes up to the last whole one,
+// and a frame left open by a crash is followed by the next logger's
+TEST_P(CompressionTest, DecodesWhatACrashLeaves) {
+  constexpr int Records = 200;
+  std::string expected;
+  {
+    AsyncLoggerConfig config;
+    config.maxBatchBytes = 512;
+    auto logger = createLogger(config);
+    for (int i = 0; i < Records; ++i) {
+      logger->log(requestLine(i));
+      expected += requestLine(i) + "\n";
+    }
+  }
+  const auto input = bytes();
+
+  // The end mark and half the last block are lost.
+  const std::vector<std::byte> cut{input.begin(), input.end() - 40};
+  Lz4Decoder decoder;
+  fmt::memory_buffer out;
+  EXPECT_LT(decoder.decode(cut, out), cut.size());
+  const std::string partial = fmt::to_string(out);
+  ASSERT_FALSE(partial.empty());
+  EXPECT_LT(partial.size(), expected.size());
+  EXPECT_EQ(expected.substr(0, partial.size()), partial);
+  EXPECT_EQ(partial.back(), '\n') << "Batches hold whole records";
+
+  // Only the end mark is lost when the process dies: the next logger
+  // appends a frame of its own.
+  std::filesystem::resize_file(path(), input.size() - 4);
+  {
+    auto logger = createLogger();
+    logger->log("restarted");
+  }
+  EXPECT_EQ(decompress(bytes()), expected + "restarted\n");
+}
+
+// Test case: Incompressible records and a record longer than a block
+// survive the round trip
+TEST_P(CompressionTest, StoresIncompressibleAndLongRecords) {
+  std::mt19937 random{42};
+  std::uniform_int_distribution<int> printable{'!', '~'};
+  std::string noise(100000, ' ');
+  for (char &character : noise) {
+    character = static_cast<char>(printable(random));
+  }
+  const std::string longRecord(5 * 1024 * 1024 + 3, 'x');
+  {
+    AsyncLoggerConfig config;
+    config.maxBatchBytes = 8 * 1024 * 1024;
+    auto logger = createLogger(config);
+    logger->log(noise);
+    logger->flush();
+    logger->log(longRecord);
+  }
+  const auto input = bytes();
+  EXPECT_EQ(decompress(input), noise + "\n" + longRecord + "\n");
+  EXPECT_LT(input.size(), noise.size() + 1 + 64 * 1024);
+}
+
+// Test case: A logger that writes nothing leaves an empty frame
+TEST_P(CompressionTest, UnusedLoggerWritesAnEmptyFrame) {
+  static_cast<void>(createLogger());
+  const auto input = bytes();
+  EXPECT_TRUE(Lz4Decoder::startsFrame(input));
+  EXPECT_EQ(decompress(input), "");
+}
+
+// Test case: Frames from the reference implementation decode, whole or a
+// byte at a time, checksums, content size and skippable frames included
+TEST(Lz4DecoderTest, ReadsReferenceFrames) {
+  auto input = asBytes(std::array<std::uint8_t, 10>{
+      0x5A, 0x2A, 0x4D, 0x18, 0x02, 0x00, 0x00, 0x00, 0xAB, 0xCD});
+  const auto frame = asBytes(ReferenceFrame);
+  input.insert(input.end(), frame.begin(), frame.end());
+  input.insert(input.end(), frame.begin(), frame.end());
+  EXPECT_EQ(decompress(input), "hello hello hello hello hello\n"
+                               "hello hello hello hello hello\n");
+
+  Lz4Decoder decoder;
+  fmt::memory_buffer out;
+  std::vector<std::byte> pending;
+  for (const std::byte byte : input) {
+    pending.push_back(byte);
+    const std::size_t used = decoder.decode(pending, out);
+    pending.erase(pending.begin(),
+                  pending.begin() + static_cast<std::ptrdiff_t>(used));
+  }
+  EXPECT_TRUE(pending.empty());
+  EXPECT_EQ(fmt::to_string(out), "hello hello hello hello hello\n"
+                                 "hello hello hello hello hello\n");
+}
+
+// Test case: Input that is not LZ4 frames, or is corrupt, is rejected
+TEST(Lz4DecoderTest, RejectsCorruptInput) {
+  const auto decodeAll = [](std::vector<std::byte> input) {
+    Lz4Decoder decoder;
+    fmt::memory_buffer out;
+    static_cast<void>(decoder.decode(input, out));
+  };
+  const std::string_view text = "plain text log\n";
+  const auto *data = reinterpret_cast<const std::byte *>(text.data());
+  EXPECT_THROW(decodeAll({data, data + text.size()}), std::runtime_error);
+
+  auto badHeader = asBytes(ReferenceFrame);
+  badHeader[14] ^= std::byte{1};
+  EXPECT_THROW(decodeAll(badHeader), std::runtime_error);
+
+  auto badBlock = asBytes(ReferenceFrame);
+  badBlock[20] ^= std::byte{1};
+  EXPECT_THROW(decodeAll(badBlock), std::runtime_error);
+
+  // One literal, then a match reaching before the start of the block.
+  EXPECT_THROW(decodeAll(asBytes(std::array<std::uint8_t, 15>{
+                   0x04, 0x22, 0x4D, 0x18, 0x60, 0x70, 0x73, 0x04, 0x00,
+                   0x00, 0x00, 0x10, 'a', 0x05, 0x00})),
+               std::runtime_error);
+}
+
+// Test case: The fan-out and io_uring loggers refuse to compress
+TEST(CompressionConfigTest, OtherSinksRejectCompression) {
+  const testsupport::TempLogFile file;
+  AsyncLoggerConfig queue;
+  queue.compression = Compression::Lz4;
+  EXPECT_THROW(static_cast<void>(createFanOutLogger(
+                   {.queue = queue,
+                    .targets = {{.target = LogTarget::Stdout}}})),
+               std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(createUringFileLogger(
+                   {.queue = queue, .filePath = file.path()})),
+               std::invalid_argument);
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,227 @@
+/// Unit tests for deferred formatting.
+///
+/// This test suite validates `ILogger::logf()` against both the synchronous
+/// and the asynchronous logger, and the argument encoding it relies on.
+
+#include <logger/DeferredFormat.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// Logger implementations under test.
+enum class LoggerKind { Console, Async };
+
+/// Printable name of a `LoggerKind`, used for test names.
+auto PrintToString(LoggerKind kind) -> std::string {
+  return kind == LoggerKind::Console ? "Console" : "Async";
+}
+
+/// Test suite for deferred formatting, parameterised over logger factories.
+///
+/// Captures stdout so the formatted text can be checked after the logger has
+/// been destroyed (which drains any queue).
+class DeferredFormatTest : public ::testing::TestWithParam<LoggerKind> {
+protected:
+  /// Start capturing stdout.
+  void SetUp() override { ::testing::internal::CaptureStdout(); }
+
+  /// Stop capturing if a test did not collect the output itself.
+  void TearDown() override {
+    if (!collected_) {
+      static_cast<void>(::testing::internal::GetCapturedStdout());
+    }
+  }
+
+  /// Create a logger with the factory under test.
+  [[nodiscard]] static auto makeLogger() -> std::unique_ptr<ILogger> {
+    return GetParam() == LoggerKind::Console ? createDefaultLogger()
+                                             : createAsyncLogger();
+  }
+
+  /// Stop capturing and return everything written to stdout.
+  [[nodiscard]] auto capturedOutput() -> std::string {
+    collected_ = true;
+    return ::testing::internal::GetCapturedStdout();
+  }
+
+private:
+  bool collected_ = false;
+};
+
+} // namespace
+
+// Test case: Integral and floating-point arguments are formatted
+TEST_P(DeferredFormatTest, FormatsArithmeticArguments) {
+  {
+    auto logger = makeLogger();
+    logger->logf<"request {} took {}us ({:.1f}%)">(42, std::uint64_t{1500},
+                                                    12.5);
+  }
+  EXPECT_EQ(capturedOutput(), "request 42 took 1500us (12.5%)\n");
+}
+
+// Test case: String arguments are copied, so temporaries are safe
+TEST_P(DeferredFormatTest, CopiesStringArguments) {
+  {
+    auto logger = makeLogger();
+    {
+      std::string user{"alice"};
+      logger->logf<"user={} action={}">(user, "login");
+      user.assign("overwritten");
+    }
+    logger->logf<"{}">(std::string_view{"view"});
+  }
+  EXPECT_EQ(capturedOutput(), "user=alice action=login\nview\n");
+}
+
+// Test case: A format string without placeholders needs no arguments
+TEST_P(DeferredFormatTest, FormatsWithoutArguments) {
+  {
+    auto logger = makeLogger();
+    logger->logf<"no arguments">();
+  }
+  EXPECT_EQ(capturedOutput(), "no arguments\n");
+}
+
+// Test case: Arguments larger than the inline encode buffer are handled
+TEST_P(DeferredFormatTest, FormatsLargeStringArgument) {
+  const std::string large(4096, 'x');
+  {
+    auto logger = makeLogger();
+    logger->logf<"[{}]">(large);
+  }
+  EXPECT_EQ(capturedOutput(), "[" + large + "]\n");
+}
+
+// Test case: Plain and deferred messages keep their relative order
+TEST_P(DeferredFormatTest, InterleavesWithPlainMessages) {
+  {
+    auto logger = makeLogger();
+    logger->log("one");
+    logger->logf<"{}">(2);
+    logger->log("three");
+  }
+  EXPECT_EQ(capturedOutput(), "one\n2\nthree\n");
+}
+
+// Test case: Compiled formats honour specs, manual indexing and escapes
+TEST_P(DeferredFormatTest, FormatsWithSpecs) {
+  {
+    auto logger = makeLogger();
+    logger->logf<"[{:>6}] [{:<4}] [{:#x}] [{:.3f}] {{literal}}">(
+        std::string_view{"right"}, 'c', 255U, 3.14159);
+    logger->logf<"{1} before {0}">(1, "two");
+    logger->logf<"[{:*^{}}]">(std::string_view{"mid"}, 9);
+  }
+  EXPECT_EQ(capturedOutput(),
+            "[ right] [c   ] [0xff] [3.142] {literal}\n"
+            "two before 1\n"
+            "[***mid***]\n");
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Loggers, DeferredFormatTest,
+    ::testing::Values(LoggerKind::Console, LoggerKind::Async),
+    [](const ::testing::TestParamInfo<LoggerKind> &info) {
+      return PrintToString(info.param);
+    });
+
+// Test case: Call sites with the same format and types share a descriptor
+TEST(DeferredFormatDescriptorTest, DescriptorIsUniquePerCallSiteType) {
+  const auto &first = detail::deferredFormatFor<"{}", int>;
+  const auto &second = detail::deferredFormatFor<"{}", int>;
+  const auto &other = detail::deferredFormatFor<"{}", double>;
+
+  EXPECT_EQ(&first, &second);
+  EXPECT_NE(&first, &other);
+  EXPECT_EQ(first.pattern, "{}");
+}
+
+// Test case: Encoding then decoding reproduces the formatted text
+TEST(DeferredFormatDescriptorTest, EncodedArgumentsRoundTrip) {
+  const int number = -7;
+  const std::string_view text{"abc"};
+  detail::EncodeBuffer buffer{detail::encodedSize(number) +
+                              detail::encodedSize(text)};
+  std::byte *cursor = detail::encodeArg(buffer.data(), number);
+  cursor = detail::encodeArg(cursor, text);
+  ASSERT_EQ(cursor, buffer.data() + buffer.bytes().size());
+
+  fmt::memory_buffer out;
+  detail::deferredFormatFor<"{} {}", int, std::string_view>.format(
+      buffer.bytes(), out);
+  EXPECT_EQ(std::string_view(out.data(), out.size()), "-7 abc");
+}
+
+// Test case: Format strings are parsed into argument counts at compile time
+TEST(DeferredFormatDescriptorTest, ParsesFormatStringsAtCompileTime) {
+  static_assert(detail::parseFormat("no fields").arguments == 0);
+  static_assert(detail::parseFormat("{} and {:>8.2f}").arguments == 2);
+  static_assert(detail::parseFormat("{{}} {}} }}").valid == false);
+  static_assert(detail::parseFormat("{{escaped}} {}").arguments == 1);
+  static_assert(detail::parseFormat("{:{}.{}}").arguments == 3);
+  static_assert(detail::parseFormat("{2} {0}").arguments == 3);
+  static_assert(!detail::parseFormat("{").valid);
+  static_assert(!detail::parseFormat("}").valid);
+  static_assert(!detail::parseFormat("{:>8").valid);
+  static_assert(!detail::parseFormat("{name}").valid);
+  static_assert(!detail::parseFormat("{} {0}").valid);
+  SUCCEED();
+}
+
+// Test case: Arguments that only refer to their data are rejected at compile
+// time, except strings, which are copied, and `void` pointers
+TEST(DeferredFormatDescriptorTest, RejectsArgumentsThatBorrowTheirData) {
+  static_assert(DeferredArgument<int>);
+  static_assert(DeferredArgument<const char *>);
+  static_assert(DeferredArgument<std::string_view>);
+  static_assert(DeferredArgument<std::string>);
+  static_assert(DeferredArgument<const void *>);
+  static_assert(DeferredArgument<std::nullptr_t>);
+  static_assert(DeferredArgument<std::array<int, 3>>);
+  static_assert(!DeferredArgument<const int *>);
+  static_assert(!DeferredArgument<int[3]>);
+  static_assert(!DeferredArgument<std::span<const int>>);
+  static_assert(!DeferredArgument<std::vector<int>::const_iterator>);
+  static_assert(!DeferredArgument<std::ranges::iota_view<int, int>>);
+  SUCCEED();
+}
+
+// Test case: Arguments without strings are encoded at fixed offsets into a
+// record of exactly their size
+TEST(DeferredFormatDescriptorTest, FixedArgumentsUseExactRecord) {
+  std::size_t size = 0;
+  std::string text;
+  detail::encodeDeferred<"{} {} {}">(
+      [&size, &text](const DeferredFormat &format,
+                     std::span<const std::byte> bytes) {
+        size = bytes.size();
+        fmt::memory_buffer out;
+        format.format(bytes, out);
+        text = fmt::to_string(out);
+      },
+      std::int8_t{-1}, 2.5, std::uint16_t{3});
+  EXPECT_EQ(size, sizeof(std::int8_t) + sizeof(double) + sizeof(std::uint16_t));
+  EXPECT_EQ(text, "-1 2.5 3");
+  EXPECT_EQ((detail::fixedOffsetsOf<std::int8_t, double, std::uint16_t>),
+            (std::array<std::size_t, 3>{0, 1, 9}));
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,112 @@
+/// Unit tests for the fan-out logger.
+///
+/// This test suite validates `createFanOutLogger()`: per-destination level
+/// filtering, destinations with their own thread, and configuration checks.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace sample::logger::test {
+
+// Test case: Each destination keeps the records at or above its own level
+TEST(FanOutLoggerTest, DestinationsFilterByLevel) {
+  const testsupport::TempLogFile allFile{"_all"};
+  const auto &all = allFile.path();
+  const testsupport::TempLogFile errorsFile{"_errors"};
+  const auto &errors = errorsFile.path();
+  {
+    auto logger = createFanOutLogger(
+        {.targets = {{.target = LogTarget::File, .filePath = all},
+                     {.target = LogTarget::File,
+                      .filePath = errors,
+                      .minLevel = Level::Error}}});
+    logger->log(Level::Info, "started");
+    logger->log(Level::Error, "failed");
+    logger->log(Level::Warning, "retrying");
+    logger->log(Level::Critical, "gave up");
+  }
+  EXPECT_EQ(testsupport::readFile(all), "started\nfailed\nretrying\ngave up\n");
+  EXPECT_EQ(testsupport::readFile(errors), "failed\ngave up\n");
+}
+
+// Test case: Every destination receives the same formatted text
+TEST(FanOutLoggerTest, DestinationsShareFormattedText) {
+  constexpr int MessageCount = 1000;
+  const testsupport::TempLogFile inlineFile{"_inline"};
+  const auto &inline_ = inlineFile.path();
+  const testsupport::TempLogFile threadedFile{"_threaded"};
+  const auto &threaded = threadedFile.path();
+  {
+    auto logger = createFanOutLogger(
+        {.queue = {.capacity = 16,
+                   .maxBatchBytes = 64,
+                   .lineFormat = LineFormat::Json},
+         .targets = {{.target = LogTarget::File, .filePath = inline_},
+                     {.target = LogTarget::File,
+                      .filePath = threaded,
+                      .ownThread = true}},
+         .maxPendingBatches = 1});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->logf<"message {}">(Level::Info, i);
+    }
+  }
+  const std::string text = testsupport::readFile(inline_);
+  EXPECT_EQ(testsupport::readFile(threaded), text);
+  std::string expected;
+  for (int i = 0; i < MessageCount; ++i) {
+    expected += R"({"level":"INFO","message":"message )" + std::to_string(i) +
+                "\"}\n";
+  }
+  EXPECT_EQ(text, expected);
+}
+
+// Test case: Factory rejects a logger with nowhere to write
+TEST(FanOutLoggerTest, CreateFanOutLoggerRejectsNoTargets) {
+  EXPECT_THROW(static_cast<void>(createFanOutLogger({})),
+               std::invalid_argument);
+}
+
+// Test case: Factory rejects settings the shared queue does not support
+TEST(FanOutLoggerTest, CreateFanOutLoggerRejectsUnsupportedQueues) {
+  const std::vector<FanOutTarget> targets{{}};
+  EXPECT_THROW(static_cast<void>(createFanOutLogger(
+                   {.queue = {.outputFormat = OutputFormat::Binary},
+                    .targets = targets})),
+               std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(createFanOutLogger(
+                   {.queue = {.queueMode = QueueMode::PerThread},
+                    .targets = targets})),
+               std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(createFanOutLogger(
+                   {.queue = {.capacity = 1}, .targets = targets})),
+               std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(createFanOutLogger(
+                   {.targets = targets, .maxPendingBatches = 0})),
+               std::invalid_argument);
+}
+
+// Test case: A log file that cannot be opened is reported
+TEST(FanOutLoggerTest, UnopenableFileThrowsSystemError) {
+  const testsupport::TempLogFile file{"_missing"};
+  const auto path = file.path() / "log.txt";
+  EXPECT_THROW(static_cast<void>(createFanOutLogger(
+                   {.targets = {{.target = LogTarget::File,
+                                 .filePath = path}}})),
+               std::system_error);
+}
+
+} // namespace sample::logger::test
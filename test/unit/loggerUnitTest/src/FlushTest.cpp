@@ -0,0 +1,154 @@
+/// Unit tests for explicit and level-triggered flushing.
+///
+/// This test suite validates `ILogger::flush()` and `setFlushLevel()` on the
+/// asynchronous loggers, and that `installCrashHandler()` drains them when
+/// the process is killed.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/CrashHandler.hpp>
+#include <logger/FanOutLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// A configuration that would hold a partial batch for an hour.
+auto lingeringConfig(QueueMode mode, const std::filesystem::path &path)
+    -> AsyncLoggerConfig {
+  return {.target = LogTarget::File,
+          .filePath = path,
+          .maxLatency = 1h,
+          .queueMode = mode,
+          .backendThreads = mode == QueueMode::PerThread ? 2U : 1U};
+}
+
+} // namespace
+
+/// Test suite for flushing the asynchronous logger in each queue mode.
+class AsyncFlushTest : public ::testing::TestWithParam<QueueMode> {};
+
+INSTANTIATE_TEST_SUITE_P(QueueModes, AsyncFlushTest,
+                         ::testing::Values(QueueMode::Shared,
+                                           QueueMode::PerThread));
+
+// Test case: flush() writes a lingering batch before it returns
+TEST_P(AsyncFlushTest, FlushWritesPendingRecords) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto logger = createAsyncLogger(lingeringConfig(GetParam(), path));
+  logger->flush();
+  EXPECT_EQ(testsupport::readFile(path), "")
+      << "Flushing nothing returns at once";
+
+  logger->log("first");
+  logger->logf<"second {}">(2);
+  logger->flush();
+  EXPECT_EQ(testsupport::readFile(path), "first\nsecond 2\n");
+
+  logger->log("third");
+  logger->flush();
+  EXPECT_EQ(testsupport::readFile(path), "first\nsecond 2\nthird\n");
+}
+
+// Test case: Each thread's flush() covers the messages it logged
+TEST_P(AsyncFlushTest, FlushFromSeveralThreads) {
+  constexpr int ThreadCount = 4;
+  constexpr int MessagesPerThread = 200;
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto logger = createAsyncLogger(lingeringConfig(GetParam(), path));
+  std::vector<std::thread> threads;
+  std::vector<std::string> seen(ThreadCount);
+  for (int thread = 0; thread < ThreadCount; ++thread) {
+    threads.emplace_back([&, thread] {
+      const std::string last = "thread " + std::to_string(thread) + " done";
+      for (int i = 0; i < MessagesPerThread; ++i) {
+        logger->logf<"thread {} message {}">(thread, i);
+      }
+      logger->log(last);
+      logger->flush();
+      seen[thread] = testsupport::readFile(path).contains(last) ? last : "";
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  for (int thread = 0; thread < ThreadCount; ++thread) {
+    EXPECT_EQ(seen[thread], "thread " + std::to_string(thread) + " done");
+  }
+}
+
+// Test case: Messages at the flush level are written before log() returns
+TEST_P(AsyncFlushTest, FlushLevelWritesSevereMessages) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto logger = createAsyncLogger(lingeringConfig(GetParam(), path));
+  EXPECT_EQ(logger->flushLevel(), Level::Off);
+  logger->setFlushLevel(Level::Error);
+  EXPECT_EQ(logger->flushLevel(), Level::Error);
+
+  logger->log(Level::Info, "context");
+  logger->log(Level::Warning, "unflushed");
+  std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(testsupport::readFile(path), "")
+      << "Below the flush level: still batched";
+
+  logger->log(Level::Error, "failed");
+  EXPECT_EQ(testsupport::readFile(path), "context\nunflushed\nfailed\n");
+}
+
+// Test case: flush() waits for destinations with their own thread
+TEST(FlushTest, FanOutFlushWaitsForDestinationThreads) {
+  const testsupport::TempLogFile inlineFile{"_inline"};
+  const auto &inline_ = inlineFile.path();
+  const testsupport::TempLogFile threadedFile{"_threaded"};
+  const auto &threaded = threadedFile.path();
+  auto logger = createFanOutLogger(
+      {.queue = {.maxLatency = 1h},
+       .targets = {{.target = LogTarget::File, .filePath = inline_},
+                   {.target = LogTarget::File,
+                    .filePath = threaded,
+                    .ownThread = true}}});
+  logger->log("one");
+  logger->log(Level::Error, "two");
+  logger->flush();
+  EXPECT_EQ(testsupport::readFile(inline_), "one\ntwo\n");
+  EXPECT_EQ(testsupport::readFile(threaded), "one\ntwo\n");
+}
+
+// Test case: The crash handler writes out queued records before the process
+// dies of the signal
+TEST_P(AsyncFlushTest, CrashHandlerDrainsOnSignal) {
+  GTEST_FLAG_SET(death_test_style, "threadsafe");
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  const QueueMode mode = GetParam();
+  EXPECT_EXIT(
+      {
+        installCrashHandler();
+        auto logger = createAsyncLogger(lingeringConfig(mode, path));
+        logger->log("before the crash");
+        logger->log(Level::Error, "last words");
+        static_cast<void>(std::raise(SIGTERM));
+      },
+      ::testing::KilledBySignal(SIGTERM), "");
+  EXPECT_EQ(testsupport::readFile(path), "before the crash\nlast words\n");
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,448 @@
+/// Unit tests for log contexts and asynchronous flushes.
+///
+/// This test suite validates `LogContext` and `ScopedLogContext`, the pairs
+/// records carry in each record kind and line format, contexts following a
+/// coroutine across threads with `LogContextPromise`, and
+/// `ILogger::flushAsync()`.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/BasicLogger.hpp>
+#include <logger/DeferredFormat.hpp>
+#include <logger/Fields.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogContext.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerFactory.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// The context of a request, as a service would set it.
+auto requestContext(std::string_view id) -> LogContext {
+  LogContext context;
+  context.set("request_id", id);
+  context.set("trace", "a b");
+  return context;
+}
+
+/// Sink that formats every record it is handed, deferred or not.
+struct TextSink {
+  void write(Level /*level*/, std::string_view message) {
+    lines.emplace_back(message);
+  }
+
+  void writeDeferred(Level /*level*/, const DeferredFormat &format,
+                     std::span<const std::byte> args) {
+    fmt::memory_buffer text;
+    format.format(args, text);
+    lines.push_back(fmt::to_string(text));
+  }
+
+  std::vector<std::string> lines;
+};
+
+/// Sink that only takes text.
+struct PlainTextSink {
+  void write(Level /*level*/, std::string_view message) {
+    lines.emplace_back(message);
+  }
+
+  std::vector<std::string> lines;
+};
+
+/// Sink that notes the thread it was last flushed on.
+struct FlushingSink {
+  void write(Level /*level*/, std::string_view message) {
+    lines.emplace_back(message);
+  }
+
+  void flush() { flushedOn = std::this_thread::get_id(); }
+
+  std::vector<std::string> lines;
+  std::thread::id flushedOn;
+};
+
+/// A minimal lazily started coroutine task whose context follows it.
+///
+/// `finished` is set once the coroutine has suspended for the last time, so
+/// that the test may destroy it from another thread.
+class Task {
+public:
+  struct promise_type : LogContextPromise {
+    auto get_return_object() -> Task {
+      return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    auto initial_suspend() { return inContext(std::suspend_always{}); }
+    auto final_suspend() noexcept { return leavingContext(Finished{}); }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+
+    std::atomic<bool> *finished = nullptr;
+  };
+
+  Task(const Task &) = delete;
+  auto operator=(const Task &) -> Task & = delete;
+  Task(Task &&) = delete;
+  auto operator=(Task &&) -> Task & = delete;
+
+  ~Task() { coroutine_.destroy(); }
+
+  /// Run the coroutine on this thread until it first suspends, then wait
+  /// until it has finished, wherever it resumes.
+  void runToCompletion() {
+    std::atomic<bool> finished{false};
+    coroutine_.promise().finished = &finished;
+    coroutine_.resume();
+    finished.wait(false);
+  }
+
+private:
+  struct Finished {
+    [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+    void
+    await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept {
+      std::atomic<bool> *finished = coroutine.promise().finished;
+      finished->store(true);
+      finished->notify_all();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  explicit Task(std::coroutine_handle<promise_type> coroutine)
+      : coroutine_{coroutine} {}
+
+  std::coroutine_handle<promise_type> coroutine_;
+};
+
+/// Threads that resume coroutines, joined on destruction.
+class Resumers {
+public:
+  Resumers() = default;
+  Resumers(const Resumers &) = delete;
+  auto operator=(const Resumers &) -> Resumers & = delete;
+  Resumers(Resumers &&) = delete;
+  auto operator=(Resumers &&) -> Resumers & = delete;
+
+  ~Resumers() {
+    std::vector<std::thread> threads;
+    {
+      // The last `resume()` may still be returning.
+      const std::lock_guard lock{mutex_};
+      threads = std::move(threads_);
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+
+  /// Resume `coroutine` on a new thread.
+  void resume(std::coroutine_handle<> coroutine) {
+    // The coroutine may resume here again before `emplace_back()` returns.
+    const std::lock_guard lock{mutex_};
+    threads_.emplace_back([coroutine] { coroutine.resume(); });
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::thread> threads_;
+};
+
+/// Resumes the awaiting coroutine on a new thread of `resumers`.
+struct ResumeOnNewThread {
+  Resumers &resumers;
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+  void await_suspend(std::coroutine_handle<> coroutine) {
+    resumers.resume(coroutine);
+  }
+  void await_resume() const noexcept {}
+};
+
+/// Gives the coroutine its own context, without suspending.
+struct ThisContext {
+  LogContext *context = nullptr;
+
+  [[nodiscard]] auto await_ready() const noexcept -> bool { return false; }
+  auto await_suspend(std::coroutine_handle<Task::promise_type> coroutine)
+      -> bool {
+    context = &coroutine.promise().logContext();
+    return false;
+  }
+  auto await_resume() const -> LogContext & { return *context; }
+};
+
+} // namespace
+
+// Test case: Pairs keep the order their keys were first set in
+TEST(LogContextTest, KeepsPairsInOrder) {
+  LogContext context;
+  EXPECT_TRUE(context.empty());
+  context.set("user", "ada");
+  context.set("request_id", "7");
+  context.set("user", "grace hopper");
+  ASSERT_EQ(context.fields().size(), 2U);
+  EXPECT_EQ(context.fields()[0].key, "user");
+  EXPECT_EQ(context.text(), " user=\"grace hopper\" request_id=7");
+  context.erase("user");
+  context.erase("missing");
+  EXPECT_EQ(context.text(), " request_id=7");
+  context.erase("request_id");
+  EXPECT_TRUE(context.empty());
+  EXPECT_EQ(context.text(), "");
+}
+
+// Test case: Empty keys and too many pairs are rejected
+TEST(LogContextTest, RejectsInvalidPairs) {
+  LogContext context;
+  EXPECT_THROW(context.set("", "value"), std::invalid_argument);
+  for (std::size_t key = 0; key < LogContext::MaxFields; ++key) {
+    context.set(std::to_string(key), "value");
+  }
+  EXPECT_THROW(context.set("one more", "value"), std::length_error);
+  EXPECT_NO_THROW(context.set("0", "replaced"));
+}
+
+// Test case: A scope makes a context active until it ends, and nests
+TEST(LogContextTest, ScopesNest) {
+  EXPECT_EQ(LogContext::active(), nullptr);
+  const LogContext outer = requestContext("1");
+  {
+    const ScopedLogContext outerScope{outer};
+    EXPECT_EQ(LogContext::active(), &outer);
+    const LogContext empty;
+    {
+      const ScopedLogContext innerScope{empty};
+      EXPECT_EQ(LogContext::active(), nullptr) << "An empty context masks";
+    }
+    EXPECT_EQ(LogContext::active(), &outer);
+  }
+  EXPECT_EQ(LogContext::active(), nullptr);
+}
+
+// Test case: Every kind of record carries the active context's pairs
+TEST(LogContextTest, RecordsCarryActivePairs) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  {
+    auto logger = createAsyncLogger(
+        {.target = LogTarget::File, .filePath = path});
+    const LogContext context = requestContext("42");
+    {
+      const ScopedLogContext scope{context};
+      logger->log("accepted");
+      logger->log(Level::Warning, "slow", field("micros", 900));
+      logger->logf<"took {}us">(900);
+      logger->logf<"{1} then {0}">("second", "first");
+    }
+    logger->log("done");
+  }
+  EXPECT_EQ(testsupport::readFile(path),
+            "accepted request_id=42 trace=\"a b\"\n"
+            "slow micros=900 request_id=42 trace=\"a b\"\n"
+            "took 900us request_id=42 trace=\"a b\"\n"
+            "first then second request_id=42 trace=\"a b\"\n"
+            "done\n");
+}
+
+// Test case: In JSON lines the pairs of log() records are fields
+TEST(LogContextTest, PairsAreJsonFields) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  {
+    auto logger = createAsyncLogger({.target = LogTarget::File,
+                                     .filePath = path,
+                                     .lineFormat = LineFormat::Json});
+    const LogContext context = requestContext("42");
+    const ScopedLogContext scope{context};
+    logger->log("accepted");
+  }
+  EXPECT_EQ(testsupport::readFile(path),
+            "{\"level\":\"INFO\",\"message\":\"accepted\","
+            "\"request_id\":\"42\",\"trace\":\"a b\"}\n");
+}
+
+// Test case: Statically typed loggers pick the context up too, with or
+// without deferred formatting
+TEST(LogContextTest, BasicLoggersCarryActivePairs) {
+  BasicLogger<TextSink> deferred;
+  BasicLogger<PlainTextSink> plain;
+  LogContext context;
+  context.set("id", "9");
+  const ScopedLogContext scope{context};
+  deferred.log("started");
+  deferred.logf<"step {}">(2);
+  plain.log("started");
+  plain.log("done", field("ok", true));
+  plain.logf<"step {}">(2);
+  EXPECT_EQ(deferred.sink().lines,
+            (std::vector<std::string>{"started id=9", "step 2 id=9"}));
+  EXPECT_EQ(plain.sink().lines,
+            (std::vector<std::string>{"started id=9", "done ok=true id=9",
+                                      "step 2 id=9"}));
+}
+
+// Test case: A coroutine's context is active wherever it resumes, and only
+// while it runs
+TEST(LogContextTest, ContextFollowsCoroutineAcrossThreads) {
+  BasicLogger<TextSink> logger;
+  Resumers threads;
+  std::vector<std::thread::id> resumedOn;
+  const LogContext handler = requestContext("7");
+  auto body = [&](std::string_view step) -> Task {
+    logger.log(step);
+    co_await ResumeOnNewThread{threads};
+    resumedOn.push_back(std::this_thread::get_id());
+    logger.logf<"{} resumed">(step);
+    co_await ResumeOnNewThread{threads};
+    logger.log("finished");
+  };
+  {
+    const ScopedLogContext scope{handler};
+    Task task = body("inherited");
+    task.runToCompletion();
+    EXPECT_EQ(LogContext::active(), &handler) << "Restored on suspension";
+  }
+  ASSERT_EQ(resumedOn.size(), 1U);
+  EXPECT_NE(resumedOn.front(), std::this_thread::get_id());
+  EXPECT_EQ(logger.sink().lines,
+            (std::vector<std::string>{
+                "inherited request_id=7 trace=\"a b\"",
+                "inherited resumed request_id=7 trace=\"a b\"",
+                "finished request_id=7 trace=\"a b\""}));
+}
+
+// Test case: A coroutine may set its own context, which does not leak
+TEST(LogContextTest, CoroutineSetsItsOwnContext) {
+  BasicLogger<TextSink> logger;
+  Resumers threads;
+  auto body = [&]() -> Task {
+    logger.log("before");
+    LogContext &context = co_await ThisContext{};
+    context.set("job", "3");
+    logger.log("set");
+    co_await ResumeOnNewThread{threads};
+    logger.log("after");
+  };
+  Task task = body();
+  task.runToCompletion();
+  EXPECT_EQ(LogContext::active(), nullptr);
+  EXPECT_EQ(logger.sink().lines,
+            (std::vector<std::string>{"before", "set job=3", "after job=3"}));
+}
+
+// Test case: Awaiting something already ready keeps the context, and the
+// coroutine still leaves it behind when it finishes
+TEST(LogContextTest, ReadyAwaitableKeepsContext) {
+  BasicLogger<TextSink> logger;
+  const LogContext handler = requestContext("9");
+  auto body = [&]() -> Task {
+    co_await std::suspend_never{};
+    logger.log("ready");
+    co_await std::suspend_never{};
+  };
+  {
+    const ScopedLogContext scope{handler};
+    Task task = body();
+    task.runToCompletion();
+    EXPECT_EQ(LogContext::active(), &handler) << "Restored on suspension";
+  }
+  EXPECT_EQ(LogContext::active(), nullptr);
+  EXPECT_EQ(logger.sink().lines,
+            (std::vector<std::string>{"ready request_id=9 trace=\"a b\""}));
+}
+
+/// Test suite for `flushAsync()` in each queue mode.
+class FlushAsyncTest : public ::testing::TestWithParam<QueueMode> {};
+
+INSTANTIATE_TEST_SUITE_P(QueueModes, FlushAsyncTest,
+                         ::testing::Values(QueueMode::Shared,
+                                           QueueMode::PerThread));
+
+// Test case: A coroutine resumes from flushAsync() once its records are
+// written, on another thread
+TEST_P(FlushAsyncTest, ResumesOnceWritten) {
+  constexpr int MessageCount = 200;
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto logger = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = path,
+                                   .maxLatency = std::chrono::seconds{10},
+                                   .queueMode = GetParam()});
+  std::string written;
+  std::thread::id resumedOn;
+  auto body = [&]() -> Task {
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->logf<"message {}">(i);
+    }
+    co_await logger->flushAsync();
+    resumedOn = std::this_thread::get_id();
+    written = testsupport::readFile(path);
+  };
+  Task task = body();
+  task.runToCompletion();
+  EXPECT_NE(resumedOn, std::this_thread::get_id());
+  EXPECT_EQ(std::ranges::count(written, '\n'), MessageCount);
+}
+
+// Test case: The scheduler given to flushAsync() resumes the coroutine
+TEST_P(FlushAsyncTest, SchedulerResumesCoroutine) {
+  auto logger = createAsyncLogger({.target = LogTarget::File,
+                                   .filePath = "/dev/null",
+                                   .queueMode = GetParam()});
+  std::atomic<int> scheduled{0};
+  Resumers threads;
+  auto body = [&]() -> Task {
+    co_await logger->flushAsync([](std::coroutine_handle<> coroutine) {
+      coroutine.resume();
+    });
+    logger->log("first");
+    co_await logger->flushAsync(
+        [&scheduled, &threads](std::coroutine_handle<> coroutine) {
+          ++scheduled;
+          threads.resume(coroutine);
+        });
+  };
+  Task task = body();
+  task.runToCompletion();
+  EXPECT_EQ(scheduled.load(), 1);
+}
+
+// Test case: Loggers without a writer thread flush in the background
+TEST(FlushAsyncBasicTest, DefaultFlushesInBackground) {
+  LoggerAdapter<FlushingSink> logger;
+  std::thread::id flushedOn;
+  bool flushedBeforeResume = false;
+  auto body = [&]() -> Task {
+    logger.log("buffered");
+    co_await logger.flushAsync();
+    flushedOn = logger.sink().flushedOn;
+    flushedBeforeResume = logger.sink().lines.size() == 1;
+  };
+  Task task = body();
+  task.runToCompletion();
+  EXPECT_NE(flushedOn, std::thread::id{});
+  EXPECT_NE(flushedOn, std::this_thread::get_id());
+  EXPECT_TRUE(flushedBeforeResume);
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,166 @@
+/// Unit tests for log levels and the `LOGGER_*` macros.
+///
+/// This test suite validates runtime level filtering on `ILogger` and the
+/// compile-time filtering performed by the macros.
+
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LogMacros.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// Test double that records every message it is asked to write.
+class RecordingLogger final : public ILogger {
+public:
+  /// Messages written so far, with their levels.
+  [[nodiscard]] auto messages() const
+      -> const std::vector<std::pair<Level, std::string>> & {
+    return messages_;
+  }
+
+private:
+  void write(Level level, std::string_view message) override {
+    messages_.emplace_back(level, message);
+  }
+
+  std::vector<std::pair<Level, std::string>> messages_;
+};
+
+/// Test suite for log level filtering.
+class LogLevelTest : public ::testing::Test {
+protected:
+  /// Get the logger under test.
+  [[nodiscard]] auto logger() -> RecordingLogger & { return logger_; }
+
+private:
+  RecordingLogger logger_;
+};
+
+/// Return `text` and count the call, to observe argument evaluation.
+auto countedMessage(int &calls, std::string_view text) -> std::string_view {
+  ++calls;
+  return text;
+}
+
+} // namespace
+
+// Test case: The default runtime threshold admits everything compiled in
+TEST_F(LogLevelTest, DefaultLevelIsCompiledMinimum) {
+  EXPECT_EQ(logger().level(), CompiledMinLevel);
+}
+
+// Test case: Messages below the runtime threshold are discarded
+TEST_F(LogLevelTest, RuntimeThresholdFiltersMessages) {
+  logger().setLevel(Level::Warning);
+  logger().log(Level::Info, "info");
+  logger().log(Level::Warning, "warning");
+  logger().log(Level::Critical, "critical");
+  logger().log("default is info");
+
+  const std::vector<std::pair<Level, std::string>> expected{
+      {Level::Warning, "warning"}, {Level::Critical, "critical"}};
+  EXPECT_EQ(logger().messages(), expected);
+}
+
+// Test case: The Off threshold disables every level
+TEST_F(LogLevelTest, OffThresholdDisablesAllLevels) {
+  logger().setLevel(Level::Off);
+  logger().log(Level::Critical, "critical");
+  logger().logf<"{}">(Level::Critical, 1);
+  EXPECT_TRUE(logger().messages().empty());
+}
+
+// Test case: Deferred messages honour the threshold and keep their level
+TEST_F(LogLevelTest, DeferredMessagesCarryLevel) {
+  logger().setLevel(Level::Info);
+  logger().logf<"debug {}">(Level::Debug, 1);
+  logger().logf<"error {}">(Level::Error, 2);
+  logger().logf<"info {}">(3);
+
+  const std::vector<std::pair<Level, std::string>> expected{
+      {Level::Error, "error 2"}, {Level::Info, "info 3"}};
+  EXPECT_EQ(logger().messages(), expected);
+}
+
+// Test case: Macros skip argument evaluation below the runtime threshold
+TEST_F(LogLevelTest, MacroDoesNotEvaluateFilteredArguments) {
+  logger().setLevel(Level::Error);
+  int calls = 0;
+  LOGGER_WARNING(logger(), countedMessage(calls, "skipped"));
+  LOGGER_WARNINGF(logger(), "{}", countedMessage(calls, "skipped"));
+  EXPECT_EQ(calls, 0) << "Filtered arguments must not be evaluated";
+  EXPECT_TRUE(logger().messages().empty());
+
+  LOGGER_ERROR(logger(), countedMessage(calls, "kept"));
+  LOGGER_CRITICALF(logger(), "{} {}", countedMessage(calls, "kept"), 2);
+  EXPECT_EQ(calls, 2);
+
+  const std::vector<std::pair<Level, std::string>> expected{
+      {Level::Error, "kept"}, {Level::Critical, "kept 2"}};
+  EXPECT_EQ(logger().messages(), expected);
+}
+
+// Test case: Macros below LOGGER_MIN_LEVEL compile to nothing
+TEST_F(LogLevelTest, MacroBelowCompiledMinimumIsDiscarded) {
+  logger().setLevel(Level::Trace);
+  int calls = 0;
+  LOGGER_TRACE(logger(), countedMessage(calls, "trace"));
+  LOGGER_TRACEF(logger(), "trace");
+
+  if constexpr (isCompiledIn(Level::Trace)) {
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(logger().messages().size(), 2U);
+  } else {
+    EXPECT_EQ(calls, 0) << "Compiled-out arguments must not be evaluated";
+    EXPECT_TRUE(logger().messages().empty());
+  }
+}
+
+// Value-parameterised test: Every level has a distinct printable name
+class LogLevelNameTest
+    : public ::testing::TestWithParam<std::pair<Level, std::string_view>> {};
+
+TEST_P(LogLevelNameTest, ToStringMatchesName) {
+  const auto &[level, name] = GetParam();
+  EXPECT_EQ(toString(level), name);
+}
+
+TEST_P(LogLevelNameTest, ParseLevelReadsName) {
+  const auto &[level, name] = GetParam();
+  EXPECT_EQ(parseLevel(name), level);
+  std::string lower{name};
+  std::ranges::transform(lower, lower.begin(), [](char letter) {
+    return static_cast<char>(letter - 'A' + 'a');
+  });
+  EXPECT_EQ(parseLevel(lower), level) << "Case is ignored";
+}
+
+// Test case: Only level names parse
+TEST(LogLevelParseTest, RejectsOtherNames) {
+  EXPECT_FALSE(parseLevel(""));
+  EXPECT_FALSE(parseLevel("WARN"));
+  EXPECT_FALSE(parseLevel("INFO "));
+  EXPECT_FALSE(parseLevel("UNKNOWN"));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Levels, LogLevelNameTest,
+    ::testing::Values(std::pair{Level::Trace, std::string_view{"TRACE"}},
+                      std::pair{Level::Debug, std::string_view{"DEBUG"}},
+                      std::pair{Level::Info, std::string_view{"INFO"}},
+                      std::pair{Level::Warning, std::string_view{"WARNING"}},
+                      std::pair{Level::Error, std::string_view{"ERROR"}},
+                      std::pair{Level::Critical, std::string_view{"CRITICAL"}},
+                      std::pair{Level::Off, std::string_view{"OFF"}}));
+
+} // namespace sample::logger::test
@@ -0,0 +1,221 @@
+/// Unit tests for log taps.
+///
+/// This test suite validates `AsyncLoggerConfig::tap` in each queue mode and
+/// output format, and the shared-memory `TapRing` and `TapReader`:
+/// ordering, wrap-around, drops and configuration checks.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/BinaryLogDecoder.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LogTap.hpp>
+#include <logger/LoggerFactory.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+auto asText(std::span<const std::byte> bytes) -> std::string_view {
+  return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+/// A tap that keeps a copy of every record it is handed.
+struct CollectingTap {
+  std::mutex mutex;
+  std::string text;
+  std::vector<Level> levels;
+
+  auto tap() -> LogTap {
+    return [this](std::span<const TapRecord> records) {
+      const std::lock_guard lock{mutex};
+      for (const TapRecord &record : records) {
+        text += asText(record.bytes);
+        levels.push_back(record.level);
+      }
+    };
+  }
+};
+
+} // namespace
+
+/// Test suite for taps on the asynchronous logger in each queue mode.
+class LogTapTest : public ::testing::TestWithParam<QueueMode> {};
+
+INSTANTIATE_TEST_SUITE_P(QueueModes, LogTapTest,
+                         ::testing::Values(QueueMode::Shared,
+                                           QueueMode::PerThread));
+
+// Test case: The tap sees every record, as written, with its level
+TEST_P(LogTapTest, TapSeesEveryRecordWritten) {
+  constexpr int MessageCount = 500;
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  CollectingTap collected;
+  {
+    auto logger = createAsyncLogger({.capacity = 16,
+                                     .target = LogTarget::File,
+                                     .filePath = path,
+                                     .maxBatchBytes = 128,
+                                     .queueMode = GetParam(),
+                                     .tap = collected.tap()});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->logf<"message {}">(i == 0 ? Level::Error : Level::Info, i);
+    }
+  }
+  EXPECT_EQ(collected.text, testsupport::readFile(path));
+  ASSERT_EQ(collected.levels.size(), std::size_t{MessageCount});
+  EXPECT_EQ(collected.levels.front(), Level::Error);
+  EXPECT_EQ(collected.levels.back(), Level::Info);
+}
+
+// Test case: The records of a binary logger decode as they arrive
+TEST_P(LogTapTest, BinaryRecordsDecodeFromTap) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  CollectingTap collected;
+  {
+    auto logger = createAsyncLogger({.target = LogTarget::File,
+                                     .filePath = path,
+                                     .outputFormat = OutputFormat::Binary,
+                                     .queueMode = GetParam(),
+                                     .tap = collected.tap()});
+    logger->log("started");
+    logger->logf<"request {} took {}us">(7, 840);
+  }
+  ASSERT_FALSE(collected.levels.empty());
+  EXPECT_EQ(collected.levels.front(), Level::Off) << "The session header";
+  EXPECT_EQ(collected.text, testsupport::readFile(path));
+  BinaryLogDecoder decoder;
+  fmt::memory_buffer out;
+  const auto bytes = std::as_bytes(std::span{collected.text});
+  EXPECT_EQ(decoder.decode(bytes, out), bytes.size());
+  EXPECT_EQ(fmt::to_string(out), "started\nrequest 7 took 840us\n");
+}
+
+// Test case: A tap that throws does not stop the output
+TEST(LogTapBasicTest, ThrowingTapIsIgnored) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  {
+    auto logger = createAsyncLogger(
+        {.target = LogTarget::File,
+         .filePath = path,
+         .tap = [](std::span<const TapRecord>) {
+           throw std::runtime_error{"tap failed"};
+         }});
+    logger->log("first");
+    logger->flush();
+    logger->log("second");
+  }
+  EXPECT_EQ(testsupport::readFile(path), "first\nsecond\n");
+}
+
+// Test case: Records logged into a ring are read back, in order, through a
+// mapping of its memfd of the reader's own
+TEST(TapRingTest, ReaderSeesLoggedRecords) {
+  TapRing ring{4096};
+  {
+    auto logger = createAsyncLogger({.target = LogTarget::File,
+                                     .filePath = "/dev/null",
+                                     .tap = ring.tap()});
+    logger->log(Level::Warning, "low disk");
+    logger->logf<"freed {} bytes">(4096);
+  }
+  TapReader reader{ring.fd()};
+  std::optional<TapRecord> record = reader.next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(record->level, Level::Warning);
+  EXPECT_EQ(asText(record->bytes), "low disk\n");
+  record = reader.next();
+  ASSERT_TRUE(record);
+  EXPECT_EQ(asText(record->bytes), "freed 4096 bytes\n");
+  EXPECT_FALSE(reader.next());
+  EXPECT_EQ(reader.dropped(), 0U);
+}
+
+// Test case: A reader keeping pace sees every record across many wraps
+TEST(TapRingTest, RecordsSurviveWrapAround) {
+  constexpr int RecordCount = 20000;
+  TapRing ring{4096};
+  TapReader reader{ring.fd()};
+  std::thread writer{[&ring] {
+    for (int i = 0; i < RecordCount; ++i) {
+      const std::string text = "record " + std::to_string(i);
+      const TapRecord record{.bytes = std::as_bytes(std::span{text})};
+      ring.publish({&record, 1});
+    }
+  }};
+  int expected = 0;
+  int received = 0;
+  while (expected < RecordCount) {
+    if (const std::optional<TapRecord> record = reader.next()) {
+      const std::string_view text = asText(record->bytes);
+      const int value = std::stoi(std::string{text.substr(7)});
+      EXPECT_GE(value, expected) << "Records arrive in order";
+      expected = value + 1;
+      ++received;
+    } else if (received + static_cast<int>(reader.dropped()) ==
+               RecordCount) {
+      break;
+    }
+  }
+  writer.join();
+  while (reader.next()) {
+    ++received;
+  }
+  EXPECT_EQ(received + static_cast<int>(reader.dropped()), RecordCount);
+}
+
+// Test case: The writer drops records rather than waiting for the reader
+TEST(TapRingTest, FullRingDropsRecords) {
+  TapRing ring{4096};
+  const std::string text(1000, 'x');
+  const TapRecord record{.level = Level::Debug,
+                         .bytes = std::as_bytes(std::span{text})};
+  const std::vector<TapRecord> records(10, record);
+  ring.publish(records);
+  EXPECT_EQ(ring.dropped(), 6U) << "Four 1008-byte entries fit in 4 KiB";
+
+  TapReader reader{ring.fd()};
+  int count = 0;
+  while (const std::optional<TapRecord> read = reader.next()) {
+    EXPECT_EQ(read->level, Level::Debug);
+    EXPECT_EQ(asText(read->bytes), text);
+    ++count;
+  }
+  EXPECT_EQ(count, 4);
+  ring.publish(records);
+  EXPECT_EQ(reader.dropped(), 12U) << "Room again once the reader is done";
+}
+
+// Test case: Invalid capacities and descriptors are rejected
+TEST(TapRingTest, RejectsInvalidRings) {
+  EXPECT_THROW(TapRing{1000}, std::invalid_argument);
+  EXPECT_THROW(TapRing{2048}, std::invalid_argument);
+  const int fd = ::memfd_create("not-a-tap", MFD_CLOEXEC);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(::ftruncate(fd, 16384), 0);
+  EXPECT_THROW(TapReader{fd}, std::invalid_argument);
+  ::close(fd);
+}
+
+} // namespace sample::logger::test
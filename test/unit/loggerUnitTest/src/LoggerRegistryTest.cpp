@@ -0,0 +1,226 @@
+/// Unit tests for the logger registry.
+///
+/// This test suite validates `LoggerRegistry`: named loggers with their own
+/// levels over one output, levels inherited along dotted names, level
+/// specifications, and concurrent lookups and level changes.
+
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LoggerRegistry.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// Test double that records every message it is asked to write, and counts
+/// flushes.
+class RecordingLogger final : public ILogger {
+public:
+  /// Messages written so far, with their levels.
+  [[nodiscard]] auto messages() const
+      -> std::vector<std::pair<Level, std::string>> {
+    const std::lock_guard lock{mutex_};
+    return messages_;
+  }
+
+  /// Number of `flush()` calls so far.
+  [[nodiscard]] auto flushes() const -> std::size_t {
+    const std::lock_guard lock{mutex_};
+    return flushes_;
+  }
+
+  void flush() override {
+    const std::lock_guard lock{mutex_};
+    ++flushes_;
+  }
+
+private:
+  void write(Level level, std::string_view message) override {
+    const std::lock_guard lock{mutex_};
+    messages_.emplace_back(level, message);
+  }
+
+  mutable std::mutex mutex_;
+  std::vector<std::pair<Level, std::string>> messages_;
+  std::size_t flushes_ = 0;
+};
+
+/// Test suite for a registry over a recording output.
+class LoggerRegistryTest : public ::testing::Test {
+protected:
+  /// Get the output every named logger writes to.
+  [[nodiscard]] auto output() const -> RecordingLogger & { return *output_; }
+
+  /// Get the registry under test.
+  [[nodiscard]] auto registry() -> LoggerRegistry & { return registry_; }
+
+private:
+  std::shared_ptr<RecordingLogger> output_ =
+      std::make_shared<RecordingLogger>();
+  LoggerRegistry registry_{output_};
+};
+
+} // namespace
+
+// Test case: Named loggers write to the shared output, each filtered by its
+// own level
+TEST_F(LoggerRegistryTest, NamedLoggersFilterByOwnLevel) {
+  registry().setLevel("", Level::Info);
+  ILogger &net = registry().get("net");
+  ILogger &db = registry().get("db");
+  registry().setLevel("db", Level::Debug);
+
+  net.log(Level::Debug, "net debug");
+  db.log(Level::Debug, "db debug");
+  net.logf<"net {}">(Level::Warning, 42);
+
+  std::vector<std::pair<Level, std::string>> expected{
+      {Level::Warning, "net 42"}};
+  if constexpr (isCompiledIn(Level::Debug)) {
+    expected.emplace(expected.begin(), Level::Debug, "db debug");
+  }
+  EXPECT_EQ(output().messages(), expected);
+}
+
+// Test case: The output's threshold sets the root level, but does not stop
+// a named logger below it
+TEST_F(LoggerRegistryTest, OutputThresholdIsTheRootLevel) {
+  auto output = std::make_shared<RecordingLogger>();
+  output->setLevel(Level::Error);
+  LoggerRegistry registry{output};
+  EXPECT_EQ(registry.level(""), Level::Error);
+  EXPECT_EQ(registry.level("any"), Level::Error);
+
+  registry.setLevel("verbose", Level::Trace);
+  registry.get("verbose").log(Level::Trace, "detail");
+  registry.get("quiet").log(Level::Warning, "dropped");
+  if constexpr (isCompiledIn(Level::Trace)) {
+    EXPECT_EQ(output->messages(),
+              (std::vector<std::pair<Level, std::string>>{
+                  {Level::Trace, "detail"}}));
+  } else {
+    EXPECT_TRUE(output->messages().empty());
+  }
+}
+
+// Test case: Messages logged through named loggers at or above the output's
+// flush level flush the output
+TEST_F(LoggerRegistryTest, NamedLoggersHonourTheOutputsFlushLevel) {
+  output().setFlushLevel(Level::Error);
+  ILogger &db = registry().get("db");
+
+  db.log(Level::Warning, "slow");
+  EXPECT_EQ(output().flushes(), 0U);
+  db.log(Level::Error, "down");
+  db.logf<"code {}">(Level::Error, 7);
+  EXPECT_EQ(output().flushes(), 2U);
+}
+
+// Test case: Levels apply to the loggers below a name, now and later, unless
+// they have their own
+TEST_F(LoggerRegistryTest, LevelsFollowDottedNames) {
+  ILogger &http = registry().get("net.http");
+  ILogger &network = registry().get("network");
+  registry().setLevel("", Level::Warning);
+  registry().setLevel("net", Level::Debug);
+  EXPECT_EQ(http.level(), Level::Debug);
+  EXPECT_EQ(network.level(), Level::Warning) << "Not below \"net\"";
+  EXPECT_EQ(registry().get("net.dns.cache").level(), Level::Debug);
+
+  registry().setLevel("net.http", Level::Error);
+  registry().setLevel("net", Level::Info);
+  EXPECT_EQ(http.level(), Level::Error) << "Its own level wins";
+  EXPECT_EQ(registry().get("net.dns.cache").level(), Level::Info);
+
+  registry().clearLevel("net.http");
+  EXPECT_EQ(http.level(), Level::Info);
+  registry().clearLevel("net");
+  EXPECT_EQ(http.level(), Level::Warning);
+}
+
+// Test case: get() returns the same logger for a name
+TEST_F(LoggerRegistryTest, GetReturnsOneLoggerPerName) {
+  ILogger &first = registry().get("app");
+  EXPECT_EQ(&registry().get("app"), &first);
+  EXPECT_NE(&registry().get("app.db"), &first);
+  std::vector<std::string> names = registry().names();
+  std::ranges::sort(names);
+  EXPECT_EQ(names, (std::vector<std::string>{"app", "app.db"}));
+}
+
+// Test case: setLevels() applies a comma-separated specification
+TEST_F(LoggerRegistryTest, SetLevelsAppliesSpecification) {
+  registry().setLevels(" warning , net=debug,net.http = TRACE,");
+  EXPECT_EQ(registry().level(""), Level::Warning);
+  EXPECT_EQ(registry().level("db"), Level::Warning);
+  EXPECT_EQ(registry().level("net.dns"), Level::Debug);
+  EXPECT_EQ(registry().level("net.http"), Level::Trace);
+}
+
+// Test case: A malformed specification is rejected as a whole
+TEST_F(LoggerRegistryTest, SetLevelsRejectsMalformedSettings) {
+  registry().setLevel("", Level::Info);
+  EXPECT_THROW(registry().setLevels("net=debug,db=loud"),
+               std::invalid_argument);
+  EXPECT_THROW(registry().setLevels("=debug"), std::invalid_argument);
+  EXPECT_THROW(registry().setLevels("net"), std::invalid_argument);
+  EXPECT_EQ(registry().level("net"), Level::Info) << "Nothing applied";
+}
+
+// Test case: A null output is rejected
+TEST(LoggerRegistryBasicTest, RejectsNullOutput) {
+  EXPECT_THROW(LoggerRegistry{nullptr}, std::invalid_argument);
+}
+
+// Test case: Loggers may be looked up, logged to and reconfigured from
+// several threads at once
+TEST_F(LoggerRegistryTest, ConcurrentLookupsAndLevelChanges) {
+  constexpr int ThreadCount = 4;
+  constexpr int MessagesPerThread = 500;
+  registry().setLevel("", Level::Info);
+  std::atomic<bool> done{false};
+  std::thread operatorThread{[this, &done] {
+    while (!done.load(std::memory_order_relaxed)) {
+      registry().setLevel("svc", Level::Debug);
+      registry().setLevels("svc=info");
+    }
+  }};
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < ThreadCount; ++thread) {
+    threads.emplace_back([this, thread] {
+      ILogger &logger = registry().get("svc.worker" + std::to_string(thread));
+      for (int i = 0; i < MessagesPerThread; ++i) {
+        EXPECT_EQ(&registry().get("svc.worker" + std::to_string(thread)),
+                  &logger);
+        logger.log("work");
+        logger.log(Level::Debug, "detail");
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  done.store(true, std::memory_order_relaxed);
+  operatorThread.join();
+  const auto messages = output().messages();
+  EXPECT_EQ(std::ranges::count(messages, Level::Info,
+                               &std::pair<Level, std::string>::first),
+            ThreadCount * MessagesPerThread);
+  EXPECT_EQ(registry().names().size(), std::size_t{ThreadCount});
+}
+
+} // namespace sample::logger::test
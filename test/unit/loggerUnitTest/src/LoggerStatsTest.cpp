@@ -0,0 +1,210 @@
+/// Unit tests for logger self-instrumentation.
+///
+/// This test suite validates `LatencyHistogram`, the `stats()` of every
+/// factory logger, and `StatsReporter`.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+#include <logger/MappedFileLoggerConfig.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// Poll `logger` until it reports `records` written records, or give up
+/// after a few seconds; returns the last snapshot.
+auto waitForRecords(const ILogger &logger, std::uint64_t records)
+    -> LoggerStats {
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  LoggerStats stats = logger.stats();
+  while (stats.records < records &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+    stats = logger.stats();
+  }
+  return stats;
+}
+
+} // namespace
+
+// Test case: Every value falls within its bucket, whose width is bounded
+TEST(LatencyHistogramTest, BucketsBoundEveryValue) {
+  std::vector<std::uint64_t> values;
+  for (std::uint64_t value = 0; value < 5000; ++value) {
+    values.push_back(value);
+  }
+  for (int bit = 4; bit < 64; ++bit) {
+    const std::uint64_t power = std::uint64_t{1} << bit;
+    values.insert(values.end(), {power - 1, power, power + 1});
+  }
+  values.push_back(std::numeric_limits<std::uint64_t>::max());
+
+  for (const std::uint64_t value : values) {
+    const std::size_t bucket = LatencyHistogram::bucketOf(value);
+    ASSERT_LT(bucket, LatencyHistogram::BucketCount) << value;
+    EXPECT_LE(LatencyHistogram::lowerBound(bucket), value);
+    EXPECT_GE(LatencyHistogram::upperBound(bucket), value);
+    const std::uint64_t width = LatencyHistogram::upperBound(bucket) -
+                                LatencyHistogram::lowerBound(bucket);
+    EXPECT_LE(width, LatencyHistogram::lowerBound(bucket) /
+                         LatencyHistogram::SubBuckets)
+        << value;
+  }
+  for (std::size_t bucket = 0; bucket + 1 < LatencyHistogram::BucketCount;
+       ++bucket) {
+    EXPECT_EQ(LatencyHistogram::upperBound(bucket) + 1,
+              LatencyHistogram::lowerBound(bucket + 1));
+  }
+}
+
+// Test case: Percentiles are reported to within a bucket
+TEST(LatencyHistogramTest, PercentilesAreWithinOneBucket) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.percentile(0.5), 0ns) << "Empty histogram";
+  for (int nanos = 1; nanos <= 1000; ++nanos) {
+    histogram.record(std::chrono::nanoseconds{nanos});
+  }
+  EXPECT_EQ(histogram.count(), 1000U);
+  const auto median = histogram.percentile(0.5);
+  EXPECT_GE(median, 500ns);
+  EXPECT_LE(median, 500ns + 500ns / LatencyHistogram::SubBuckets);
+  EXPECT_GE(histogram.percentile(1.0), 1000ns);
+  EXPECT_LE(histogram.percentile(0.0), 1ns);
+
+  LatencyHistogram other;
+  other.record(5s, 3);
+  histogram.merge(other);
+  EXPECT_EQ(histogram.count(), 1003U);
+  EXPECT_GE(histogram.percentile(1.0), 5s);
+}
+
+/// Test suite for the statistics of the asynchronous logger in each queue
+/// mode.
+class AsyncLoggerStatsTest : public ::testing::TestWithParam<QueueMode> {};
+
+INSTANTIATE_TEST_SUITE_P(QueueModes, AsyncLoggerStatsTest,
+                         ::testing::Values(QueueMode::Shared,
+                                           QueueMode::PerThread));
+
+// Test case: Records, bytes, flushes and latencies are all accounted for
+TEST_P(AsyncLoggerStatsTest, CountsEveryRecord) {
+  constexpr std::uint64_t MessageCount = 1000;
+  constexpr std::size_t Capacity = 64;
+  const QueueMode mode = GetParam();
+  auto logger = createAsyncLogger(
+      {.capacity = Capacity,
+       .target = LogTarget::File,
+       .filePath = "/dev/null",
+       .maxBatchBytes = 256,
+       .latencyHistogram = true,
+       .queueMode = mode,
+       .backendThreads = mode == QueueMode::PerThread ? 2U : 1U});
+  for (std::uint64_t i = 0; i < MessageCount; ++i) {
+    logger->log("message");
+  }
+
+  const LoggerStats stats = waitForRecords(*logger, MessageCount);
+  EXPECT_EQ(stats.records, MessageCount);
+  EXPECT_EQ(stats.bytes, MessageCount * std::string{"message\n"}.size());
+  EXPECT_EQ(stats.dropped, 0U);
+  EXPECT_LE(stats.queueHighWater, Capacity);
+  EXPECT_GE(stats.flushes, MessageCount * 8 / 256);
+  EXPECT_LE(stats.flushes, MessageCount);
+  EXPECT_EQ(stats.latency.count(), MessageCount);
+  EXPECT_GT(stats.latency.percentile(1.0), 0ns);
+}
+
+// Test case: Latencies are only measured when asked for
+TEST(LoggerStatsTest, LatencyHistogramIsOptIn) {
+  auto logger = createAsyncLogger(
+      {.target = LogTarget::File, .filePath = "/dev/null"});
+  logger->log("message");
+  const LoggerStats stats = waitForRecords(*logger, 1);
+  EXPECT_EQ(stats.records, 1U);
+  EXPECT_EQ(stats.latency.count(), 0U);
+}
+
+// Test case: The mapped-file logger counts records and completed segments
+TEST(LoggerStatsTest, MappedFileLoggerCountsSegments) {
+  const testsupport::TempLogDirectory directory;
+  {
+    auto logger = createMappedFileLogger(
+        {.directory = directory.path(), .segmentSize = 4096});
+    const std::string message(99, 'x');
+    for (int i = 0; i < 100; ++i) {
+      logger->log(message);
+    }
+    const LoggerStats stats = logger->stats();
+    EXPECT_EQ(stats.records, 100U);
+    EXPECT_EQ(stats.bytes, 100U * 100U);
+    EXPECT_EQ(stats.flushes, 100U * 100U / 4096U);
+    EXPECT_EQ(stats.queueHighWater, 0U);
+  }
+}
+
+// Test case: The console logger counts what it writes
+TEST(LoggerStatsTest, ConsoleLoggerCountsRecords) {
+  auto logger = createDefaultLogger();
+  ::testing::internal::CaptureStdout();
+  logger->log("one");
+  logger->logf<"{} and {}">(2, 3);
+  static_cast<void>(::testing::internal::GetCapturedStdout());
+  const LoggerStats stats = logger->stats();
+  EXPECT_EQ(stats.records, 2U);
+  EXPECT_EQ(stats.bytes, std::string{"one\n2 and 3\n"}.size());
+}
+
+// Test case: The reporter delivers snapshots until destroyed
+TEST(StatsReporterTest, ReportsPeriodically) {
+  auto logger = createAsyncLogger(
+      {.target = LogTarget::File, .filePath = "/dev/null"});
+  logger->log("message");
+  std::atomic<int> reports{0};
+  std::atomic<std::uint64_t> lastRecords{0};
+  {
+    const StatsReporter reporter{*logger, 1ms,
+                                 [&](const LoggerStats &stats) {
+                                   lastRecords = stats.records;
+                                   ++reports;
+                                 }};
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while ((reports < 3 || lastRecords == 0) &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+  const int seen = reports;
+  EXPECT_GE(seen, 3);
+  EXPECT_EQ(lastRecords, 1U);
+  std::this_thread::sleep_for(5ms);
+  EXPECT_EQ(reports, seen) << "No report after destruction";
+}
+
+// Test case: The reporter rejects a useless configuration
+TEST(StatsReporterTest, RejectsInvalidArguments) {
+  auto logger = createDefaultLogger();
+  const auto ignore = [](const LoggerStats &) {};
+  EXPECT_THROW(StatsReporter(*logger, 0ms, ignore), std::invalid_argument);
+  EXPECT_THROW(StatsReporter(*logger, 1ms, nullptr), std::invalid_argument);
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,187 @@
+/// Unit tests for the memory-mapped rotating file logger.
+///
+/// This test suite validates `createMappedFileLogger()`, segment rotation and
+/// the contents of the files it leaves behind.
+
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/MappedFileLoggerConfig.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// Test suite for the memory-mapped file logger.
+///
+/// Each test gets an empty directory of its own for its segments, removed
+/// when it ends.
+class MappedFileLoggerTest : public ::testing::Test {
+protected:
+  /// Configuration writing into this test's directory.
+  [[nodiscard]] auto config(std::size_t segmentSize = 1024 * 1024) const
+      -> MappedFileLoggerConfig {
+    return {.directory = directory_.path(),
+            .baseName = "test",
+            .segmentSize = segmentSize};
+  }
+
+  /// Segment files in index order.
+  [[nodiscard]] auto segments() const -> std::vector<std::filesystem::path> {
+    std::vector<std::filesystem::path> paths;
+    for (const auto &entry :
+         std::filesystem::directory_iterator{directory_.path()}) {
+      paths.push_back(entry.path());
+    }
+    std::ranges::sort(paths);
+    return paths;
+  }
+
+  /// Lines of every segment, concatenated in index order.
+  [[nodiscard]] auto lines() const -> std::vector<std::string> {
+    std::vector<std::string> result;
+    for (const auto &path : segments()) {
+      std::ifstream file{path};
+      for (std::string line; std::getline(file, line);) {
+        result.push_back(line);
+      }
+    }
+    return result;
+  }
+
+private:
+  const testsupport::TempLogDirectory directory_;
+};
+
+} // namespace
+
+// Test case: Factory creates a non-null logger instance
+TEST_F(MappedFileLoggerTest, CreateMappedFileLoggerReturnsNonNull) {
+  auto logger = createMappedFileLogger(config());
+  ASSERT_NE(logger, nullptr) << "Factory should return a valid logger instance";
+}
+
+// Test case: Factory rejects a segment smaller than a page
+TEST_F(MappedFileLoggerTest, CreateMappedFileLoggerRejectsTinySegment) {
+  EXPECT_THROW(static_cast<void>(createMappedFileLogger(config(100))),
+               std::invalid_argument);
+}
+
+// Test case: Destruction leaves one segment trimmed to its contents
+TEST_F(MappedFileLoggerTest, DestructionTrimsActiveSegment) {
+  {
+    auto logger = createMappedFileLogger(config());
+    logger->log("first");
+    logger->log("");
+    logger->log("third");
+  }
+
+  const auto paths = segments();
+  ASSERT_EQ(paths.size(), 1U);
+  EXPECT_EQ(paths.front().filename(), "test.000000.log");
+  EXPECT_EQ(testsupport::readFile(paths.front()), "first\n\nthird\n");
+}
+
+// Test case: Full segments rotate without losing or reordering messages
+TEST_F(MappedFileLoggerTest, RotationPreservesEveryMessage) {
+  constexpr std::size_t SegmentSize = 4096;
+  constexpr int MessageCount = 2000;
+  {
+    auto logger = createMappedFileLogger(config(SegmentSize));
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->log("message " + std::to_string(i));
+    }
+    EXPECT_EQ(logger->droppedMessages(), 0U);
+  }
+
+  const auto paths = segments();
+  EXPECT_GT(paths.size(), 2U) << "Messages should span several segments";
+  for (const auto &path : paths) {
+    EXPECT_LE(std::filesystem::file_size(path), SegmentSize);
+  }
+  const auto written = lines();
+  ASSERT_EQ(written.size(), static_cast<std::size_t>(MessageCount));
+  for (int i = 0; i < MessageCount; ++i) {
+    EXPECT_EQ(written[static_cast<std::size_t>(i)],
+              "message " + std::to_string(i));
+  }
+}
+
+// Test case: Concurrent producers across rotations keep their own order
+TEST_F(MappedFileLoggerTest, ConcurrentProducersPreservePerThreadOrder) {
+  constexpr int ThreadCount = 4;
+  constexpr int MessagesPerThread = 2000;
+  {
+    auto logger = createMappedFileLogger(config(4096));
+    std::vector<std::thread> producers;
+    for (int t = 0; t < ThreadCount; ++t) {
+      producers.emplace_back([&logger, t] {
+        for (int i = 0; i < MessagesPerThread; ++i) {
+          logger->log(std::to_string(t) + ":" + std::to_string(i));
+        }
+      });
+    }
+    for (auto &producer : producers) {
+      producer.join();
+    }
+  }
+
+  std::vector<int> next(ThreadCount, 0);
+  for (const auto &line : lines()) {
+    const auto colon = line.find(':');
+    ASSERT_NE(colon, std::string::npos) << "Torn line: " << line;
+    const auto thread =
+        static_cast<std::size_t>(std::stoi(line.substr(0, colon)));
+    ASSERT_LT(thread, next.size());
+    EXPECT_EQ(std::stoi(line.substr(colon + 1)), next[thread]++)
+        << "Messages from one thread must stay in order";
+  }
+  for (const int count : next) {
+    EXPECT_EQ(count, MessagesPerThread) << "No message may be lost";
+  }
+}
+
+// Test case: A new logger continues after the existing segments
+TEST_F(MappedFileLoggerTest, NewLoggerDoesNotOverwriteSegments) {
+  {
+    auto logger = createMappedFileLogger(config());
+    logger->log("first run");
+  }
+  {
+    auto logger = createMappedFileLogger(config());
+    logger->log("second run");
+  }
+
+  const std::vector<std::string> expected{"first run", "second run"};
+  EXPECT_EQ(lines(), expected);
+  EXPECT_EQ(segments().size(), 2U);
+}
+
+// Test case: A message larger than a segment is truncated to fit
+TEST_F(MappedFileLoggerTest, OversizedMessageIsTruncated) {
+  constexpr std::size_t SegmentSize = 4096;
+  {
+    auto logger = createMappedFileLogger(config(SegmentSize));
+    logger->log(std::string(2 * SegmentSize, 'x'));
+    logger->log("after");
+  }
+
+  const std::vector<std::string> expected{std::string(SegmentSize - 1, 'x'),
+                                          "after"};
+  EXPECT_EQ(lines(), expected);
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,136 @@
+/// Unit tests for per-call-site rate limiting and repeat collapsing.
+///
+/// This test suite validates `RateLimitConfig` as applied by `BasicLogger`
+/// and by the loggers the factories return.
+
+#include <logger/BasicLogger.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LogLevel.hpp>
+#include <logger/LogMacros.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/RateLimit.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+using Messages = std::vector<std::pair<Level, std::string>>;
+
+/// Sink that records every message it is asked to write.
+struct RecordingSink {
+  void write(Level level, std::string_view message) {
+    messages.emplace_back(level, message);
+  }
+
+  Messages messages;
+};
+
+} // namespace
+
+// Test case: A call site logs its burst, then is throttled
+TEST(RateLimitTest, CallSiteIsThrottledAfterBurst) {
+  BasicLogger<RecordingSink> logger{
+      RateLimitConfig{.messagesPerSecond = 1, .burst = 3}};
+  for (int i = 0; i < 10; ++i) {
+    LOGGER_INFO(logger, "hot");
+  }
+
+  const Messages expected(3, {Level::Info, "hot"});
+  EXPECT_EQ(logger.sink().messages, expected);
+}
+
+// Test case: Each macro expansion has its own budget
+TEST(RateLimitTest, CallSitesAreIndependent) {
+  BasicLogger<RecordingSink> logger{
+      RateLimitConfig{.messagesPerSecond = 1, .burst = 1}};
+  for (int i = 0; i < 3; ++i) {
+    LOGGER_INFO(logger, "first");
+    LOGGER_WARNINGF(logger, "second {}", i);
+  }
+
+  const Messages expected{{Level::Info, "first"}, {Level::Warning, "second 0"}};
+  EXPECT_EQ(logger.sink().messages, expected);
+}
+
+// Test case: The next admitted message reports how many were suppressed
+TEST(RateLimitTest, ReportsSuppressedMessages) {
+  BasicLogger<RecordingSink> logger{
+      RateLimitConfig{.messagesPerSecond = 20, .burst = 1}};
+  const auto logHot = [&logger] { LOGGER_ERROR(logger, "hot"); };
+  for (int i = 0; i < 5; ++i) {
+    logHot();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds{100});
+  logHot();
+
+  const Messages expected{{Level::Error, "hot"},
+                          {Level::Error, "[logger: 4 messages suppressed]"},
+                          {Level::Error, "hot"}};
+  EXPECT_EQ(logger.sink().messages, expected);
+}
+
+// Test case: Consecutive identical messages collapse into a repeat count
+TEST(RateLimitTest, CollapsesRepeatedMessages) {
+  BasicLogger<RecordingSink> logger{RateLimitConfig{.collapseRepeats = true}};
+  for (const int value : {1, 1, 1, 2, 2, 3}) {
+    LOGGER_WARNINGF(logger, "disk {}", value);
+  }
+
+  const Messages expected{
+      {Level::Warning, "disk 1"},
+      {Level::Warning, "[logger: last message repeated 2 times]"},
+      {Level::Warning, "disk 2"},
+      {Level::Warning, "[logger: last message repeated 1 times]"},
+      {Level::Warning, "disk 3"}};
+  EXPECT_EQ(logger.sink().messages, expected);
+}
+
+// Test case: logf() without a macro is throttled per format and types
+TEST(RateLimitTest, LogfSharesSiteAcrossCalls) {
+  LoggerAdapter<RecordingSink> adapter{
+      RateLimitConfig{.messagesPerSecond = 1, .burst = 2}};
+  ILogger &logger = adapter;
+  for (int i = 0; i < 5; ++i) {
+    logger.logf<"RateLimitTest shared {}">(i);
+    logger.log("never throttled");
+  }
+
+  ASSERT_EQ(adapter.sink().messages.size(), 7U);
+  EXPECT_EQ(adapter.sink().messages[0].second, "RateLimitTest shared 0");
+  EXPECT_EQ(adapter.sink().messages[2].second, "RateLimitTest shared 1");
+}
+
+// Test case: Factory loggers apply their configured limit
+TEST(RateLimitTest, FactoryLoggersApplyLimit) {
+  ::testing::internal::CaptureStdout();
+  {
+    auto logger = createAsyncLogger(
+        {.rateLimit = {.messagesPerSecond = 1, .burst = 2}});
+    for (int i = 0; i < 5; ++i) {
+      LOGGER_INFOF(*logger, "async {}", i);
+    }
+  }
+  EXPECT_EQ(::testing::internal::GetCapturedStdout(), "async 0\nasync 1\n");
+}
+
+// Test case: A zero burst is rejected when rate limiting is on
+TEST(RateLimitTest, FactoriesRejectZeroBurst) {
+  const RateLimitConfig invalid{.messagesPerSecond = 1, .burst = 0};
+  EXPECT_THROW(static_cast<void>(createDefaultLogger(invalid)),
+               std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(createAsyncLogger({.rateLimit = invalid})),
+               std::invalid_argument);
+  EXPECT_NO_THROW(static_cast<void>(createDefaultLogger({.burst = 0})));
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,186 @@
+/// Unit tests for StagingBuffer.
+///
+/// This test suite validates the per-thread staging buffers and that a
+/// steady-state log call performs no heap allocation on the calling thread.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/Fields.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+#include <logger/StagingBuffer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+/// Whether allocations on this thread are currently being counted.
+thread_local bool countingAllocations = false;
+
+/// Allocations made on this thread while counting.
+thread_local std::size_t allocationCount = 0;
+
+} // namespace
+
+// Replacement global allocation functions, so tests can count allocations.
+// NOLINTBEGIN(cppcoreguidelines-no-malloc,misc-new-delete-overloads)
+auto operator new(std::size_t size) -> void * {
+  if (countingAllocations) {
+    ++allocationCount;
+  }
+  if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t /*size*/) noexcept {
+  std::free(memory);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc,misc-new-delete-overloads)
+
+namespace sample::logger::test {
+
+namespace {
+
+/// Count the heap allocations `body` makes on the calling thread.
+template <typename Body> auto countAllocations(Body &&body) -> std::size_t {
+  allocationCount = 0;
+  countingAllocations = true;
+  body();
+  countingAllocations = false;
+  return allocationCount;
+}
+
+/// Test suite for StagingBuffer.
+///
+/// Captures stdout so the async logger used by the allocation tests does not
+/// flood the test output.
+class StagingBufferTest : public ::testing::Test {
+protected:
+  /// Start capturing stdout.
+  void SetUp() override { ::testing::internal::CaptureStdout(); }
+
+  /// Discard the captured output.
+  void TearDown() override {
+    static_cast<void>(::testing::internal::GetCapturedStdout());
+  }
+};
+
+} // namespace
+
+// Test case: Formatting and appending build the expected text
+TEST_F(StagingBufferTest, FormatsAndAppends) {
+  StagingBuffer message;
+  message.format("request #{}", 7).append(" done");
+  EXPECT_EQ(message.view(), "request #7 done");
+
+  message.clear();
+  EXPECT_TRUE(message.view().empty());
+}
+
+// Test case: A new lease always starts empty
+TEST_F(StagingBufferTest, NewLeaseStartsEmpty) {
+  {
+    StagingBuffer first;
+    first.append("leftover");
+  }
+  StagingBuffer second;
+  EXPECT_TRUE(second.view().empty());
+}
+
+// Test case: Nested leases use independent buffers, even past the pool size
+TEST_F(StagingBufferTest, NestedLeasesAreIndependent) {
+  StagingBuffer a;
+  StagingBuffer b;
+  StagingBuffer c;
+  StagingBuffer d;
+  StagingBuffer e;
+  a.append("a");
+  b.append("b");
+  c.append("c");
+  d.append("d");
+  e.append("e");
+
+  EXPECT_EQ(a.view(), "a");
+  EXPECT_EQ(b.view(), "b");
+  EXPECT_EQ(c.view(), "c");
+  EXPECT_EQ(d.view(), "d");
+  EXPECT_EQ(e.view(), "e");
+}
+
+// Test case: Building a message in a warm staging buffer does not allocate
+TEST_F(StagingBufferTest, WarmBufferDoesNotAllocate) {
+  const std::string payload(2000, 'p');
+  const auto build = [&payload] {
+    StagingBuffer message;
+    message.format("Processing request #{} ", 12345).append(payload);
+  };
+  build();
+
+  EXPECT_EQ(countAllocations([&build] {
+              for (int i = 0; i < 100; ++i) {
+                build();
+              }
+            }),
+            0U);
+}
+
+// Test case: Steady-state async logging does not allocate on the caller
+TEST_F(StagingBufferTest, SteadyStateAsyncLoggingDoesNotAllocate) {
+  constexpr std::size_t Capacity = 16;
+  auto logger = createAsyncLogger({.capacity = Capacity});
+  const std::string large(1024, 'x');
+  const auto logBurst = [&logger, &large](int count) {
+    for (int i = 0; i < count; ++i) {
+      StagingBuffer message;
+      message.format("Processing request #{}", i);
+      logger->log(message.view());
+      logger->logf<"request {} payload {}">(i, large);
+      logger->log("request", field("id", i), field("payload", large));
+    }
+  };
+  // Warm up: every ring slot and staging buffer reaches its working size.
+  logBurst(static_cast<int>(4 * Capacity));
+
+  EXPECT_EQ(countAllocations([&logBurst] { logBurst(1000); }), 0U)
+      << "A warm logger must not allocate on the logging thread";
+}
+
+// Test case: Multi-kilobyte records go through the producer's arena without
+// allocating, however many ring slots they pass through
+TEST_F(StagingBufferTest, OversizeRecordsDoNotAllocate) {
+  constexpr int MessageCount = 500;
+  const std::string large(4096, 'x');
+  for (const QueueMode mode : {QueueMode::Shared, QueueMode::PerThread}) {
+    // Room for every record even if the backend never gets to run.
+    auto logger = createAsyncLogger(
+        {.queueMode = mode, .arenaBytes = 4 * MessageCount * large.size()});
+    // Warm up: registers the thread, allocates its arena and grows the
+    // staging buffer `logf()` encodes into.
+    logger->log(large);
+    logger->logf<"request {} payload {}">(-1, large);
+
+    EXPECT_EQ(countAllocations([&logger, &large] {
+                for (int i = 0; i < MessageCount; ++i) {
+                  logger->log(large);
+                  logger->logf<"request {} payload {}">(i, large);
+                }
+              }),
+              0U)
+        << "Records in the arena must not allocate on the logging thread";
+    logger->flush();
+    const LoggerStats stats = logger->stats();
+    EXPECT_EQ(stats.arenaRecords, 2U * MessageCount + 2);
+    EXPECT_EQ(stats.arenaFallbacks, 0U);
+  }
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,138 @@
+/// Unit tests for JSON and logfmt string escaping.
+///
+/// This test suite validates `detail::appendJsonString()` and
+/// `detail::appendLogfmtString()`, whose vector kernels classify 16 or 32
+/// bytes at a time, against a byte-at-a-time reference at every offset.
+
+#include <logger/Fields.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+/// `text` as a JSON string literal by `detail::appendJsonString()`.
+auto json(std::string_view text) -> std::string {
+  fmt::memory_buffer out;
+  detail::appendJsonString(text, out);
+  return fmt::to_string(out);
+}
+
+/// `text` as a logfmt value by `detail::appendLogfmtString()`.
+auto logfmt(std::string_view text) -> std::string {
+  fmt::memory_buffer out;
+  detail::appendLogfmtString(text, out);
+  return fmt::to_string(out);
+}
+
+/// `text` (ASCII only) as a JSON string literal, one byte at a time.
+auto referenceJson(std::string_view text) -> std::string {
+  std::string out = "\"";
+  for (const char character : text) {
+    switch (character) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(character) < 0x20) {
+        out += fmt::format("\\u{:04x}", static_cast<unsigned>(character));
+      } else {
+        out += character;
+      }
+    }
+  }
+  return out + '"';
+}
+
+/// Characters that end a plain run in one scan or the other.
+const std::vector<char> SpecialCharacters{'"', '\\', '\n', '\t', '\x01',
+                                          '\x1f', ' ', '='};
+
+} // namespace
+
+// Test case: Each special character is escaped at any offset of a line that
+// spans several vector blocks
+TEST(TextEscapeTest, EscapesAtEveryOffset) {
+  for (std::size_t length = 1; length <= 80; ++length) {
+    for (std::size_t offset = 0; offset < length; ++offset) {
+      for (const char special : SpecialCharacters) {
+        std::string text(length, 'a');
+        text[offset] = special;
+        EXPECT_EQ(json(text), referenceJson(text))
+            << "length " << length << " offset " << offset;
+      }
+    }
+  }
+}
+
+// Test case: Plain text is copied unchanged, whatever its length
+TEST(TextEscapeTest, CopiesPlainText) {
+  EXPECT_EQ(json(""), "\"\"");
+  for (std::size_t length = 1; length <= 4096; length *= 2) {
+    const std::string text(length + 3, '~');
+    EXPECT_EQ(json(text), '"' + text + '"');
+  }
+}
+
+// Test case: Well-formed UTF-8 is kept; anything else becomes U+FFFD
+TEST(TextEscapeTest, ValidatesUtf8) {
+  EXPECT_EQ(json("h\xC3\xA9llo"), "\"h\xC3\xA9llo\"");
+  EXPECT_EQ(json("\xE2\x82\xAC \xF0\x9F\x98\x80"),
+            "\"\xE2\x82\xAC \xF0\x9F\x98\x80\"");
+  EXPECT_EQ(json("\xC3"), "\"\\ufffd\"") << "Truncated sequence";
+  EXPECT_EQ(json("\xC0\xAF"), "\"\\ufffd\\ufffd\"") << "Overlong form";
+  EXPECT_EQ(json("\xED\xA0\x80"), "\"\\ufffd\\ufffd\\ufffd\"")
+      << "Surrogate";
+  EXPECT_EQ(json("\xF4\x90\x80\x80"), "\"\\ufffd\\ufffd\\ufffd\\ufffd\"")
+      << "Above U+10FFFF";
+  EXPECT_EQ(json("a\xFF" "b"), "\"a\\ufffdb\"");
+
+  std::string long_(100, 'x');
+  long_.replace(40, 2, "\xC3\xA9");
+  long_[70] = '\x80';
+  std::string expected = '"' + long_ + '"';
+  expected.replace(71, 1, "\\ufffd");
+  EXPECT_EQ(json(long_), expected);
+}
+
+// Test case: logfmt values are quoted only when they must be
+TEST(TextEscapeTest, QuotesLogfmtOnlyWhenNeeded) {
+  EXPECT_EQ(logfmt("plain"), "plain");
+  EXPECT_EQ(logfmt("h\xC3\xA9llo"), "h\xC3\xA9llo");
+  EXPECT_EQ(logfmt(""), "\"\"");
+  EXPECT_EQ(logfmt("two words"), "\"two words\"");
+  EXPECT_EQ(logfmt("a=b"), "\"a=b\"");
+  EXPECT_EQ(logfmt("bad\xFF"), "\"bad\\ufffd\"");
+  for (std::size_t length = 1; length <= 80; ++length) {
+    for (std::size_t offset = 0; offset < length; ++offset) {
+      for (const char special : SpecialCharacters) {
+        std::string text(length, 'a');
+        text[offset] = special;
+        EXPECT_EQ(logfmt(text), referenceJson(text))
+            << "length " << length << " offset " << offset;
+      }
+    }
+  }
+}
+
+} // namespace sample::logger::test
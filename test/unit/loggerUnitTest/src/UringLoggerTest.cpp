@@ -0,0 +1,132 @@
+/// Unit tests for the io_uring file logger.
+///
+/// This test suite validates `createUringFileLogger()`, with the ring and
+/// with its plain-write fallback: record order across batches in flight,
+/// appending, flushing, oversize batches and configuration checks.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/UringLoggerConfig.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace sample::logger::test {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+} // namespace
+
+/// Test suite run with the ring (true) and with plain writes (false).
+class UringLoggerTest : public ::testing::TestWithParam<bool> {};
+
+INSTANTIATE_TEST_SUITE_P(Backends, UringLoggerTest, ::testing::Bool());
+
+// Test case: Records are written in order while several batches are in
+// flight at once
+TEST_P(UringLoggerTest, WritesEveryRecordInOrder) {
+  constexpr int MessageCount = 2000;
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  std::string expected;
+  {
+    auto logger = createUringFileLogger({.queue = {.capacity = 16,
+                                                   .maxBatchBytes = 64},
+                                         .filePath = path,
+                                         .queueDepth = 3,
+                                         .syncInterval = 0ms,
+                                         .useUring = GetParam()});
+    for (int i = 0; i < MessageCount; ++i) {
+      logger->logf<"message {}">(i);
+      expected += "message " + std::to_string(i) + "\n";
+    }
+  }
+  EXPECT_EQ(testsupport::readFile(path), expected);
+}
+
+// Test case: An existing file is appended to
+TEST_P(UringLoggerTest, AppendsToExistingFile) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  std::ofstream{path} << "earlier\n";
+  {
+    auto logger =
+        createUringFileLogger({.filePath = path, .useUring = GetParam()});
+    logger->log("later");
+  }
+  EXPECT_EQ(testsupport::readFile(path), "earlier\nlater\n");
+}
+
+// Test case: flush() returns once the kernel has written the records
+TEST_P(UringLoggerTest, FlushWaitsForWrites) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto logger = createUringFileLogger(
+      {.queue = {.maxLatency = 1h}, .filePath = path, .useUring = GetParam()});
+  logger->log("first");
+  logger->flush();
+  EXPECT_EQ(testsupport::readFile(path), "first\n");
+  logger->logf<"second {}">(2);
+  logger->flush();
+  EXPECT_EQ(testsupport::readFile(path), "first\nsecond 2\n");
+}
+
+// Test case: A batch that outgrows its registered buffer is still written
+TEST_P(UringLoggerTest, WritesOversizeBatches) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  const std::string large(512 * 1024, 'x');
+  {
+    auto logger = createUringFileLogger(
+        {.filePath = path, .queueDepth = 1, .useUring = GetParam()});
+    logger->log("before");
+    logger->log(large);
+    logger->log("after");
+  }
+  EXPECT_EQ(testsupport::readFile(path), "before\n" + large + "\nafter\n");
+}
+
+// Test case: Invalid configurations are rejected
+TEST(UringLoggerConfigTest, CreateUringFileLoggerRejectsInvalidConfig) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  EXPECT_THROW(
+      static_cast<void>(createUringFileLogger({.filePath = path,
+                                               .queueDepth = 0})),
+      std::invalid_argument);
+  EXPECT_THROW(
+      static_cast<void>(createUringFileLogger({.filePath = path,
+                                               .queueDepth = 4097})),
+      std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(createUringFileLogger(
+                   {.filePath = path, .syncInterval = -1ms})),
+               std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(createUringFileLogger(
+                   {.queue = {.queueMode = QueueMode::PerThread},
+                    .filePath = path})),
+               std::invalid_argument);
+  EXPECT_THROW(
+      static_cast<void>(createUringFileLogger(
+          {.queue = {.capacity = 1}, .filePath = path})),
+      std::invalid_argument);
+}
+
+// Test case: A file that cannot be opened throws std::system_error
+TEST(UringLoggerConfigTest, UnopenableFileThrowsSystemError) {
+  EXPECT_THROW(static_cast<void>(createUringFileLogger(
+                   {.filePath = "/nonexistent-dir/uring.log"})),
+               std::system_error);
+}
+
+} // namespace sample::logger::test
@@ -0,0 +1,178 @@
+/// Unit tests for the asynchronous logger's wait strategies.
+///
+/// This test suite validates that every `WaitStrategy` delivers every record
+/// in each queue mode, with and without lingering, and that `stats()`
+/// reports the backend's CPU time and sleeps.
+
+#include <logger/AsyncLoggerConfig.hpp>
+#include <logger/ILogger.hpp>
+#include <logger/LoggerFactory.hpp>
+#include <logger/LoggerStats.hpp>
+
+#include <testSupport/TestFiles.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace sample::logger::test {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// A file logger in queue mode `mode` waiting as `strategy` says.
+auto strategyConfig(QueueMode mode, WaitStrategy strategy,
+                    const std::filesystem::path &path) -> AsyncLoggerConfig {
+  return {.capacity = 64,
+          .target = LogTarget::File,
+          .filePath = path,
+          .maxBatchBytes = 4096,
+          .queueMode = mode,
+          .backendThreads = mode == QueueMode::PerThread ? 2U : 1U,
+          .waitStrategy = strategy};
+}
+
+} // namespace
+
+/// Test suite for each wait strategy in each queue mode.
+class WaitStrategyTest
+    : public ::testing::TestWithParam<std::tuple<QueueMode, WaitStrategy>> {
+protected:
+  /// Get the queue mode under test.
+  [[nodiscard]] static auto mode() -> QueueMode {
+    return std::get<0>(GetParam());
+  }
+
+  /// Get the wait strategy under test.
+  [[nodiscard]] static auto strategy() -> WaitStrategy {
+    return std::get<1>(GetParam());
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    Strategies, WaitStrategyTest,
+    ::testing::Combine(::testing::Values(QueueMode::Shared,
+                                         QueueMode::PerThread),
+                       ::testing::Values(WaitStrategy::Park,
+                                         WaitStrategy::Spin,
+                                         WaitStrategy::SpinYield,
+                                         WaitStrategy::Adaptive)));
+
+// Test case: Bursts and a trickle of records from several threads are all
+// written, each thread's in order
+TEST_P(WaitStrategyTest, WritesEveryRecordInOrder) {
+  constexpr int ThreadCount = 3;
+  constexpr int MessagesPerThread = 400;
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  {
+    auto logger = createAsyncLogger(strategyConfig(mode(), strategy(), path));
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < ThreadCount; ++thread) {
+      threads.emplace_back([&logger, thread] {
+        for (int i = 0; i < MessagesPerThread; ++i) {
+          logger->logf<"t{} m{}">(thread, i);
+          if (i % 100 == 0) {
+            std::this_thread::sleep_for(1ms);
+          }
+        }
+        logger->flush();
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    const LoggerStats stats = logger->stats();
+    EXPECT_EQ(stats.records,
+              static_cast<std::uint64_t>(ThreadCount * MessagesPerThread));
+  }
+
+  std::vector<int> next(ThreadCount, 0);
+  std::ifstream lines{path};
+  std::string line;
+  while (std::getline(lines, line)) {
+    int thread = -1;
+    int message = -1;
+    ASSERT_EQ(std::sscanf(line.c_str(), "t%d m%d", &thread, &message), 2)
+        << line;
+    ASSERT_GE(thread, 0);
+    ASSERT_LT(thread, ThreadCount);
+    EXPECT_EQ(message, next[static_cast<std::size_t>(thread)]++) << line;
+  }
+  EXPECT_EQ(next, std::vector<int>(ThreadCount, MessagesPerThread));
+}
+
+// Test case: A partial batch held for maxLatency is written on time whether
+// the backend sleeps or polls through the wait
+TEST_P(WaitStrategyTest, LingeringBatchIsWrittenOnTime) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  AsyncLoggerConfig config = strategyConfig(mode(), strategy(), path);
+  config.maxLatency = 20ms;
+  auto logger = createAsyncLogger(config);
+  logger->log("held");
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (testsupport::readFile(path).empty() &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_EQ(testsupport::readFile(path), "held\n");
+}
+
+// Test case: Only the sleeping strategies sleep, and every backend reports
+// the CPU time it used
+TEST_P(WaitStrategyTest, ReportsSleepsAndCpuTime) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto logger = createAsyncLogger(strategyConfig(mode(), strategy(), path));
+  for (int i = 0; i < 10; ++i) {
+    logger->log("tick");
+    logger->flush();
+    std::this_thread::sleep_for(5ms);
+  }
+  const LoggerStats stats = logger->stats();
+  EXPECT_EQ(stats.records, 10U);
+  EXPECT_GT(stats.backendCpuTime, 0ns);
+  if (strategy() == WaitStrategy::Spin ||
+      strategy() == WaitStrategy::SpinYield) {
+    EXPECT_EQ(stats.backendSleeps, 0U);
+  } else {
+    EXPECT_GT(stats.backendSleeps, 0U) << "Idle for 50ms";
+  }
+}
+
+// Test case: A spinning backend keeps using CPU while idle
+TEST(WaitStrategyCpuTest, SpinningCostsCpuWhileIdle) {
+  const testsupport::TempLogFile file;
+  const auto &path = file.path();
+  auto spinning = createAsyncLogger(
+      strategyConfig(QueueMode::Shared, WaitStrategy::Spin, path));
+  spinning->log("start");
+  spinning->flush();
+  const auto before = spinning->stats().backendCpuTime;
+  std::this_thread::sleep_for(100ms);
+  EXPECT_GE(spinning->stats().backendCpuTime - before, 10ms)
+      << "Polled throughout";
+}
+
+// Test case: Loggers that are not asynchronous report no backend
+TEST(WaitStrategyCpuTest, SynchronousLoggersReportNoBackend) {
+  auto logger = createDefaultLogger();
+  const LoggerStats stats = logger->stats();
+  EXPECT_EQ(stats.backendCpuTime, 0ns);
+  EXPECT_EQ(stats.backendSleeps, 0U);
+}
+
+} // namespace sample::logger::test